@@ -15,7 +15,10 @@
 // atmospheric pressure.
 // The actual autopilot algorithms are implemented as scripts
 // (Script/DG/aap.lua). This class simply provides the user
-// interface to the script functions.
+// interface to the script functions. The scripts run in an
+// interpreter shared with other vessels (see AAPHost).
+// With AAP_NATIVE set in the class cfg, the compiled control
+// loops of AAPCore are used instead of the script.
 // ==============================================================
 
 #include "AAP.h"
@@ -30,12 +33,17 @@ static const WORD idx_bb[6] = {0,1,2,3,2,1};
 
 // ==============================================================
 
-AAP::AAP (Scout *vessel): DGPanelElement (vessel)
+AAP::AAP (Scout *vessel, bool native): DGPanelElement (vessel)
 {
 	int i;
-	hAAP = oapiCreateInterpreter();
+	if (native) {
+		core = new AAPCore (vessel);
+		host = NULL;
+	} else {
+		core = NULL;
+		host = AAPHost::Attach (vessel); // load the autopilot code
+	}
 	hsi = NULL;
-	oapiAsyncScriptCmd (hAAP, "run('dg/aap')"); // load the autopilot code
 	active_block = -1;
 	for (i = 0; i < 3; i++) {
 		tgt[i] = 0;
@@ -46,6 +54,14 @@ AAP::AAP (Scout *vessel): DGPanelElement (vessel)
 
 // ==============================================================
 
+AAP::~AAP ()
+{
+	if (host) host->Detach (dg);
+	if (core) delete core;
+}
+
+// ==============================================================
+
 void AAP::RegisterPanel (PANELHANDLE hPanel)
 {
 	int i;
@@ -183,6 +199,7 @@ bool AAP::ProcessMouse2D (int event, int mx, int my)
 					tp = t;
 					step = max(1,min(1e4,pow(10,floor(log10 (max(tgt[active_block],1)))-mag)));
 					tgt[active_block] = max(0,floor(tgt[active_block]/step)*step + scanmode*step);
+					dg->ScnDirty (Scout::SCNF_AAP);
 					if (active[active_block]) SetValue (active_block, tgt[active_block]);
 					return true;
 				}
@@ -193,6 +210,7 @@ bool AAP::ProcessMouse2D (int event, int mx, int my)
 				tgt[2] += step;
 				while (tgt[2] < 0.0) tgt[2] += PI2;
 				while (tgt[2] >= PI2) tgt[2] -= PI2;
+				dg->ScnDirty (Scout::SCNF_AAP);
 				if (active[2]) SetValue (2, tgt[2]);
 				if (hsi) hsi->SetCrs (tgt[2]);
 				return true;
@@ -205,21 +223,8 @@ bool AAP::ProcessMouse2D (int event, int mx, int my)
 
 void AAP::SetValue (int block, double val)
 {
-	char cbuf[256];
-	switch (block) {
-		case 0: // altitude
-			sprintf (cbuf, "aap.alt(%e)", val);
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
-		case 1: // airspeed
-			sprintf (cbuf, "aap.spd(%e)", val);
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
-		case 2: // heading/course
-			sprintf (cbuf, "aap.hdg(%e)", val*DEG);
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
-	}
+	if (core) core->Engage (block, val);
+	else      host->Set (dg, block, block == 2 ? val*DEG : val); // script expects heading in degrees
 }
 
 void AAP::ToggleActive (int block)
@@ -231,37 +236,39 @@ void AAP::SetActive (int block, bool activate)
 {
 	if (activate == active[block]) return; // nothing to do
 
-	char cbuf[256];
-
 	active[block] = activate;
-	switch (block) {
-		case 0: // altitude
-			if (activate) sprintf (cbuf, "aap.alt(%e)", tgt[block]);
-			else          strcpy (cbuf, "aap.alt()");
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
-		case 1: // airspeed
-			if (activate) sprintf (cbuf, "aap.spd(%e)", tgt[block]);
-			else          strcpy (cbuf, "aap.spd()");
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
-		case 2: // heading
-			if (activate) sprintf (cbuf, "aap.hdg(%e)", tgt[block]*DEG);
-			else          strcpy (cbuf, "aap.hdg()");
-			oapiAsyncScriptCmd (hAAP, cbuf);
-			break;
+	dg->ScnDirty (Scout::SCNF_AAP);
+	if (activate) {
+		SetValue (block, tgt[block]);
+	} else {
+		if (core) core->Disengage (block);
+		else      host->Off (dg, block);
 	}
 }
 
-void AAP::WriteScenario (FILEHANDLE scn)
+void AAP::FormatScenario (char *line) const
 {
-	int i;
-	char cbuf[256], line[256] = "";
-	for (i = 0; i < 3; i++) {
-		sprintf (cbuf, "%s%d:%g", i ? " ":"", active[i], tgt[i]);
-		strcat (line, cbuf);
+	for (int i = 0; i < 3; i++)
+		line += sprintf (line, "%s%d:%g", i ? " ":"", active[i], tgt[i]);
+}
+
+void AAP::GetTargets (double *t, bool *act) const
+{
+	for (int i = 0; i < 3; i++) {
+		t[i] = tgt[i];
+		act[i] = active[i];
+	}
+}
+
+void AAP::SetTargets (const double *t, const bool *act)
+{
+	dg->ScnDirty (Scout::SCNF_AAP);
+	for (int i = 0; i < 3; i++) {
+		bool newtgt = (t[i] != tgt[i]);
+		tgt[i] = t[i];
+		if (act[i] != active[i])   SetActive (i, act[i]);
+		else if (act[i] && newtgt) SetValue (i, tgt[i]);
 	}
-	oapiWriteScenario_string (scn, "AAP", line);
 }
 
 void AAP::SetState (const char *str)
@@ -271,6 +278,7 @@ void AAP::SetState (const char *str)
 	nitem = sscanf (str, "AAP %d:%lf %d:%lf %d:%lf",
 		state+0, val+0, state+1, val+1, state+2, val+2);
 	if (nitem == 6) {
+		dg->ScnDirty (Scout::SCNF_AAP);
 		for (i = 0; i < 3; i++) {
 			tgt[i] = val[i];
 			SetActive (i, state[i] != 0);
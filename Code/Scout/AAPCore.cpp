@@ -0,0 +1,155 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AAPCore.cpp
+// Native control loops for the atmospheric autopilot
+// ==============================================================
+
+#include "AAPCore.h"
+#include <math.h>
+
+static const double MAX_VS    = 50.0;      // max. commanded vertical speed [m/s]
+static const double MAX_PITCH = 20.0*RAD;  // max. commanded pitch [rad]
+static const double MAX_BANK  = 30.0*RAD;  // max. commanded bank [rad]
+
+static inline double Clamp (double x, double lo, double hi)
+{
+	return (x < lo ? lo : x > hi ? hi : x);
+}
+
+// ==============================================================
+
+void AAPCore::PID::Reset (double u0)
+{
+	ival = (ki ? Clamp (u0, omin, omax) : 0.0);
+	init = false;
+}
+
+double AAPCore::PID::Update (double e, double dt)
+{
+	double de = (init ? (e-eprev)/dt : 0.0);
+	eprev = e;
+	init = true;
+	double u = kp*e + ival + kd*de;
+	// integrate unless that would drive a saturated output further
+	// into its limit
+	if (ki && !(u >= omax && e > 0.0) && !(u <= omin && e < 0.0)) {
+		ival = Clamp (ival + ki*e*dt, omin, omax);
+		u = kp*e + ival + kd*de;
+	}
+	return Clamp (u, omin, omax);
+}
+
+// ==============================================================
+
+AAPCore::AAPCore (VESSEL *_vessel): vessel(_vessel)
+{
+	static const PID init[7] = {
+		// kp     ki      kd     omin        omax        state (set by Reset)
+		{0.1,    0.0,    0.0,   -MAX_VS,    MAX_VS,     0.0, 0.0, false},  // altitude error -> vertical speed [1/s]
+		{0.01,   0.002,  0.0,   -MAX_PITCH, MAX_PITCH,  0.0, 0.0, false},  // vertical speed error -> pitch [rad s/m]
+		{2.0,    0.5,    1.0,   -1.0,       1.0,        0.0, 0.0, false},  // pitch error -> elevator [1/rad]
+		{0.05,   0.01,   0.0,    0.0,       1.0,        0.0, 0.0, false},  // airspeed error -> throttle [s/m]
+		{1.0,    0.0,    0.0,   -MAX_BANK,  MAX_BANK,   0.0, 0.0, false},  // course error -> bank [-]
+		{1.5,    0.2,    0.5,   -1.0,       1.0,        0.0, 0.0, false},  // bank error -> aileron [1/rad]
+		{2.0,    0.5,    0.5,   -1.0,       1.0,        0.0, 0.0, false}   // sideslip -> rudder [1/rad]
+	};
+	PID *pid[7] = {&alt_vs, &vs_pitch, &pitch_elev, &spd_thr, &hdg_bank, &bank_ail, &slip_rud};
+	for (int i = 0; i < 7; i++) {
+		*pid[i] = init[i];
+		pid[i]->Reset();
+	}
+	for (int i = 0; i < NBLOCK; i++) {
+		active[i] = false;
+		tgt[i] = 0.0;
+	}
+	tacc = 0.0;
+}
+
+// ==============================================================
+
+void AAPCore::Engage (int block, double _tgt)
+{
+	tgt[block] = _tgt;
+	if (active[block]) return;
+	active[block] = true;
+	switch (block) {
+	case ALT:
+		alt_vs.Reset(); vs_pitch.Reset();
+		pitch_elev.Reset (vessel->GetControlSurfaceLevel (AIRCTRL_ELEVATOR));
+		break;
+	case SPD:
+		spd_thr.Reset (vessel->GetThrusterGroupLevel (THGROUP_MAIN));
+		break;
+	case HDG:
+		hdg_bank.Reset(); slip_rud.Reset();
+		bank_ail.Reset (vessel->GetControlSurfaceLevel (AIRCTRL_AILERON));
+		break;
+	}
+}
+
+// ==============================================================
+
+void AAPCore::Disengage (int block)
+{
+	if (!active[block]) return;
+	active[block] = false;
+	switch (block) {
+	case ALT:
+		vessel->SetControlSurfaceLevel (AIRCTRL_ELEVATOR, 0.0);
+		break;
+	case HDG:
+		vessel->SetControlSurfaceLevel (AIRCTRL_AILERON, 0.0);
+		vessel->SetControlSurfaceLevel (AIRCTRL_RUDDER, 0.0);
+		break;
+	}
+	// the throttle is left where the speed loop put it
+}
+
+// ==============================================================
+
+void AAPCore::Step (double simdt)
+{
+	if (!active[ALT] && !active[SPD] && !active[HDG]) return;
+
+	// run on a fixed time grid; at high time acceleration several
+	// grid intervals are covered by a single update
+	tacc += simdt;
+	if (tacc < AAPCORE_DT) return;
+	double n = floor (tacc/AAPCORE_DT);
+	double dt = n*AAPCORE_DT;
+	tacc -= dt;
+
+	bool aero = (vessel->GetDynPressure() >= AAPCORE_MINDYNP);
+
+	if (active[ALT] && aero) {
+		VECTOR3 v;
+		vessel->GetAirspeedVector (FRAME_HORIZON, v);
+		double vs_tgt    = alt_vs.Update (tgt[ALT]-vessel->GetAltitude(), dt);
+		double pitch_tgt = vs_pitch.Update (vs_tgt-v.y, dt);
+		double elev      = pitch_elev.Update (pitch_tgt-vessel->GetPitch(), dt);
+		vessel->SetControlSurfaceLevel (AIRCTRL_ELEVATOR, elev);
+	}
+
+	if (active[SPD]) {
+		double thr = spd_thr.Update (tgt[SPD]-vessel->GetAirspeed(), dt);
+		vessel->SetThrusterGroupLevel (THGROUP_MAIN, thr);
+	}
+
+	if (active[HDG] && aero) {
+		VECTOR3 v;
+		vessel->GetAirspeedVector (FRAME_HORIZON, v);
+		double crs = atan2 (v.x, v.z);
+		double e = tgt[HDG]-crs;
+		while (e >  PI) e -= PI2;
+		while (e < -PI) e += PI2;
+		double bank_tgt = hdg_bank.Update (e, dt);
+		double ail = bank_ail.Update (bank_tgt-vessel->GetBank(), dt);
+		double rud = slip_rud.Update (-vessel->GetSlipAngle(), dt);
+		vessel->SetControlSurfaceLevel (AIRCTRL_AILERON, ail);
+		vessel->SetControlSurfaceLevel (AIRCTRL_RUDDER, rud);
+	}
+}
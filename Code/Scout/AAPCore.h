@@ -0,0 +1,78 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AAPCore.h
+// Native control loops for the atmospheric autopilot
+//
+// Notes:
+// A compiled alternative to the aap.lua script, selected with the
+// AAP_NATIVE entry in the class cfg. It holds altitude, airspeed
+// and course with cascaded PID loops:
+// * altitude -> vertical speed -> pitch -> elevator
+// * airspeed -> main engine throttle
+// * course -> bank -> ailerons, with a sideslip damper on the
+//   rudder
+// The loops run on a fixed AAPCORE_DT time grid from the vessel's
+// time step and don't allocate memory. Like the script, they only
+// act at sufficient dynamic pressure.
+// Each PID clamps its output to the range of the quantity it drives.
+// The integrator is limited to the same range and stops while the
+// output is saturated in the direction of the error (conditional
+// integration), so the loops neither wind up nor leave a standing
+// error when the trim value needs more than a fraction of the range.
+// Engaging a block starts its innermost integrator at the current
+// control setting, to avoid a jump.
+// ==============================================================
+
+#ifndef __AAPCORE_H
+#define __AAPCORE_H
+
+#include "Orbitersdk.h"
+
+const double AAPCORE_DT = 0.05;
+// control loop update interval [s]
+
+const double AAPCORE_MINDYNP = 1e3;
+// min. dynamic pressure for the control surfaces to be driven [Pa]
+
+class AAPCore {
+public:
+	enum Block { ALT, SPD, HDG, NBLOCK };
+
+	AAPCore (VESSEL *_vessel);
+	// constructor
+
+	void Engage (int block, double tgt);
+	// Hold the target value of a block: altitude [m], airspeed [m/s]
+	// or course [rad]. If the block is already engaged, only the
+	// target is changed.
+
+	void Disengage (int block);
+	// Stop a block and centre the controls it was driving
+
+	void Step (double simdt);
+	// Advance the control loops. Call once per time step.
+
+private:
+	struct PID {
+		double kp, ki, kd;     // gains
+		double omin, omax;     // output range
+		double ival, eprev;    // integrator state, previous error
+		bool init;             // eprev valid?
+		void Reset (double u0 = 0.0);
+		double Update (double e, double dt);
+	};
+
+	VESSEL *vessel;           // vessel pointer
+	bool active[NBLOCK];      // block engaged?
+	double tgt[NBLOCK];       // block targets
+	double tacc;              // time since last loop update [s]
+	PID alt_vs, vs_pitch, pitch_elev;  // altitude cascade
+	PID spd_thr;                       // airspeed loop
+	PID hdg_bank, bank_ail, slip_rud;  // course loops
+};
+
+#endif // !__AAPCORE_H
@@ -0,0 +1,352 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AAPHost.cpp
+// Shared script interpreters for the atmospheric autopilot
+// ==============================================================
+
+#include "AAPHost.h"
+#include "StepProfile.h"
+#include <stdio.h>
+
+extern "C" {
+#include "lua\lua.h"
+#include "lua\lualib.h"
+#include "lua\lauxlib.h"
+}
+
+AAPHost *AAPHost::host[AAPHOST_MAXINTERP];
+int AAPHost::nhost = 0;
+
+static const char *blockfunc[3] = {"alt", "spd", "hdg"};
+
+// Host script, run once per interpreter. aaphost.add runs the
+// autopilot chunk in a fresh environment for each vessel.
+// aaphost.pump is added from C (AAPHost::InitInterpreter) when
+// the first vessel interface is created.
+static const char *hostscript =
+	"aaphost = {env = {}}\n"
+	"aaphost.chunk = loadfile ('Script/dg/aap.lua')\n"
+	"function aaphost.add (id, name)\n"
+	"  if not aaphost.chunk then return end\n"
+	"  local v = vessel.get_interface (name)\n"
+	"  local vs = setmetatable ({get_focusinterface = function () return v end}, {__index = vessel})\n"
+	"  local env = setmetatable ({V = v, vessel = vs}, {__index = _G})\n"
+	"  setfenv (aaphost.chunk, env)\n"
+	"  aaphost.chunk ()\n"
+	"  aaphost.env[id] = env\n"
+	"end\n"
+	"function aaphost.del (id)\n"
+	"  local env = aaphost.env[id]\n"
+	"  if env and env.aap then\n"
+	"    pcall (env.aap.alt); pcall (env.aap.spd); pcall (env.aap.hdg)\n"
+	"  end\n"
+	"  aaphost.env[id] = nil\n"
+	"end\n";
+
+// ==============================================================
+
+AAPHost *AAPHost::Attach (VESSEL *v)
+{
+	PROFILE_BEGIN (AAPSPAWN);
+	AAPHost *h = NULL;
+	int i;
+
+#ifndef SCOUT_AAP_PERVESSEL
+	// least loaded interpreter in the pool
+	for (i = 0; i < nhost; i++)
+		if (!h || host[i]->nchan < h->nchan) h = host[i];
+
+	// start another interpreter if all are busy and a core is free
+	if (h && h->nchan >= AAPHOST_BATCH) {
+		SYSTEM_INFO si;
+		GetSystemInfo (&si);
+		if (nhost < min ((int)si.dwNumberOfProcessors, AAPHOST_MAXINTERP)) h = NULL;
+	}
+#endif
+	if (!h) {
+		h = new AAPHost;
+#ifndef SCOUT_AAP_PERVESSEL
+		host[nhost++] = h;
+#endif
+		PROFILE_COUNT (AAP_INTERP);
+	}
+
+	EnterCriticalSection (&h->cs);
+	if (h->nchan == h->nbuf) {
+		CHANNEL *tmp = new CHANNEL[h->nbuf += 16];
+		if (h->nchan) {
+			memcpy (tmp, h->chan, h->nchan*sizeof(CHANNEL));
+			delete []h->chan;
+		}
+		h->chan = tmp;
+	}
+	CHANNEL *c = h->chan + h->nchan++;
+	c->v = v;
+	for (i = 0; i < 3; i++) {
+		c->ref[i] = LUA_NOREF;
+		c->val[i] = 0.0;
+		c->cmd[i] = CMD_NONE;
+	}
+	c->warned = false;
+	LeaveCriticalSection (&h->cs);
+
+	char name[256], cbuf[300];
+	LuaQuoteString (name, 256, v->GetName());
+	sprintf (cbuf, "aaphost.add('%p',%s)", v->GetHandle(), name);
+	oapiAsyncScriptCmd (h->hInterp, cbuf);
+	PROFILE_END (AAPSPAWN);
+	return h;
+}
+
+// ==============================================================
+
+void AAPHost::Detach (VESSEL *v)
+{
+	int i;
+
+	EnterCriticalSection (&cs);
+	for (i = 0; i < nchan; i++)
+		if (chan[i].v == v) break;
+	if (i < nchan) {
+		// hand the function refs to the next pump for release
+		for (int b = 0; b < 3; b++) {
+			if (chan[i].ref[b] < 0) continue;
+			if (ndrop == ndropbuf) {
+				int *tmp = new int[ndropbuf += 16];
+				if (ndrop) {
+					memcpy (tmp, drop, ndrop*sizeof(int));
+					delete []drop;
+				}
+				drop = tmp;
+			}
+			drop[ndrop++] = chan[i].ref[b];
+		}
+		chan[i] = chan[--nchan];
+	}
+	bool last = (nchan == 0);
+	LeaveCriticalSection (&cs);
+
+	if (!last) {
+		char cbuf[64];
+		sprintf (cbuf, "aaphost.del('%p')", v->GetHandle());
+		oapiAsyncScriptCmd (hInterp, cbuf);
+		return;
+	}
+
+	for (i = 0; i < nhost; i++)
+		if (host[i] == this) {
+			host[i] = host[--nhost];
+			break;
+		}
+	delete this;
+}
+
+// ==============================================================
+
+void AAPHost::Set (VESSEL *v, int block, double val)
+{
+	EnterCriticalSection (&cs);
+	CHANNEL *c = Channel (v);
+	if (c) Post (c, block, CMD_SET, val);
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+void AAPHost::Off (VESSEL *v, int block)
+{
+	EnterCriticalSection (&cs);
+	CHANNEL *c = Channel (v);
+	if (c) Post (c, block, CMD_OFF, 0.0);
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+AAPHost::CHANNEL *AAPHost::Channel (VESSEL *v)
+{
+	for (int i = 0; i < nchan; i++)
+		if (chan[i].v == v) return chan+i;
+	return NULL;
+}
+
+// ==============================================================
+// Record a command (overwriting any pending one for the same
+// block) and make sure a pump call is queued. Before the pump is
+// registered the command just waits. Called with cs held.
+
+void AAPHost::Post (CHANNEL *c, int block, int cmd, double val)
+{
+	c->cmd[block] = cmd;
+	c->val[block] = val;
+	if (pumpreg && !posted) {
+		posted = true;
+		oapiAsyncScriptCmd (hInterp, "if aaphost.pump then aaphost.pump() end");
+	}
+}
+
+// ==============================================================
+
+void AAPHost::InitInterpreter (lua_State *L)
+{
+	lua_getglobal (L, "aaphost");
+	if (lua_istable (L, -1)) {
+		lua_getfield (L, -1, "pump");
+		bool reg = lua_isnil (L, -1);
+		lua_pop (L, 1);
+		if (reg) {
+			lua_pushlightuserdata (L, this);
+			lua_pushcclosure (L, lua_pump, 1);
+			lua_setfield (L, -2, "pump");
+
+			// deliver what was posted before the pump existed
+			EnterCriticalSection (&cs);
+			pumpreg = true;
+			for (int i = 0; i < nchan && !posted; i++)
+				for (int b = 0; b < 3; b++)
+					if (chan[i].cmd[b] != CMD_NONE) {
+						posted = true;
+						oapiAsyncScriptCmd (hInterp, "if aaphost.pump then aaphost.pump() end");
+						break;
+					}
+			LeaveCriticalSection (&cs);
+		}
+	}
+	lua_pop (L, 1);
+}
+
+// ==============================================================
+
+int AAPHost::lua_pump (lua_State *L)
+{
+	AAPHost *h = (AAPHost*)lua_touserdata (L, lua_upvalueindex (1));
+	h->Pump (L);
+	return 0;
+}
+
+// ==============================================================
+// Look up aaphost.env[id].aap.alt/spd/hdg of a vessel and keep
+// registry references to those not yet resolved
+
+void AAPHost::Resolve (lua_State *L, CHANNEL *c)
+{
+	char id[32];
+	sprintf (id, "%p", c->v->GetHandle());
+	lua_getglobal (L, "aaphost");
+	lua_getfield (L, -1, "env");
+	lua_getfield (L, -1, id);
+	if (lua_istable (L, -1)) {
+		lua_getfield (L, -1, "aap");
+		if (lua_istable (L, -1)) {
+			for (int b = 0; b < 3; b++) {
+				if (c->ref[b] != LUA_NOREF) continue;
+				lua_getfield (L, -1, blockfunc[b]);
+				if (lua_isfunction (L, -1)) c->ref[b] = luaL_ref (L, LUA_REGISTRYINDEX);
+				else                        lua_pop (L, 1);
+			}
+		}
+		lua_pop (L, 1);
+	}
+	lua_pop (L, 3);
+}
+
+// ==============================================================
+// Deliver pending commands. Runs in the interpreter. Commands
+// whose function isn't available yet are kept for the next pump.
+
+void AAPHost::Pump (lua_State *L)
+{
+	int i, b;
+
+	EnterCriticalSection (&cs);
+	posted = false;
+	for (i = 0; i < ndrop; i++)
+		luaL_unref (L, LUA_REGISTRYINDEX, drop[i]);
+	ndrop = 0;
+
+	for (i = 0; i < nchan; i++) {
+		CHANNEL *c = chan+i;
+		for (b = 0; b < 3; b++) {
+			if (c->cmd[b] == CMD_NONE) continue;
+			if (c->ref[b] == LUA_NOREF) Resolve (L, c);
+			if (c->ref[b] < 0) {
+				if (!c->warned) {
+					char cbuf[256];
+					_snprintf (cbuf, 255, "Scout: aap.%s not available for %s, command kept pending", blockfunc[b], c->v->GetName());
+					cbuf[255] = '\0';
+					oapiWriteLog (cbuf);
+					c->warned = true;
+				}
+				continue;
+			}
+			lua_rawgeti (L, LUA_REGISTRYINDEX, c->ref[b]);
+			int narg = 0;
+			if (c->cmd[b] == CMD_SET) {
+				lua_pushnumber (L, c->val[b]);
+				narg = 1;
+			}
+			if (lua_pcall (L, narg, 0, 0)) {
+				char cbuf[256];
+				_snprintf (cbuf, 255, "Scout: aap.%s: %s", blockfunc[b], lua_tostring (L, -1));
+				cbuf[255] = '\0';
+				oapiWriteLog (cbuf);
+				lua_pop (L, 1);
+			}
+			c->cmd[b] = CMD_NONE;
+		}
+	}
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+void LuaQuoteString (char *buf, int size, const char *str)
+{
+	char *c = buf, *end = buf+size-2; // room for closing quote and zero
+	*c++ = '"';
+	for (; *str; str++) {
+		unsigned char ch = (unsigned char)*str;
+		if (ch == '"' || ch == '\\') {
+			if (c+2 > end) break;
+			*c++ = '\\';
+			*c++ = ch;
+		} else if (ch < 32 || ch == 127) {
+			if (c+4 > end) break;
+			c += sprintf (c, "\\%03d", ch); // 3 digits: safe before a digit
+		} else {
+			if (c+1 > end) break;
+			*c++ = ch;
+		}
+	}
+	*c++ = '"';
+	*c = '\0';
+}
+
+// ==============================================================
+
+AAPHost::AAPHost ()
+{
+	InitializeCriticalSection (&cs);
+	chan = NULL;
+	nchan = nbuf = 0;
+	drop = NULL;
+	ndrop = ndropbuf = 0;
+	posted = false;
+	pumpreg = false;
+	hInterp = oapiCreateInterpreter();
+	oapiAsyncScriptCmd (hInterp, hostscript);
+}
+
+// ==============================================================
+
+AAPHost::~AAPHost ()
+{
+	oapiDelInterpreter (hInterp);
+	if (nbuf) delete []chan;
+	if (ndropbuf) delete []drop;
+	DeleteCriticalSection (&cs);
+}
@@ -0,0 +1,107 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AAPHost.h
+// Shared script interpreters for the atmospheric autopilot
+//
+// Notes:
+// * Instead of one interpreter per vessel, the autopilots of all
+//   Scouts share a small pool of interpreters (at most one per
+//   processor core, see AAPHOST_MAXINTERP). Each interpreter
+//   multiplexes up to AAPHOST_BATCH vessels before another one
+//   is started.
+// * aap.lua is compiled once per interpreter. Each vessel runs it
+//   in its own environment table, stored in the interpreter's
+//   aaphost.env table under the vessel handle. Within that
+//   environment V and vessel.get_focusinterface() refer to the
+//   vessel, so the autopilot state is kept per vessel.
+// * Autopilot commands don't go through script strings. Set and
+//   Off store the latest value per vessel and block; the pump
+//   function, which runs in the interpreter, calls the vessel's
+//   aap.alt/spd/hdg functions with numeric arguments via registry
+//   references resolved on first use. Repeated updates before the
+//   next pump are coalesced, so only the latest value is sent.
+// * The pump is only queued once InitInterpreter has registered it.
+//   Commands posted before that wait in their channel and are sent
+//   by the first pump. A command whose function can't be resolved
+//   (e.g. aap.lua failed to load) stays pending and is retried at
+//   the next pump; the failure is logged once per vessel.
+// * Interpreters are released when their last vessel leaves.
+// * Defining SCOUT_AAP_PERVESSEL restores one interpreter per
+//   vessel, for comparing spawn time and memory use.
+// ==============================================================
+
+#ifndef __AAPHOST_H
+#define __AAPHOST_H
+
+#include "Orbitersdk.h"
+
+struct lua_State;
+
+const int AAPHOST_MAXINTERP = 8;
+// max. number of shared interpreters
+
+const int AAPHOST_BATCH = 16;
+// vessels per interpreter before another one is started
+
+class AAPHost {
+public:
+	static AAPHost *Attach (VESSEL *v);
+	// Add the autopilot of vessel v to a shared interpreter and
+	// return that interpreter's host.
+
+	void Detach (VESSEL *v);
+	// Switch off and remove the autopilot of v. The interpreter is
+	// deleted when no vessels are left. The host must not be used
+	// by v after this call.
+
+	void Set (VESSEL *v, int block, double val);
+	// Engage autopilot block (0=alt, 1=spd, 2=hdg) of v with target
+	// value val, in the units of aap.lua
+
+	void Off (VESSEL *v, int block);
+	// Disengage autopilot block of v
+
+	void InitInterpreter (lua_State *L);
+	// Register the pump function in interpreter L if it runs the
+	// host script. Called from the vessel's Lua instance callback.
+
+private:
+	AAPHost ();
+	~AAPHost ();
+
+	enum { CMD_NONE, CMD_SET, CMD_OFF };
+	struct CHANNEL {
+		VESSEL *v;                // vessel
+		int ref[3];               // registry refs of aap.alt/spd/hdg
+		double val[3];            // latest target per block
+		int cmd[3];               // pending command per block
+		bool warned;              // unresolved command logged
+	};
+	CHANNEL *Channel (VESSEL *v);
+	void Post (CHANNEL *c, int block, int cmd, double val);
+	void Resolve (lua_State *L, CHANNEL *c);
+	void Pump (lua_State *L);
+	static int lua_pump (lua_State *L);
+
+	INTERPRETERHANDLE hInterp;   // script interpreter
+	CRITICAL_SECTION cs;         // guards the command state
+	CHANNEL *chan;               // vessels served
+	int nchan, nbuf;             // number of vessels, allocated size
+	int *drop, ndrop, ndropbuf;  // registry refs to release at the next pump
+	bool posted;                 // pump call queued?
+	bool pumpreg;                // pump registered in the interpreter?
+
+	static AAPHost *host[AAPHOST_MAXINTERP]; // interpreter pool
+	static int nhost;            // number of pool entries in use
+};
+
+void LuaQuoteString (char *buf, int size, const char *str);
+// Write str to buf (size chars, including the terminating zero) as a
+// quoted Lua string literal, with quotes, backslashes and control
+// characters escaped. Used to pass vessel names into script commands.
+
+#endif // !__AAPHOST_H
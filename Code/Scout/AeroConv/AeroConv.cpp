@@ -0,0 +1,187 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AeroConv.cpp
+// Offline converter: CSV aerodynamic table -> binary database
+//
+// Usage: AeroConv <input.csv> <output.aero>
+//
+// Each data line of the input holds 9 comma-separated values:
+//   mach, aoa, beta, cl_v, cm_v, cd_v, cl_h, cm_h, cd_h
+// with angles in degrees. Lines that don't start with a number
+// (headers, comments) are skipped. The rows must cover a regular
+// grid (uniform spacing along each axis, every node present
+// exactly once) but may appear in any order.
+//
+// Build: AeroConv.vcproj, or cl /O2 /I.. AeroConv.cpp
+// ==============================================================
+
+#include "AeroDBFormat.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+const int NCOL = 9;
+const double RAD = 3.14159265358979323846/180.0;
+
+struct ROW { double v[NCOL]; };
+
+// ==============================================================
+
+static int cmpdouble (const void *a, const void *b)
+{
+	double d = *(const double*)a - *(const double*)b;
+	return (d < 0.0 ? -1 : d > 0.0 ? 1 : 0);
+}
+
+// ==============================================================
+// Find the regular grid spanned by column col of the rows.
+// Returns false if the values are not uniformly spaced.
+
+static bool FindAxis (const ROW *row, int nrow, int col, DWORD &n, double &x0, double &dx)
+{
+	int i;
+	double *x = new double[nrow];
+	for (i = 0; i < nrow; i++) x[i] = row[i].v[col];
+	qsort (x, nrow, sizeof(double), cmpdouble);
+
+	double span = x[nrow-1]-x[0];
+	double tol = 1e-6*(span > 0.0 ? span : 1.0);
+	n = 1;
+	for (i = 1; i < nrow; i++)
+		if (x[i]-x[n-1] > tol) x[n++] = x[i];
+	x0 = x[0];
+	dx = (n > 1 ? span/(n-1) : 0.0);
+	bool ok = true;
+	for (i = 1; i < (int)n; i++)
+		if (fabs (x[i]-x0-i*dx) > tol) ok = false;
+	delete []x;
+	return ok;
+}
+
+// ==============================================================
+
+int main (int argc, char *argv[])
+{
+	if (argc != 3) {
+		fprintf (stderr, "Usage: AeroConv <input.csv> <output.aero>\n");
+		return 1;
+	}
+
+	FILE *f = fopen (argv[1], "rt");
+	if (!f) {
+		fprintf (stderr, "AeroConv: cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	// read data rows
+	char line[1024];
+	int i, j, nrow = 0, nbuf = 0, lineno = 0;
+	ROW *row = 0;
+	while (fgets (line, 1024, f)) {
+		lineno++;
+		char *c = line;
+		while (*c == ' ' || *c == '\t') c++;
+		if (!(*c == '-' || *c == '+' || *c == '.' || (*c >= '0' && *c <= '9'))) continue;
+		if (nrow == nbuf) {
+			nbuf = (nbuf ? nbuf*2 : 1024);
+			ROW *tmp = new ROW[nbuf];
+			if (nrow) {
+				memcpy (tmp, row, nrow*sizeof(ROW));
+				delete []row;
+			}
+			row = tmp;
+		}
+		ROW &r = row[nrow];
+		for (j = 0; j < NCOL; j++) {
+			char *end;
+			r.v[j] = strtod (c, &end);
+			if (end == c) break;
+			c = end;
+			while (*c == ' ' || *c == '\t' || *c == ',' || *c == ';') c++;
+		}
+		if (j < NCOL) {
+			fprintf (stderr, "AeroConv: %s(%d): expected %d values\n", argv[1], lineno, NCOL);
+			return 1;
+		}
+		r.v[1] *= RAD;
+		r.v[2] *= RAD;
+		nrow++;
+	}
+	fclose (f);
+	if (!nrow) {
+		fprintf (stderr, "AeroConv: no data in %s\n", argv[1]);
+		return 1;
+	}
+
+	// determine grid
+	AERODB_HEADER hdr;
+	memset (&hdr, 0, sizeof(hdr));
+	memcpy (hdr.magic, AERODB_MAGIC, 8);
+	hdr.version = AERODB_VERSION;
+	double x0[3], dx[3];
+	static const char *axisname[3] = {"Mach", "AoA", "sideslip"};
+	for (i = 0; i < 3; i++) {
+		if (!FindAxis (row, nrow, i, hdr.n[i], x0[i], dx[i])) {
+			fprintf (stderr, "AeroConv: %s values are not uniformly spaced\n", axisname[i]);
+			return 1;
+		}
+		if (hdr.n[i] < 2) {
+			fprintf (stderr, "AeroConv: need at least 2 %s values\n", axisname[i]);
+			return 1;
+		}
+		hdr.x0[i] = (float)x0[i];
+		hdr.dx[i] = (float)dx[i];
+	}
+
+	// scatter rows into the node array
+	DWORD nnode = hdr.n[0]*hdr.n[1]*hdr.n[2];
+	float *node = new float[nnode*AERODB_NCOEFF];
+	bool *set = new bool[nnode];
+	memset (node, 0, nnode*AERODB_NCOEFF*sizeof(float));
+	memset (set, 0, nnode*sizeof(bool));
+	for (i = 0; i < nrow; i++) {
+		DWORD k[3];
+		for (j = 0; j < 3; j++)
+			k[j] = (DWORD)floor ((row[i].v[j]-x0[j])/dx[j] + 0.5);
+		DWORD idx = (k[0]*hdr.n[1] + k[1])*hdr.n[2] + k[2];
+		if (set[idx]) {
+			fprintf (stderr, "AeroConv: duplicate row for Mach %g, AoA %g, beta %g\n",
+				row[i].v[0], row[i].v[1]/RAD, row[i].v[2]/RAD);
+			return 1;
+		}
+		float *c = node + idx*AERODB_NCOEFF;
+		c[0] = (float)row[i].v[3]; c[1] = (float)row[i].v[4]; c[2] = (float)row[i].v[5];
+		c[4] = (float)row[i].v[6]; c[5] = (float)row[i].v[7]; c[6] = (float)row[i].v[8];
+		set[idx] = true;
+	}
+	for (DWORD n = 0; n < nnode; n++)
+		if (!set[n]) {
+			fprintf (stderr, "AeroConv: grid node %lu (Mach %g, AoA %g, beta %g) missing\n", (unsigned long)n,
+				x0[0] + (n/(hdr.n[1]*hdr.n[2]))*dx[0],
+				(x0[1] + ((n/hdr.n[2])%hdr.n[1])*dx[1])/RAD,
+				(x0[2] + (n%hdr.n[2])*dx[2])/RAD);
+			return 1;
+		}
+
+	// write database
+	f = fopen (argv[2], "wb");
+	if (!f) {
+		fprintf (stderr, "AeroConv: cannot create %s\n", argv[2]);
+		return 1;
+	}
+	fwrite (&hdr, sizeof(hdr), 1, f);
+	fwrite (node, sizeof(float), nnode*AERODB_NCOEFF, f);
+	fclose (f);
+	printf ("AeroConv: %lu x %lu x %lu nodes written to %s\n",
+		(unsigned long)hdr.n[0], (unsigned long)hdr.n[1], (unsigned long)hdr.n[2], argv[2]);
+
+	delete []set;
+	delete []node;
+	delete []row;
+	return 0;
+}
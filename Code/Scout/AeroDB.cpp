@@ -0,0 +1,175 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AeroDB.cpp
+// Memory-mapped Mach x AoA x sideslip aerodynamic database
+// ==============================================================
+
+#include "AeroDB.h"
+#include <stdio.h>
+#include <float.h>
+#include <xmmintrin.h>
+
+AeroDB *AeroDB::first = NULL;
+
+// ==============================================================
+
+AeroDB *AeroDB::Open (const char *fname)
+{
+	AeroDB *db;
+	for (db = first; db; db = db->next)
+		if (!_stricmp (db->fname, fname)) {
+			db->nref++;
+			return db;
+		}
+
+	db = new AeroDB;
+	if (!db->Map (fname)) {
+		char cbuf[300];
+		sprintf (cbuf, "Scout: aerodynamic database %s not found or invalid", fname);
+		oapiWriteLog (cbuf);
+		delete db;
+		return NULL;
+	}
+	db->nref = 1;
+	db->next = first;
+	first = db;
+	return db;
+}
+
+// ==============================================================
+
+void AeroDB::Release (AeroDB *db)
+{
+	if (--db->nref > 0) return;
+
+	AeroDB **pdb;
+	for (pdb = &first; *pdb; pdb = &(*pdb)->next)
+		if (*pdb == db) {
+			*pdb = db->next;
+			break;
+		}
+	delete db;
+}
+
+// ==============================================================
+
+AeroDB::AeroDB ()
+{
+	fname[0] = '\0';
+	hFile = INVALID_HANDLE_VALUE;
+	hMap = NULL;
+	hdr = NULL;
+	node = NULL;
+	nref = 0;
+	next = NULL;
+}
+
+// ==============================================================
+
+AeroDB::~AeroDB ()
+{
+	if (hdr) UnmapViewOfFile (hdr);
+	if (hMap) CloseHandle (hMap);
+	if (hFile != INVALID_HANDLE_VALUE) CloseHandle (hFile);
+}
+
+// ==============================================================
+
+bool AeroDB::Map (const char *fn)
+{
+	int i;
+	strncpy (fname, fn, 255); fname[255] = '\0';
+
+	hFile = CreateFile (fname, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+	DWORD size = GetFileSize (hFile, NULL);
+	if (size < sizeof(AERODB_HEADER)) return false;
+	hMap = CreateFileMapping (hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMap) return false;
+	hdr = (const AERODB_HEADER*)MapViewOfFile (hMap, FILE_MAP_READ, 0, 0, 0);
+	if (!hdr) return false;
+
+	// validate header
+	if (memcmp (hdr->magic, AERODB_MAGIC, 8) || hdr->version != AERODB_VERSION) return false;
+	// (the running node count is kept below the file size, so the
+	// 64-bit products can't wrap)
+	unsigned __int64 nnode = 1;
+	for (i = 0; i < 3; i++) {
+		if (hdr->n[i] < 2 || !(hdr->dx[i] > 0.0f) || !_finite (hdr->x0[i])) return false;
+		nnode *= hdr->n[i];
+		if (nnode > size) return false;
+	}
+	if ((unsigned __int64)(size - sizeof(AERODB_HEADER)) < nnode*AERODB_NCOEFF*sizeof(float)) return false;
+
+	node = (const float*)(hdr+1);
+	for (i = 0; i < 3; i++)
+		idx[i] = 1.0/hdr->dx[i];
+	stride[AERODB_BETA] = AERODB_NCOEFF;
+	stride[AERODB_AOA]  = hdr->n[AERODB_BETA] * stride[AERODB_BETA];
+	stride[AERODB_MACH] = hdr->n[AERODB_AOA]  * stride[AERODB_AOA];
+	return true;
+}
+
+// ==============================================================
+
+void AeroDB::VLift (double M, double aoa, double beta, double *cl, double *cm, double *cd) const
+{
+	float c[4];
+	Lookup (M, aoa, beta, 0, c);
+	*cl = c[0], *cm = c[1], *cd = c[2];
+}
+
+// ==============================================================
+
+void AeroDB::HLift (double M, double aoa, double beta, double *cl, double *cm, double *cd) const
+{
+	float c[4];
+	Lookup (M, aoa, beta, 4, c);
+	*cl = c[0], *cm = c[1], *cd = c[2];
+}
+
+// ==============================================================
+// Trilinear interpolation of the 4-float coefficient group at
+// offset ofs of each node. Arguments outside the grid are clamped
+// to the boundary.
+
+static inline __m128 Lerp (__m128 a, __m128 b, __m128 f)
+{
+	return _mm_add_ps (a, _mm_mul_ps (_mm_sub_ps (b, a), f));
+}
+
+void AeroDB::Lookup (double M, double aoa, double beta, DWORD ofs, float *c) const
+{
+	const double x[3] = {M, aoa, beta};
+	DWORD i, k[3], p = ofs;
+	float f[3];
+
+	for (i = 0; i < 3; i++) {
+		double t = (x[i]-hdr->x0[i])*idx[i];
+		if (!(t > 0.0)) { // also catches NaN
+			k[i] = 0, f[i] = 0.0f;
+		} else if (t >= hdr->n[i]-1) {
+			k[i] = hdr->n[i]-2, f[i] = 1.0f;
+		} else {
+			k[i] = (DWORD)t, f[i] = (float)(t-k[i]);
+		}
+		p += k[i]*stride[i];
+	}
+
+	const float *n0 = node+p;                     // Mach node k
+	const float *n1 = n0+stride[AERODB_MACH];     // Mach node k+1
+	const DWORD sa = stride[AERODB_AOA], sb = stride[AERODB_BETA];
+	__m128 fb = _mm_set1_ps (f[AERODB_BETA]);
+	__m128 fa = _mm_set1_ps (f[AERODB_AOA]);
+	__m128 fm = _mm_set1_ps (f[AERODB_MACH]);
+
+	__m128 c00 = Lerp (_mm_load_ps (n0),    _mm_load_ps (n0+sb),    fb);
+	__m128 c01 = Lerp (_mm_load_ps (n0+sa), _mm_load_ps (n0+sa+sb), fb);
+	__m128 c10 = Lerp (_mm_load_ps (n1),    _mm_load_ps (n1+sb),    fb);
+	__m128 c11 = Lerp (_mm_load_ps (n1+sa), _mm_load_ps (n1+sa+sb), fb);
+	_mm_storeu_ps (c, Lerp (Lerp (c00, c01, fa), Lerp (c10, c11, fa), fm));
+}
@@ -0,0 +1,59 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AeroDB.h
+// Memory-mapped Mach x AoA x sideslip aerodynamic database
+//
+// Notes:
+// A database file is mapped read-only once and shared by all
+// vessels that name it in their class cfg (AERO_DATABASE entry).
+// Instances are reference-counted; use Open/Release rather than
+// new/delete.
+// ==============================================================
+
+#ifndef __AERODB_H
+#define __AERODB_H
+
+#include "Orbitersdk.h"
+#include "AeroDBFormat.h"
+
+class AeroDB {
+public:
+	static AeroDB *Open (const char *fname);
+	// Return the database for file fname, mapping it on first use.
+	// Returns NULL if the file is missing or not a valid database.
+
+	static void Release (AeroDB *db);
+	// Drop a reference obtained from Open. The file is unmapped
+	// when the last reference is released.
+
+	void VLift (double M, double aoa, double beta, double *cl, double *cm, double *cd) const;
+	// Vertical lift coefficients at Mach M, angle of attack aoa
+	// and sideslip beta [rad] (trilinear interpolation)
+
+	void HLift (double M, double aoa, double beta, double *cl, double *cm, double *cd) const;
+	// Horizontal lift coefficients at Mach M, angle of attack aoa
+	// and sideslip beta [rad] (trilinear interpolation)
+
+private:
+	AeroDB ();
+	~AeroDB ();
+	bool Map (const char *fname);
+	void Lookup (double M, double aoa, double beta, DWORD ofs, float *c) const;
+
+	char fname[256];          // database file name
+	HANDLE hFile, hMap;       // file and mapping handles
+	const AERODB_HEADER *hdr; // start of mapped view
+	const float *node;        // start of node data
+	double idx[3];            // inverse node spacing
+	DWORD stride[3];          // node stride [floats] along each axis
+	int nref;                 // reference count
+	AeroDB *next;             // next database in the module list
+
+	static AeroDB *first;     // list of open databases
+};
+
+#endif // !__AERODB_H
@@ -0,0 +1,43 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// AeroDBFormat.h
+// File layout of the binary aerodynamic database
+//
+// Notes:
+// * The file consists of an AERODB_HEADER followed by
+//   n[0]*n[1]*n[2] nodes on a regular Mach x AoA x sideslip grid.
+//   Sideslip varies fastest, Mach slowest.
+// * Each node holds AERODB_NCOEFF floats: the vertical lift
+//   coefficients (cl, cm, cd, unused) followed by the horizontal
+//   lift coefficients (cl, cm, cd, unused). Drag coefficients are
+//   totals (profile, induced and wave drag).
+// * Header and node sizes are multiples of 16 bytes so that every
+//   coefficient group in the mapped file is SSE-aligned.
+// * Files are produced from CSV with the AeroConv tool.
+// ==============================================================
+
+#ifndef __AERODBFORMAT_H
+#define __AERODBFORMAT_H
+
+#include <windows.h>
+
+#define AERODB_MAGIC "SCOUTAER"
+const DWORD AERODB_VERSION = 1;
+const DWORD AERODB_NCOEFF = 8;
+
+enum { AERODB_MACH, AERODB_AOA, AERODB_BETA };
+// grid axes
+
+struct AERODB_HEADER {
+	char  magic[8];  // AERODB_MAGIC (not zero-terminated)
+	DWORD version;   // AERODB_VERSION
+	DWORD n[3];      // number of nodes along each axis (>= 2)
+	float x0[3];     // first node: Mach, AoA [rad], sideslip [rad]
+	float dx[3];     // node spacing along each axis
+};
+
+#endif // !__AERODBFORMAT_H
@@ -0,0 +1,55 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// CheckpointRing.cpp
+// Fixed-size ring of binary state snapshots
+// ==============================================================
+
+#include "CheckpointRing.h"
+
+// ==============================================================
+
+CheckpointRing::CheckpointRing (DWORD _size, DWORD _n)
+{
+	size = _size;
+	n = (_n ? _n : 1);
+	head = cnt = 0;
+	buf = new BYTE[size*n];
+}
+
+// ==============================================================
+
+CheckpointRing::~CheckpointRing ()
+{
+	delete []buf;
+}
+
+// ==============================================================
+
+void *CheckpointRing::Push ()
+{
+	void *slot = buf + head*size;
+	head = (head+1) % n;
+	if (cnt < n) cnt++;
+	return slot;
+}
+
+// ==============================================================
+
+const void *CheckpointRing::Get (DWORD back) const
+{
+	if (back >= cnt) return NULL;
+	return buf + ((head + n - 1 - back) % n)*size;
+}
+
+// ==============================================================
+
+void CheckpointRing::Drop (DWORD k)
+{
+	if (k > cnt) k = cnt;
+	head = (head + n - k) % n;
+	cnt -= k;
+}
@@ -0,0 +1,51 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// CheckpointRing.h
+// Fixed-size ring of binary state snapshots
+//
+// Notes:
+// The ring holds up to n blobs of a fixed size in a single block
+// allocated by the constructor. Pushing a new blob overwrites the
+// oldest one when the ring is full, so taking a checkpoint never
+// allocates.
+// ==============================================================
+
+#ifndef __CHECKPOINTRING_H
+#define __CHECKPOINTRING_H
+
+#include "Orbitersdk.h"
+
+class CheckpointRing {
+public:
+	CheckpointRing (DWORD _size, DWORD _n);
+	// constructor: ring of _n blobs of _size bytes each
+
+	~CheckpointRing ();
+	// destructor
+
+	void *Push ();
+	// Return the slot for a new newest blob. The caller fills it.
+
+	const void *Get (DWORD back) const;
+	// Blob stored back entries before the newest one (0 = newest),
+	// or NULL if there are not that many
+
+	void Drop (DWORD k);
+	// Discard the k newest blobs
+
+	inline DWORD Count () const { return cnt; }
+	// number of blobs stored
+
+private:
+	DWORD size;             // blob size [bytes]
+	DWORD n;                // ring capacity
+	DWORD head;             // slot of the next push
+	DWORD cnt;              // number of blobs stored
+	BYTE *buf;              // n*size bytes
+};
+
+#endif // !__CHECKPOINTRING_H
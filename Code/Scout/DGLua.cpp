@@ -1,5 +1,9 @@
 #include "Scout.h"
+#include "AAP.h"
+#include "LuaProfile.h"
+#include "Sequencer.h"
 #include <stdio.h>
+#include <string.h>
 
 extern "C" {
 #include "lua\lua.h"
@@ -19,6 +23,19 @@ int dgOLock (lua_State *L);
 int dgILock (lua_State *L);
 int dgRadiator (lua_State *L);
 int dgABrake (lua_State *L);
+static int dgGetState (lua_State *L);
+static int dgSetDoors (lua_State *L);
+static int dgProfileDump (lua_State *L);
+static int dgSequence (lua_State *L);
+static int dgStopSequences (lua_State *L);
+static int dgWait (lua_State *L);
+static int dgWaitDoor (lua_State *L);
+static int dgWaitAbove (lua_State *L);
+static int dgWaitBelow (lua_State *L);
+static int dgCheckpoint (lua_State *L);
+static int dgRewind (lua_State *L);
+static int dgSaveCheckpoint (lua_State *L);
+static int dgRestoreCheckpoint (lua_State *L);
 
 // ==========================================================================
 // API initialisation
@@ -27,8 +44,15 @@ int Scout::Lua_InitInterpreter (void *context)
 {
 	lua_State *L = (lua_State*)context;
 
-	// load atmospheric autopilot
-	luaL_dofile (L, "Script\\dg\\aap.lua");
+	// script profiler, if enabled in the cfg file
+	LuaProfile::Install (L);
+
+	// load atmospheric autopilot (once per interpreter, not once
+	// per Scout in the scenario)
+	lua_getglobal (L, "aap");
+	if (lua_isnil (L, -1))
+		luaL_dofile (L, "Script\\dg\\aap.lua");
+	lua_pop (L, 1);
 
 	return 0;
 }
@@ -37,6 +61,14 @@ int Scout::Lua_InitInstance (void *context)
 {
 	lua_State *L = (lua_State*)context;
 
+	// autopilot command channel, if L is our autopilot interpreter
+	if (aap) aap->InitInterpreter (L);
+
+	// sequence pump, if L is the sequence interpreter. Not done in
+	// Lua_InitInterpreter: that runs before the interpreter has
+	// executed any command, so seqhost doesn't exist yet.
+	Sequencer::InitInterpreter (L);
+
 	// check if interpreter has DG table loaded already
 	luaL_getmetatable (L, "VESSEL.DG");
 
@@ -51,6 +83,19 @@ int Scout::Lua_InitInstance (void *context)
 			{"ILock", dgILock},
 			{"Radiator", dgRadiator},
 			{"ABrake", dgABrake},
+			{"GetState", dgGetState},
+			{"SetDoors", dgSetDoors},
+			{"ProfileDump", dgProfileDump},
+			{"Sequence", dgSequence},
+			{"StopSequences", dgStopSequences},
+			{"Wait", dgWait},
+			{"WaitDoor", dgWaitDoor},
+			{"WaitAbove", dgWaitAbove},
+			{"WaitBelow", dgWaitBelow},
+			{"Checkpoint", dgCheckpoint},
+			{"Rewind", dgRewind},
+			{"SaveCheckpoint", dgSaveCheckpoint},
+			{"RestoreCheckpoint", dgRestoreCheckpoint},
 			{NULL, NULL}
 		};
 
@@ -171,3 +216,297 @@ static int dgABrake (lua_State *L)
 		dg->ActivateAirbrake (DGaction[action]);
 	return 0;
 }
+
+// ==========================================================================
+// Bulk state query and batched door commands
+
+// actuator names, indexed by Scout::Actuator
+static const char *actname[Scout::NACTUATOR] = {
+	"gear", "retro", "nosecone", "ladder", "hatch", "olock", "ilock", "radiator", "airbrake"
+};
+
+// actuator operating functions, indexed by Scout::Actuator
+static void (Scout::*actfunc[Scout::NACTUATOR])(Scout::DoorStatus) = {
+	&Scout::ActivateLandingGear, &Scout::ActivateRCover, &Scout::ActivateDockingPort,
+	&Scout::ActivateLadder, &Scout::ActivateHatch, &Scout::ActivateOuterAirlock,
+	&Scout::ActivateInnerAirlock, &Scout::ActivateRadiator, &Scout::ActivateAirbrake
+};
+
+static void setnumber (lua_State *L, const char *key, double val)
+{
+	lua_pushnumber (L, val);
+	lua_setfield (L, -2, key);
+}
+
+// Push field key of the table on top of the stack, replacing it
+// with a new table if it is missing or was overwritten by a script
+static void subtable (lua_State *L, const char *key, int narr, int nrec)
+{
+	lua_getfield (L, -1, key);
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_createtable (L, narr, nrec);
+		lua_pushvalue (L, -1);
+		lua_setfield (L, -3, key);
+	}
+}
+
+static void setarray (lua_State *L, const char *key, const int *val, int n)
+{
+	subtable (L, key, n, 0);
+	for (int i = 0; i < n; i++) {
+		lua_pushnumber (L, val[i]);
+		lua_rawseti (L, -2, i+1);
+	}
+	lua_pop (L, 1);
+}
+
+static int dgGetState (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	return (dg ? dg->Lua_GetState (L) : 0);
+}
+
+static int dgSetDoors (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	return (dg ? dg->Lua_SetDoors (L) : 0);
+}
+
+// Write the script profile now. Returns the number of functions
+// written, or nil if profiling is disabled (LUA_PROFILE in the cfg).
+static int dgProfileDump (lua_State *L)
+{
+	int n = LuaProfile::Dump ();
+	if (n < 0) lua_pushnil (L);
+	else       lua_pushnumber (L, n);
+	return 1;
+}
+
+// Start a sequence (a Lua chunk, or '@' followed by a file name)
+// that runs as a coroutine with V set to this vessel.
+static int dgSequence (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	const char *src = luaL_checkstring (L, 2);
+	lua_pushboolean (L, dg && Sequencer::Start (dg, src));
+	return 1;
+}
+
+static int dgStopSequences (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	if (dg) Sequencer::Stop (dg);
+	return 0;
+}
+
+// Common exit of the wait functions: suspend the sequence until the
+// condition fires, or return at once if it is already met
+static int seqwait (lua_State *L, int res)
+{
+	if (res == -2) return luaL_error (L, "unknown quantity");
+	if (res < 0) return luaL_error (L, "not a sequence of this vessel");
+	return (res ? lua_yield (L, 0) : 0);
+}
+
+static int dgWait (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	return seqwait (L, Sequencer::WaitTime (L, dg, luaL_optnumber (L, 2, 0.0)));
+}
+
+static int dgWaitDoor (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	const char *name = luaL_checkstring (L, 2);
+	bool open = (lua_isboolean (L, 3) ? lua_toboolean (L, 3) != 0 : lua_tonumber (L, 3) != 0.0);
+	int i;
+	for (i = 0; i < Scout::NACTUATOR; i++)
+		if (!strcmp (name, actname[i])) break;
+	if (i == Scout::NACTUATOR) return luaL_error (L, "unknown door: %s", name);
+	if (!dg) return seqwait (L, -1);
+	Scout::DoorStatus status = (open ? Scout::DOOR_OPEN : Scout::DOOR_CLOSED);
+	return seqwait (L, Sequencer::WaitDoor (L, dg, i, status, dg->act_status[i]));
+}
+
+static int dgWaitAbove (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	return seqwait (L, Sequencer::WaitLevel (L, dg, luaL_checkstring (L, 2), luaL_checknumber (L, 3), true));
+}
+
+static int dgWaitBelow (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	return seqwait (L, Sequencer::WaitLevel (L, dg, luaL_checkstring (L, 2), luaL_checknumber (L, 3), false));
+}
+
+// Snapshot into the vessel's rewind ring. Returns the number of
+// checkpoints held.
+static int dgCheckpoint (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	lua_pushnumber (L, dg ? dg->PushCheckpoint () : 0);
+	return 1;
+}
+
+// Return to the checkpoint n places before the newest (default 0)
+// and discard the newer ones
+static int dgRewind (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	int back = (int)luaL_optnumber (L, 2, 0);
+	lua_pushboolean (L, dg && back >= 0 && dg->Rewind (back));
+	return 1;
+}
+
+// Return a snapshot as a binary string, for scripts that keep
+// their own checkpoints
+static int dgSaveCheckpoint (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	if (!dg) return 0;
+	ScoutCheckpoint ck;
+	dg->SaveCheckpoint (ck);
+	lua_pushlstring (L, (const char*)&ck, sizeof(ScoutCheckpoint));
+	return 1;
+}
+
+// Return to a snapshot from dg:SaveCheckpoint. Returns false for
+// strings that aren't a valid snapshot of this module version.
+static int dgRestoreCheckpoint (lua_State *L)
+{
+	Scout *dg = lua_toDG (L, 1);
+	size_t len;
+	const char *blob = luaL_checklstring (L, 2, &len);
+	bool ok = false;
+	if (dg && len == sizeof(ScoutCheckpoint)) {
+		ScoutCheckpoint ck;
+		memcpy (&ck, blob, sizeof(ScoutCheckpoint)); // string data may be unaligned
+		ok = dg->RestoreCheckpoint (ck);
+	}
+	lua_pushboolean (L, ok);
+	return 1;
+}
+
+// Return the vessel state in a single table. The table is created
+// on the first call and refilled in place by later calls, so a
+// monitoring script doesn't generate garbage; scripts that need
+// to keep a snapshot must copy the values.
+// The table belongs to the vessel interface object (argument 1): it
+// is kept in a weak-keyed registry table and collected with the
+// interface, so it can't outlive the vessel or be picked up by a
+// vessel created later at the same address. Subtables that a
+// script removed or replaced are recreated.
+int Scout::Lua_GetState (void *context)
+{
+	lua_State *L = (lua_State*)context;
+	int i, j;
+
+	// registry["DG.state"]: interface -> state table, weak keys
+	lua_getfield (L, LUA_REGISTRYINDEX, "DG.state");
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_newtable (L);
+		lua_createtable (L, 0, 1);
+		lua_pushstring (L, "k");
+		lua_setfield (L, -2, "__mode");
+		lua_setmetatable (L, -2);
+		lua_pushvalue (L, -1);
+		lua_setfield (L, LUA_REGISTRYINDEX, "DG.state");
+	}
+	lua_pushvalue (L, 1);
+	lua_rawget (L, -2);
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_createtable (L, 0, 16);
+		lua_pushvalue (L, 1);
+		lua_pushvalue (L, -2);
+		lua_rawset (L, -4);
+	}
+	lua_remove (L, -2);
+
+	// actuators
+	double t = oapiGetSimTime();
+	subtable (L, "status", 0, NACTUATOR);
+	for (i = 0; i < NACTUATOR; i++)
+		setnumber (L, actname[i], act_status[i]);
+	lua_pop (L, 1);
+	subtable (L, "pos", 0, NACTUATOR);
+	for (i = 0; i < NACTUATOR; i++)
+		setnumber (L, actname[i], ActuatorProc ((Actuator)i, t));
+	lua_pop (L, 1);
+
+	// gimbal and hover balance settings
+	setarray (L, "mpgimbal", mpgimbalidx, 2);
+	setarray (L, "mygimbal", mygimbalidx, 2);
+	setarray (L, "scgimbal", scgimbalidx, 2);
+	setnumber (L, "hbalance", hbalanceidx);
+
+	// damage
+	setnumber (L, "lwing", lwingstatus);
+	setnumber (L, "rwing", rwingstatus);
+	setnumber (L, "hatchfail", hatchfail);
+	subtable (L, "aileronfail", 4, 0);
+	for (i = 0; i < 4; i++) {
+		lua_pushboolean (L, aileronfail[i]);
+		lua_rawseti (L, -2, i+1);
+	}
+	lua_pop (L, 1);
+
+	// fuel and scramjets
+	setnumber (L, "tankconfig", tankconfig);
+	if (scramjet) {
+		subtable (L, "scramtemp", 2, 0);
+		for (i = 0; i < 2; i++) {
+			lua_rawgeti (L, -1, i+1);
+			if (!lua_istable (L, -1)) {
+				lua_pop (L, 1);
+				lua_createtable (L, 3, 0);
+				lua_pushvalue (L, -1);
+				lua_rawseti (L, -3, i+1);
+			}
+			for (j = 0; j < 3; j++) {
+				lua_pushnumber (L, scramjet->Temp (i, j));
+				lua_rawseti (L, -2, j+1);
+			}
+			lua_pop (L, 1);
+		}
+		lua_pop (L, 1);
+		subtable (L, "scramflow", 2, 0);
+		for (i = 0; i < 2; i++) {
+			lua_pushnumber (L, scramjet->DMF (i));
+			lua_rawseti (L, -2, i+1);
+		}
+		lua_pop (L, 1);
+	}
+	return 1;
+}
+
+// Operate several actuators in one call, e.g.
+// dg:SetDoors{gear=1, nosecone=0, airbrake=true}
+// A value of true or nonzero opens, false or 0 closes.
+// Returns the number of actuators whose status changed. Commands
+// refused by an interlock don't count: the gear doesn't deploy
+// with ground contact, and the ladder only extends with the nose
+// cone fully open, so dg:SetDoors{nosecone=1, ladder=1} with the
+// nose cone closed moves only the nose cone.
+int Scout::Lua_SetDoors (void *context)
+{
+	lua_State *L = (lua_State*)context;
+	int i, n = 0;
+
+	if (!lua_istable (L, 2)) return 0;
+	for (i = 0; i < NACTUATOR; i++) {
+		lua_getfield (L, 2, actname[i]);
+		if (!lua_isnil (L, -1)) {
+			bool open = (lua_isboolean (L, -1) ? lua_toboolean (L, -1) != 0 : lua_tonumber (L, -1) != 0.0);
+			DoorStatus status = act_status[i];
+			(this->*actfunc[i])(open ? DOOR_OPENING : DOOR_CLOSING);
+			if (act_status[i] != status) n++;
+		}
+		lua_pop (L, 1);
+	}
+	lua_pushnumber (L, n);
+	return 1;
+}
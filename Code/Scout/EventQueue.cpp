@@ -0,0 +1,101 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// EventQueue.cpp
+// Time-ordered queue of pending events
+// ==============================================================
+
+#include "EventQueue.h"
+
+// constructor
+EventQueue::EventQueue (DWORD _nid): nid(_nid)
+{
+	n = 0;
+	heap = new DWORD[nid];
+	pos = new int[nid];
+	tev = new double[nid];
+	for (DWORD i = 0; i < nid; i++) {
+		pos[i] = -1;
+		tev[i] = 0.0;
+	}
+}
+
+// destructor
+EventQueue::~EventQueue ()
+{
+	delete []heap;
+	delete []pos;
+	delete []tev;
+}
+
+// (re)schedule an event
+void EventQueue::Schedule (DWORD id, double t)
+{
+	if (pos[id] < 0) {
+		heap[n] = id;
+		pos[id] = n++;
+		tev[id] = t;
+		Up (pos[id]);
+	} else {
+		double t0 = tev[id];
+		tev[id] = t;
+		if (t < t0) Up (pos[id]);
+		else        Down (pos[id]);
+	}
+}
+
+// remove an event
+void EventQueue::Cancel (DWORD id)
+{
+	if (pos[id] < 0) return;
+	DWORD k = pos[id];
+	Swap (k, --n);
+	pos[id] = -1;
+	if (k < n) {
+		Up (k);
+		Down (k);
+	}
+}
+
+// pop the earliest event if it is due
+bool EventQueue::Next (double t, DWORD &id)
+{
+	if (!n || tev[heap[0]] > t) return false;
+	id = heap[0];
+	Cancel (id);
+	return true;
+}
+
+void EventQueue::Swap (DWORD i, DWORD j)
+{
+	DWORD tmp = heap[i];
+	heap[i] = heap[j];
+	heap[j] = tmp;
+	pos[heap[i]] = i;
+	pos[heap[j]] = j;
+}
+
+void EventQueue::Up (DWORD k)
+{
+	while (k) {
+		DWORD parent = (k-1)/2;
+		if (tev[heap[parent]] <= tev[heap[k]]) break;
+		Swap (k, parent);
+		k = parent;
+	}
+}
+
+void EventQueue::Down (DWORD k)
+{
+	for (;;) {
+		DWORD c = 2*k+1;
+		if (c >= n) break;
+		if (c+1 < n && tev[heap[c+1]] < tev[heap[c]]) c++;
+		if (tev[heap[k]] <= tev[heap[c]]) break;
+		Swap (k, c);
+		k = c;
+	}
+}
@@ -0,0 +1,62 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// EventQueue.h
+// Time-ordered queue of pending events
+//
+// Notes:
+// Events are identified by a small integer id (0 <= id < nid),
+// and each id is scheduled at most once. The queue is a binary
+// min-heap keyed on simulation time, with a position index per id
+// so that an event can be moved or cancelled in O(log n).
+// Polling for due events costs a single comparison while nothing
+// is due, regardless of how far in the future the events are.
+// ==============================================================
+
+#ifndef __EVENTQUEUE_H
+#define __EVENTQUEUE_H
+
+#include "Orbitersdk.h"
+
+class EventQueue {
+public:
+	EventQueue (DWORD _nid);
+	// constructor: queue for event ids 0 ... _nid-1
+
+	~EventQueue ();
+	// destructor
+
+	void Schedule (DWORD id, double t);
+	// Schedule event id at time t. If id is already pending, it is
+	// moved to the new time.
+
+	void Cancel (DWORD id);
+	// Remove event id from the queue (no-op if not pending)
+
+	inline bool Pending (DWORD id) const { return pos[id] >= 0; }
+	// event id is in the queue?
+
+	inline DWORD nPending () const { return n; }
+	// number of pending events
+
+	bool Next (double t, DWORD &id);
+	// If the earliest pending event is due at or before t, remove it
+	// from the queue, return its id in id and return true.
+	// Otherwise return false.
+
+private:
+	void Swap (DWORD i, DWORD j);
+	void Up (DWORD k);
+	void Down (DWORD k);
+
+	DWORD nid;                 // number of event ids
+	DWORD n;                   // number of pending events
+	DWORD *heap;               // heap of pending event ids
+	int *pos;                  // heap position of each id (-1: not pending)
+	double *tev;               // event time of each id
+};
+
+#endif // !__EVENTQUEUE_H
@@ -0,0 +1,251 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Fleet.cpp
+// Batched, multi-threaded post-step computations for all Scouts
+// ==============================================================
+
+#include "Fleet.h"
+#include "Scout.h"
+#include "Ramjet.h"
+#include "StepProfile.h"
+#include <string.h>
+
+bool Fleet::enabled = false;
+Scout **Fleet::vessel = NULL;
+BYTE *Fleet::res = NULL;
+double *Fleet::fld[NFIELD];
+double *Fleet::buf = NULL;
+int Fleet::nvessel = 0;
+int Fleet::nbuf = 0;
+double Fleet::tbatch = -1e10;
+double Fleet::dt = 0.0;
+int Fleet::nthread = 0;
+HANDLE Fleet::hThread[FLEET_MAXTHREAD];
+HANDLE Fleet::hGo = NULL;
+HANDLE Fleet::hDone = NULL;
+volatile LONG Fleet::nextchunk = 0;
+volatile LONG Fleet::nbusy = 0;
+int Fleet::nchunk = 0;
+bool Fleet::quit = false;
+
+// ==============================================================
+
+void Fleet::Enable (int n)
+{
+	if (enabled) return;
+
+	// workers beyond one per core minus one would only share the
+	// main thread's core, and without workers the batch is slower
+	// than the per-vessel path (see Notes in Fleet.h)
+	SYSTEM_INFO si;
+	GetSystemInfo (&si);
+	int nmax = (int)si.dwNumberOfProcessors - 1;
+	if (n < 0 || n > nmax) n = nmax;
+	if (n > FLEET_MAXTHREAD) n = FLEET_MAXTHREAD;
+	if (n <= 0) return; // stay off
+	enabled = true;
+
+	hGo = CreateSemaphore (NULL, 0, n, NULL);
+	hDone = CreateEvent (NULL, FALSE, FALSE, NULL);
+	quit = false;
+	for (nthread = 0; nthread < n; nthread++) {
+		DWORD tid;
+		if (!(hThread[nthread] = CreateThread (NULL, 0, Worker, NULL, 0, &tid))) break;
+	}
+}
+
+// ==============================================================
+
+void Fleet::Exit ()
+{
+	if (nthread) {
+		quit = true;
+		ReleaseSemaphore (hGo, nthread, NULL);
+		WaitForMultipleObjects (nthread, hThread, TRUE, INFINITE);
+		for (int i = 0; i < nthread; i++)
+			CloseHandle (hThread[i]);
+		nthread = 0;
+	}
+	if (hGo)   { CloseHandle (hGo);   hGo = NULL; }
+	if (hDone) { CloseHandle (hDone); hDone = NULL; }
+	if (nbuf) {
+		delete []vessel;
+		delete []res;
+		delete []buf;
+	}
+	vessel = NULL;
+	res = NULL;
+	buf = NULL;
+	nvessel = nbuf = 0;
+	enabled = false;
+}
+
+// ==============================================================
+
+void Fleet::Grow ()
+{
+	int i, n = nbuf + 16;
+	Scout **tmp_v = new Scout*[n];
+	BYTE *tmp_r = new BYTE[n];
+	double *tmp = new double[n*NFIELD];
+	memset (tmp, 0, n*NFIELD*sizeof(double));
+	for (i = 0; i < NFIELD; i++) {
+		if (nvessel) memcpy (tmp+i*n, fld[i], nvessel*sizeof(double));
+		fld[i] = tmp+i*n;
+	}
+	if (nbuf) {
+		memcpy (tmp_v, vessel, nvessel*sizeof(Scout*));
+		memcpy (tmp_r, res, nvessel);
+		delete []vessel;
+		delete []res;
+		delete []buf;
+	}
+	vessel = tmp_v;
+	res = tmp_r;
+	buf = tmp;
+	nbuf = n;
+}
+
+// ==============================================================
+
+void Fleet::Attach (Scout *v)
+{
+	if (v->fleetidx >= 0) return;
+	if (nvessel == nbuf) Grow ();
+	vessel[nvessel] = v;
+	res[nvessel] = RES_NONE; // not part of a batch yet
+	v->fleetidx = nvessel++;
+}
+
+// ==============================================================
+
+void Fleet::Detach (Scout *v)
+{
+	int i = v->fleetidx;
+	if (i < 0) return;
+	if (i < --nvessel) { // move the last vessel into the gap
+		vessel[i] = vessel[nvessel];
+		res[i] = res[nvessel];
+		for (int k = 0; k < NFIELD; k++)
+			fld[k][i] = fld[k][nvessel];
+		vessel[i]->fleetidx = i;
+	}
+	v->fleetidx = -1;
+}
+
+// ==============================================================
+
+bool Fleet::Step (Scout *v, double simt)
+{
+	if (v->fleetidx < 0) return false;
+	if (simt != tbatch) {
+		tbatch = simt;
+		Run ();
+	}
+	return (res[v->fleetidx] != RES_NONE);
+}
+
+// ==============================================================
+// Gather the inputs of all vessels, then compute
+
+void Fleet::Run ()
+{
+	int i;
+	PROFILE_BEGIN (FLEETBATCH);
+
+	dt = oapiGetSimStep();
+	for (i = 0; i < nvessel; i++) {
+		Scout *v = vessel[i];
+		if (v->scramjet) {
+			fld[F_LVL0][i] = v->GetThrusterLevel (v->th_scram[0]);
+			fld[F_LVL1][i] = v->GetThrusterLevel (v->th_scram[1]);
+			v->scramjet->Prepare (v->fs.atm);
+		}
+	}
+
+	nchunk = (nvessel + FLEET_CHUNK-1) / FLEET_CHUNK;
+	nextchunk = 0;
+	if (nthread && nchunk > 1) {
+		nbusy = nthread;
+		ReleaseSemaphore (hGo, nthread, NULL);
+		Work ();
+		WaitForSingleObject (hDone, INFINITE);
+	} else {
+		Work ();
+	}
+	PROFILE_END (FLEETBATCH);
+}
+
+// ==============================================================
+// Process chunks until none are left (main thread and workers)
+
+void Fleet::Work ()
+{
+	LONG k;
+	while ((k = InterlockedIncrement (&nextchunk) - 1) < nchunk) {
+		int i1 = (k+1)*FLEET_CHUNK;
+		if (i1 > nvessel) i1 = nvessel;
+		for (int i = k*FLEET_CHUNK; i < i1; i++)
+			Compute (i);
+	}
+}
+
+// ==============================================================
+
+DWORD WINAPI Fleet::Worker (LPVOID)
+{
+	for (;;) {
+		WaitForSingleObject (hGo, INFINITE);
+		if (quit) return 0;
+		Work ();
+		if (!InterlockedDecrement (&nbusy))
+			SetEvent (hDone);
+	}
+}
+
+// ==============================================================
+// Pure computations for vessel i. No Orbiter API calls, and only
+// data owned by the vessel are written.
+
+void Fleet::Compute (int i)
+{
+	Scout *v = vessel[i];
+	res[i] = RES_KEEP;
+	if (v->scramjet) {
+		double lvl[2] = {fld[F_LVL0][i], fld[F_LVL1][i]}, Fmax[2], isp[2];
+		if (v->ScramjetSolve (lvl, Fmax, isp)) {
+			fld[F_FMAX0][i] = Fmax[0]; fld[F_FMAX1][i] = Fmax[1];
+			fld[F_ISP0][i]  = isp[0];  fld[F_ISP1][i]  = isp[1];
+			res[i] = RES_NEW;
+		}
+	}
+	if (v->bDamageEnabled)
+		v->DamageHazard (dt, fld[F_ALPHA][i], fld[F_PWING][i], fld[F_PHATCH][i]);
+}
+
+// ==============================================================
+
+void Fleet::ApplyScramjet (Scout *v)
+{
+	int i = v->fleetidx;
+	if (res[i] == RES_NEW) {
+		double Fmax[2] = {fld[F_FMAX0][i], fld[F_FMAX1][i]};
+		double isp[2]  = {fld[F_ISP0][i],  fld[F_ISP1][i]};
+		v->ScramjetApply (Fmax, isp);
+		PROFILE_COUNT (SCRAMMEMO_MISS);
+	} else {
+		PROFILE_COUNT (SCRAMMEMO_HIT);
+	}
+}
+
+// ==============================================================
+
+void Fleet::ApplyDamage (Scout *v)
+{
+	int i = v->fleetidx;
+	v->DamageApply (fld[F_ALPHA][i], fld[F_PWING][i], fld[F_PHATCH][i]);
+}
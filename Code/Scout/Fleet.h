@@ -0,0 +1,113 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Fleet.h
+// Batched, multi-threaded post-step computations for all Scouts
+//
+// Notes:
+// * Optional, enabled with FLEET_THREADS in the class cfg (number
+//   of worker threads, -1: one per core minus one, 0 or missing:
+//   off). Without it every Scout does its own calculations in its
+//   clbkPostStep, as before. The number of workers is limited to
+//   one per core minus one, and on a single core the batch stays
+//   off.
+// * Break-even: only measured on a single core so far ('ScoutHost
+//   -mode fleet', ns per vessel step in scramjet cruise). There the
+//   batch without workers was about 8% slower than the per-vessel
+//   path (64 vessels: 228 vs 210 ns), and 1, 2 and 4 workers took
+//   360, 430 and 550 ns at 64 vessels, 20-55% more than the
+//   per-vessel path at 256. Workers can only pay off on more cores,
+//   with enough vessels to make the batch time exceed the wake-up
+//   cost (more than one FLEET_CHUNK). Run the fleet mode on the
+//   target machine before enabling it.
+// * The first Scout whose clbkPostStep is called in a frame runs
+//   the batch for all Scouts. The inputs (throttle levels, the
+//   frame state sampled in clbkPreStep) are gathered into one
+//   array per quantity on the main thread. The pure computations
+//   (scramjet thrust with its reuse memo, damage hazard rates) are
+//   then split into chunks, which are shared by the worker threads
+//   and the main thread. Each Scout's own clbkPostStep then only
+//   applies its results through the Orbiter API.
+// * Orbiter API calls stay on the main thread. Throttle levels are
+//   sampled at the start of the post-step pass, so a level changed
+//   later in the same pass takes effect in the next frame.
+// ==============================================================
+
+#ifndef __FLEET_H
+#define __FLEET_H
+
+#include "Orbitersdk.h"
+
+class Scout;
+
+const int FLEET_CHUNK = 16;
+// vessels per work unit
+
+const int FLEET_MAXTHREAD = 16;
+// max. number of worker threads
+
+class Fleet {
+public:
+	static void Enable (int nthread);
+	// Enable batching with nthread worker threads (-1: automatic),
+	// limited to one per core minus one. Stays off if that leaves
+	// no workers.
+
+	static inline bool Enabled () { return enabled; }
+	// batching enabled?
+
+	static void Attach (Scout *v);
+	static void Detach (Scout *v);
+	// Add/remove a vessel. Detach may be called for vessels that
+	// aren't attached.
+
+	static bool Step (Scout *v, double simt);
+	// Run the batch if this is the first call in the frame. Returns
+	// true if the results for v are available.
+
+	static void ApplyScramjet (Scout *v);
+	static void ApplyDamage (Scout *v);
+	// Apply the batch results of v. Main thread, after Step.
+
+	static void Exit ();
+	// Stop the worker threads
+
+private:
+	enum {                         // per-vessel fields, one array each
+		F_LVL0, F_LVL1,            // scramjet throttle levels
+		F_FMAX0, F_FMAX1,          // scramjet max. thrust [N]
+		F_ISP0, F_ISP1,            // scramjet Isp [m/s]
+		F_ALPHA, F_PWING, F_PHATCH, // damage hazard rate and failure probabilities
+		NFIELD
+	};
+	enum { RES_NONE, RES_KEEP, RES_NEW }; // batch result of a vessel
+
+	static void Grow ();
+	static void Run ();
+	static void Compute (int i);
+	static void Work ();
+	static DWORD WINAPI Worker (LPVOID);
+
+	static bool enabled;           // batching enabled?
+	static Scout **vessel;         // attached vessels
+	static BYTE *res;              // RES_xxx per vessel
+	static double *fld[NFIELD];    // per-vessel fields
+	static double *buf;            // storage for all fields
+	static int nvessel, nbuf;      // number of vessels, allocated size
+	static double tbatch;          // sim time of the last batch
+	static double dt;              // time step of the last batch
+
+	static int nthread;            // number of worker threads
+	static HANDLE hThread[FLEET_MAXTHREAD];
+	static HANDLE hGo;             // semaphore: one count per worker and batch
+	static HANDLE hDone;           // signalled by the last worker to finish
+	static volatile LONG nextchunk; // next unprocessed chunk
+	static volatile LONG nbusy;    // workers still running in this batch
+	static int nchunk;             // chunks in this batch
+	static bool quit;              // workers should exit
+};
+
+#endif // !__FLEET_H
@@ -0,0 +1,125 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// HUDOverlay.cpp
+// Registry of textured HUD annunciators rendered in one batch
+// ==============================================================
+
+#include "HUDOverlay.h"
+#include <math.h>
+#include <string.h>
+
+// constructor
+HUDOverlay::HUDOverlay (VESSEL *_vessel, float _texw, float _texh)
+: vessel(_vessel), texw(_texw), texh(_texh)
+{
+	nelem = nvtx = nidx = 0;
+	hMesh = NULL;
+	scl = 0.0f;
+	cx = cy = 0;
+	mask = 0;
+	maskvalid = false;
+}
+
+// destructor
+HUDOverlay::~HUDOverlay ()
+{
+	if (hMesh) oapiDeleteMesh (hMesh);
+}
+
+// register an element
+bool HUDOverlay::AddElement (const HUDELEMENTSPEC *spec)
+{
+	if (nelem == HUDOVERLAY_MAXELEM) return false;
+	elem[nelem] = spec;
+	vofs[nelem] = (WORD)nvtx;
+	nelem++;
+	nvtx += spec->nvtx;
+	nidx += spec->nidx;
+	if (hMesh) {
+		oapiDeleteMesh (hMesh);
+		hMesh = NULL;
+	}
+	return true;
+}
+
+// compile the geometry of all elements into one mesh group
+void HUDOverlay::Build (const HUDPAINTSPEC *hps)
+{
+	DWORD i, j, n;
+	NTVERTEX *vtx = new NTVERTEX[nvtx];
+	WORD *idx = new WORD[nidx];
+	scl = hps->Markersize*0.25f;
+	cx = hps->CX, cy = hps->CY;
+
+	memset (vtx, 0, nvtx*sizeof(NTVERTEX));
+	for (i = n = 0; i < nelem; i++) {
+		const HUDELEMENTSPEC *e = elem[i];
+		NTVERTEX *v = vtx+vofs[i];
+		float s = scl*e->scale;
+		for (j = 0; j < e->nvtx; j++) {
+			v[j].x  = cx + e->x[j]*s;
+			v[j].y  = cy + e->y[j]*s;
+			v[j].tu = e->u[j]/texw;
+			v[j].tv = e->v[j]/texh;
+		}
+		// full index list, so that the group has room for all elements
+		for (j = 0; j < e->nidx; j++)
+			idx[n++] = e->idx[j] + vofs[i];
+	}
+
+	if (hMesh) oapiDeleteMesh (hMesh);
+	MESHGROUP grp;
+	memset (&grp, 0, sizeof(MESHGROUP));
+	grp.Vtx  = vtx;
+	grp.Idx  = idx;
+	grp.nVtx = nvtx;
+	grp.nIdx = nidx;
+	hMesh = oapiCreateMesh (1, &grp);
+	maskvalid = false; // index list doesn't match any element set yet
+	delete []vtx;
+	delete []idx;
+}
+
+// draw the visible elements
+bool HUDOverlay::Render (const HUDPAINTSPEC *hps, SURFHANDLE hTex, double simt)
+{
+	DWORD i, j, m = 0;
+	double di;
+
+	if (!nelem) return false;
+	for (i = 0; i < nelem; i++) {
+		switch (elem[i]->state (vessel)) {
+		case HUDELEM_ON:
+			m |= 1u << i;
+			break;
+		case HUDELEM_BLINK:
+			if (modf (simt*elem[i]->blinkrate, &di) < 0.5) m |= 1u << i;
+			break;
+		}
+	}
+	if (!m) return false;
+
+	if (!hMesh || scl != hps->Markersize*0.25f || cx != hps->CX || cy != hps->CY)
+		Build (hps); // layout change
+
+	if (!maskvalid || m != mask) { // rewrite the index list in place
+		MESHGROUP *grp = oapiMeshGroup (hMesh, 0);
+		DWORD n = 0;
+		for (i = 0; i < nelem; i++)
+			if (m & (1u << i)) {
+				const HUDELEMENTSPEC *e = elem[i];
+				for (j = 0; j < e->nidx; j++)
+					grp->Idx[n++] = e->idx[j] + vofs[i];
+			}
+		grp->nIdx = n;
+		mask = m;
+		maskvalid = true;
+	}
+
+	oapiRenderHUD (hMesh, &hTex);
+	return true;
+}
@@ -0,0 +1,78 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// HUDOverlay.h
+// Registry of textured HUD annunciators rendered in one batch
+//
+// Notes:
+// * Each element is described by a static HUDELEMENTSPEC: its
+//   geometry and texture coordinates in the HUD texture, and a
+//   state function deciding whether it is off, on or blinking.
+// * The geometry of all registered elements is compiled into a
+//   single mesh group, which is rebuilt only when the HUD layout
+//   (marker size or centre) changes. Per frame, the state functions
+//   are evaluated and, if the set of visible elements has changed,
+//   the group's index list is rewritten in place. All visible
+//   elements are drawn with a single oapiRenderHUD call.
+// * Up to HUDOVERLAY_MAXELEM elements can be registered.
+// ==============================================================
+
+#ifndef __HUDOVERLAY_H
+#define __HUDOVERLAY_H
+
+#include "Orbitersdk.h"
+
+const DWORD HUDOVERLAY_MAXELEM = 32;
+// max. number of elements per overlay (bits in the visibility mask)
+
+enum { HUDELEM_OFF, HUDELEM_ON, HUDELEM_BLINK };
+// element states returned by HUDELEMENTSPEC::state
+
+typedef struct {
+	DWORD nvtx;             // number of vertices
+	DWORD nidx;             // number of indices
+	const float *x, *y;     // vertex positions relative to the HUD centre [Markersize/4]
+	float scale;            // additional scale factor for x and y
+	const float *u, *v;     // texture coordinates [texels]
+	const WORD *idx;        // triangle indices (0 ... nvtx-1)
+	int (*state)(VESSEL *v);// element state (HUDELEM_OFF/ON/BLINK)
+	double blinkrate;       // blink frequency in state HUDELEM_BLINK [Hz]
+} HUDELEMENTSPEC;
+
+class HUDOverlay {
+public:
+	HUDOverlay (VESSEL *_vessel, float _texw, float _texh);
+	// constructor: overlay for a HUD texture of size _texw x _texh
+
+	~HUDOverlay ();
+	// destructor
+
+	bool AddElement (const HUDELEMENTSPEC *spec);
+	// Register an element. spec is not copied and must remain valid
+	// for the lifetime of the overlay. Returns false if the overlay
+	// is full.
+
+	bool Render (const HUDPAINTSPEC *hps, SURFHANDLE hTex, double simt);
+	// Draw all visible elements. Call from clbkRenderHUD.
+	// Returns true if anything was drawn.
+
+private:
+	void Build (const HUDPAINTSPEC *hps);
+
+	VESSEL *vessel;           // vessel pointer
+	float texw, texh;         // HUD texture size
+	const HUDELEMENTSPEC *elem[HUDOVERLAY_MAXELEM]; // registered elements
+	WORD vofs[HUDOVERLAY_MAXELEM]; // first vertex of each element in the group
+	DWORD nelem;              // number of elements
+	DWORD nvtx, nidx;         // total vertex and index count
+	MESHHANDLE hMesh;         // compiled overlay (NULL: needs rebuild)
+	float scl;                // layout: marker scale
+	int cx, cy;               // layout: HUD centre
+	DWORD mask;               // elements in the current index list
+	bool maskvalid;           // false: index list must be rewritten
+};
+
+#endif // !__HUDOVERLAY_H
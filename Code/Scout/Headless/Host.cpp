@@ -0,0 +1,315 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Host.cpp
+// Headless host: drive the Scout time step callbacks without the
+// simulator and report their cost
+//
+// Usage:
+//   ScoutHost [-mode name] [-n vessels] [-steps n] [-dt s] [-alt m]
+//             [-speed m/s] [-cfg file] [-set ITEM=value] [-scn file]
+//             [-top k]
+//
+//   -mode selects what to run (see the mode table below; default:
+//   step, the time step callbacks).
+//   -cfg reads the class configuration (items as in Scout.cfg),
+//   -set adds single items to it (e.g. -set SCRAMJET=TRUE,
+//   -set FLEET_THREADS=4). -scn loads a scenario block (the vessel
+//   lines up to END) into every vessel.
+//
+// Notes:
+// * Per vessel: ovcInit, clbkSetClassCaps, clbkLoadStateEx (with
+//   -scn) and clbkPostCreation. In step mode each frame then calls
+//   clbkPreStep for all vessels, burns propellant, and calls
+//   clbkPostStep for all vessels, as Orbiter does.
+// * ns/step is the wall time of both callbacks per vessel, which
+//   includes the (small) cost of the stub API.
+// * allocs/step counts operator new calls from inside the
+//   callbacks. SDK calls/step counts calls into the stub API, with
+//   a breakdown of the most frequent functions.
+// ==============================================================
+
+#include "Host.h"
+#include <malloc.h>
+
+DLLCLBK void InitModule (HINSTANCE hModule);
+DLLCLBK void ExitModule (HINSTANCE hModule);
+DLLCLBK VESSEL *ovcInit (OBJHANDLE hvessel, int flightmodel);
+DLLCLBK void ovcExit (VESSEL *vessel);
+
+// ==============================================================
+// Host modes
+
+static const struct {
+	const char *name;
+	HostMode run;
+	const char *desc;
+} mode[] = {
+	{"step", ModeStep, "time step callbacks"},
+	{"ramjet", ModeRamjet, "check and time Ramjet::Thrust against the original version"},
+	{"ramjettable", ModeRamjetTable, "check the ramjet inlet table against the analytic thrust"},
+	{"cruise", ModeCruise, "scramjet cruise step time with and without the thrust memo"},
+	{"airfoil", ModeAirfoil, "latency of the airfoil callbacks, original and configured"},
+	{"spawn", ModeSpawn, "time, memory and script interpreters for creating vessels"},
+	{"monitor", ModeMonitor, "cost of a 10 Hz dg:GetState monitor"},
+	{"parse", ModeParse, "check the scenario number parser and formatter, time scenario loading"},
+	{"skin", ModeSkin, "load time of skinned vessels with a cold file cache"},
+	{"autosave", ModeAutosave, "time to save the state of idle vessels"},
+	{"memory", ModeMemory, "heap memory per vessel"},
+	{"fleet", ModeFleet, "step time with the fleet batch against vessel and thread count"},
+};
+
+const int NMODE = sizeof(mode)/sizeof(mode[0]);
+
+// ==============================================================
+// Allocation counter
+
+static volatile bool counting = false;
+static volatile unsigned long long nalloc = 0;
+
+void *operator new (size_t size)
+{
+	if (counting) __sync_fetch_and_add (&nalloc, 1);
+	void *p = malloc (size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[] (size_t size)
+{
+	if (counting) __sync_fetch_and_add (&nalloc, 1);
+	void *p = malloc (size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete (void *p) noexcept { free (p); }
+void operator delete[] (void *p) noexcept { free (p); }
+void operator delete (void *p, size_t) noexcept { free (p); }
+void operator delete[] (void *p, size_t) noexcept { free (p); }
+
+void HostCountAllocs (bool count)
+{
+	counting = count;
+}
+
+unsigned long long HostAllocs ()
+{
+	return nalloc;
+}
+
+size_t HostHeap ()
+{
+	return mallinfo2 ().uordblks;
+}
+
+// ==============================================================
+
+double HostNow ()
+{
+	LARGE_INTEGER t;
+	QueryPerformanceCounter (&t);
+	return t.QuadPart*1e-9;
+}
+
+// ==============================================================
+// Vessels
+
+VESSEL2 *HostCreate (const HostOptions &opt, int idx, FILEHANDLE scn)
+{
+	char name[32];
+	sprintf (name, "Scout-%d", idx+1);
+	VESSELSTUB *stub = new VESSELSTUB;
+	stub->name = name;
+	stub->classname = "Scout";
+	stub->emptymass = 0.0;
+	memset (stub->ctrlsurf, 0, sizeof(stub->ctrlsurf));
+	memset (stub->wbrake, 0, sizeof(stub->wbrake));
+	stub->navmode = 0;
+	stub->attmode = RCS_ROT;
+	stub->adcmode = 1;
+	stub->nmesh = 0;
+	VESSEL2 *v = (VESSEL2*)ovcInit (stub, 1);
+	StubRewind (opt.cfg);
+	v->clbkSetClassCaps (opt.cfg);
+	if (scn) {
+		VESSELSTATUS2 vs;
+		memset (&vs, 0, sizeof(vs));
+		vs.version = 2;
+		StubRewind (scn);
+		v->clbkLoadStateEx (scn, &vs);
+	}
+	v->clbkPostCreation ();
+	return v;
+}
+
+void HostDelete (VESSEL2 *v)
+{
+	VESSELSTUB *stub = (VESSELSTUB*)v->GetHandle ();
+	ovcExit (v);
+	delete stub;
+}
+
+double HostStep (const std::vector<VESSEL2*> &v, double dt)
+{
+	size_t j, n = v.size();
+	g_World.simt += dt;
+	g_World.systime += dt;
+	g_World.mjd += dt/86400.0;
+	double t0 = HostNow ();
+	counting = true;
+	for (j = 0; j < n; j++)
+		v[j]->clbkPreStep (g_World.simt, dt, g_World.mjd);
+	counting = false;
+	double t1 = HostNow ();
+	for (j = 0; j < n; j++)
+		StubAdvance ((VESSELSTUB*)v[j]->GetHandle (), dt);
+	double t2 = HostNow ();
+	counting = true;
+	for (j = 0; j < n; j++)
+		v[j]->clbkPostStep (g_World.simt, dt, g_World.mjd);
+	counting = false;
+	return (t1-t0) + (HostNow ()-t2);
+}
+
+// ==============================================================
+// Step mode
+
+struct CallCount {
+	const char *name;
+	unsigned long long n;
+	bool operator< (const CallCount &c) const { return n > c.n; }
+};
+
+int ModeStep (const HostOptions &opt)
+{
+	int i;
+	std::vector<VESSEL2*> v (opt.nvessel);
+	for (i = 0; i < opt.nvessel; i++)
+		v[i] = HostCreate (opt, i, opt.scn);
+
+	// snapshot of the call counters after setup
+	std::vector<CallCount> base;
+	for (SdkCounter *c = SdkCounter::First (); c; c = c->next) {
+		CallCount cc = {c->name, c->n};
+		base.push_back (cc);
+	}
+	unsigned long long nalloc0 = nalloc;
+
+	// time step loop
+	double tcb = 0.0;
+	for (long s = 0; s < opt.nstep; s++)
+		tcb += HostStep (v, opt.dt);
+
+	// report
+	double nvstep = (double)opt.nstep*opt.nvessel;
+	std::vector<CallCount> calls;
+	unsigned long long nsdk = 0;
+	for (SdkCounter *c = SdkCounter::First (); c; c = c->next) {
+		unsigned long long n0 = 0;
+		for (size_t k = 0; k < base.size(); k++)
+			if (base[k].name == c->name) { n0 = base[k].n; break; }
+		CallCount cc = {c->name, c->n - n0};
+		if (cc.n) calls.push_back (cc);
+		nsdk += cc.n;
+	}
+	std::sort (calls.begin(), calls.end());
+	printf ("%d vessel(s), %ld steps of %g s, altitude %g m, airspeed %g m/s\n",
+		opt.nvessel, opt.nstep, opt.dt, opt.alt, opt.speed);
+	printf ("%0.1f ns/step, %0.3f allocs/step, %0.2f SDK calls/step\n",
+		tcb/nvstep*1e9, (nalloc-nalloc0)/nvstep, nsdk/nvstep);
+	for (i = 0; i < (int)calls.size() && i < opt.top; i++)
+		printf ("  %8.3f  %s\n", calls[i].n/nvstep, calls[i].name);
+
+	for (i = 0; i < opt.nvessel; i++)
+		HostDelete (v[i]);
+	return 0;
+}
+
+// ==============================================================
+
+static void Usage ()
+{
+	fprintf (stderr, "usage: ScoutHost [-mode name] [-n vessels] [-steps n] [-dt s] [-alt m]\n"
+		"                 [-speed m/s] [-cfg file] [-set ITEM=value] [-scn file] [-top k]\n"
+		"modes:\n");
+	for (int i = 0; i < NMODE; i++)
+		fprintf (stderr, "  %-12s %s\n", mode[i].name, mode[i].desc);
+	exit (1);
+}
+
+int main (int argc, char *argv[])
+{
+	int i, m = 0;
+	const char *scnfile = NULL;
+	static char earth;
+	HostOptions opt;
+
+	opt.nvessel = 1;
+	opt.nstep = 1000000;
+	opt.dt = 0.02;
+	opt.alt = 5000.0;
+	opt.speed = 200.0;
+	opt.top = 10;
+	opt.cfg = StubNewFile ();
+	opt.scn = NULL;
+	for (i = 1; i < argc; i++) {
+		const char *o = argv[i];
+		if (i+1 >= argc) Usage ();
+		const char *arg = argv[++i];
+		if      (!strcmp (o, "-n"))     opt.nvessel = atoi (arg);
+		else if (!strcmp (o, "-steps")) opt.nstep = atol (arg);
+		else if (!strcmp (o, "-dt"))    opt.dt = atof (arg);
+		else if (!strcmp (o, "-alt"))   opt.alt = atof (arg);
+		else if (!strcmp (o, "-speed")) opt.speed = atof (arg);
+		else if (!strcmp (o, "-scn"))   scnfile = arg;
+		else if (!strcmp (o, "-top"))   opt.top = atoi (arg);
+		else if (!strcmp (o, "-mode")) {
+			for (m = 0; m < NMODE; m++)
+				if (!strcmp (arg, mode[m].name)) break;
+			if (m == NMODE) Usage ();
+		} else if (!strcmp (o, "-set")) {
+			std::string item (arg);
+			size_t eq = item.find ('=');
+			if (eq == std::string::npos) Usage ();
+			item = item.substr (0, eq) + " = " + item.substr (eq+1);
+			StubAddLine (opt.cfg, item.c_str());
+		} else if (!strcmp (o, "-cfg")) {
+			FILEHANDLE f = StubOpenFile (arg);
+			if (!f) { fprintf (stderr, "ScoutHost: can't open %s\n", arg); return 1; }
+			StubCloseFile (opt.cfg);
+			opt.cfg = f;
+		} else Usage ();
+	}
+	if (opt.nvessel < 1 || opt.nstep < 1 || !(opt.dt > 0.0)) Usage ();
+	if (scnfile && !(opt.scn = StubOpenFile (scnfile))) {
+		fprintf (stderr, "ScoutHost: can't open %s\n", scnfile);
+		return 1;
+	}
+
+	// flight state: Earth atmosphere, level flight
+	memset (&g_World, 0, sizeof(StubWorld));
+	g_World.hPlanet = &earth;
+	g_World.atm.cp = 1004.5;
+	g_World.atm.cv = 717.5;
+	g_World.atm.gamma = 1.4;
+	g_World.atm.R = 287.05;
+	g_World.atm.p0 = 101325.0;
+	g_World.atm.rho0 = 1.225;
+	g_World.atm.altlimit = 2.5e5;
+	g_World.atm.horizonalt = 2.5e5;
+	g_World.mjd = 51982.0;
+	g_World.simdt = opt.dt;
+	g_World.aoa = 2.0*RAD;
+	StubSetAltitude (opt.alt, opt.speed);
+
+	InitModule (NULL);
+	int res = mode[m].run (opt);
+	ExitModule (NULL);
+	if (opt.scn) StubCloseFile (opt.scn);
+	StubCloseFile (opt.cfg);
+	return res;
+}
@@ -0,0 +1,106 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Host.h
+// Headless host: vessel setup, timing and counters shared by the
+// host modes
+//
+// Notes:
+// * A host mode is a function that takes the command line options
+//   and returns the exit code of the host (non-zero: a check
+//   failed). Modes are registered in the table in Host.cpp.
+// * HostHeap is the number of bytes allocated from the heap and
+//   not yet freed, by any allocator (malloc or operator new).
+// ==============================================================
+
+#ifndef __HOST_H
+#define __HOST_H
+
+#include "SdkStub.h"
+
+// ==============================================================
+// Command line options
+
+struct HostOptions {
+	int nvessel;            // number of vessels
+	long nstep;             // number of time steps (or repetitions)
+	double dt;              // time step [s]
+	double alt, speed;      // altitude [m], airspeed [m/s]
+	int top;                // number of SDK functions in the call breakdown
+	FILEHANDLE cfg;         // class configuration
+	FILEHANDLE scn;         // scenario block for every vessel (or NULL)
+};
+
+typedef int (*HostMode)(const HostOptions &opt);
+
+int ModeStep (const HostOptions &opt);
+// Time step callbacks (default mode)
+
+int ModeRamjet (const HostOptions &opt);
+// Check Ramjet::Thrust against Thrust_ref and time both
+
+int ModeRamjetTable (const HostOptions &opt);
+// Check the tabulated ramjet inlet terms against the analytic ones
+
+int ModeCruise (const HostOptions &opt);
+// Scramjet cruise step time with and without the thrust memo
+
+int ModeAirfoil (const HostOptions &opt);
+// Latency of the airfoil callbacks, original and configured
+
+int ModeSpawn (const HostOptions &opt);
+// Time, memory and script interpreters for creating vessels
+
+int ModeMonitor (const HostOptions &opt);
+// Cost of a 10 Hz dg:GetState monitor
+
+int ModeParse (const HostOptions &opt);
+// Check the scenario number parser and formatter, time scenario
+// loading
+
+int ModeSkin (const HostOptions &opt);
+// Load time of skinned vessels with a cold file cache
+
+int ModeAutosave (const HostOptions &opt);
+// Time to save the state of idle vessels
+
+int ModeMemory (const HostOptions &opt);
+// Heap memory per vessel
+
+int ModeFleet (const HostOptions &opt);
+// Step time with the fleet batch against vessel and thread count
+
+// ==============================================================
+// Vessels
+
+VESSEL2 *HostCreate (const HostOptions &opt, int idx, FILEHANDLE scn);
+// Create vessel "Scout-<idx+1>": ovcInit, clbkSetClassCaps with
+// opt.cfg, clbkLoadStateEx with scn (if not NULL) and
+// clbkPostCreation
+
+void HostDelete (VESSEL2 *v);
+// ovcExit and release the vessel stub
+
+double HostStep (const std::vector<VESSEL2*> &v, double dt);
+// Advance the simulation time by dt and run one frame for all
+// vessels. Returns the wall time spent in the callbacks [s].
+
+// ==============================================================
+// Timing and counters
+
+double HostNow ();
+// Wall time [s]
+
+size_t HostHeap ();
+// Heap bytes in use
+
+void HostCountAllocs (bool count);
+// Start/stop counting operator new calls
+
+unsigned long long HostAllocs ();
+// operator new calls counted so far
+
+#endif // !__HOST_H
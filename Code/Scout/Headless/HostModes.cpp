@@ -0,0 +1,805 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// HostModes.cpp
+// Headless host: checks and measurements of individual Scout
+// subsystems
+//
+// Notes:
+// * Check modes compare an optimised code path against its
+//   reference over a sweep of inputs and fail (exit code 1) if the
+//   documented error bound is exceeded. They are registered as
+//   tests in CMakeLists.txt.
+// * Timings are wall time per call, averaged over repeated passes
+//   of at least HOST_MINTIME seconds.
+// ==============================================================
+
+#include "Host.h"
+#include "Ramjet.h"
+#include "Scout.h"
+#include "ScnParse.h"
+#include "SkinManager.h"
+#include "Fleet.h"
+#include <stdint.h>
+
+const double HOST_MINTIME = 0.5;
+// minimum duration of a timing loop [s]
+
+static volatile double sink;
+// results of timed calls, so they aren't optimised away
+
+// Difference of two doubles in units in the last place
+static uint64_t Ulp (double a, double b)
+{
+	int64_t ia, ib;
+	memcpy (&ia, &a, sizeof(double));
+	memcpy (&ib, &b, sizeof(double));
+	if (ia < 0) ia = INT64_MIN - ia;
+	if (ib < 0) ib = INT64_MIN - ib;
+	return (ia > ib ? (uint64_t)(ia-ib) : (uint64_t)(ib-ia));
+}
+
+// ==============================================================
+// Ramjet mode: Ramjet::Thrust against the original evaluation
+// (Thrust_ref) over Mach number, freestream temperature and
+// pressure and throttle level, then engines/s of both.
+// Four engines, two of each Scout engine model.
+
+const int RJ_NENG = 4;
+const int RJ_NM = 801;     // Mach 0-8
+const int RJ_NT = 7;       // 180-300 K
+const int RJ_NP = 9;       // 10 Pa-100 kPa
+const int RJ_NLVL = 11;    // throttle 0-1
+
+struct RamjetState {
+	double M, T0, p0, lvl[RJ_NENG];
+};
+
+static RamjetState RamjetSweep (int k)
+{
+	RamjetState s;
+	int im = k % RJ_NM;            k /= RJ_NM;
+	int it = k % RJ_NT;            k /= RJ_NT;
+	int ip = k % RJ_NP;            k /= RJ_NP;
+	s.M  = im*0.01;
+	s.T0 = 180.0 + it*20.0;
+	s.p0 = 10.0*pow (10.0, ip*0.5);
+	for (int i = 0; i < RJ_NENG; i++)   // a different level for each engine
+		s.lvl[i] = ((k+i*3) % RJ_NLVL)*0.1;
+	return s;
+}
+
+int ModeRamjet (const HostOptions &opt)
+{
+	const int nstate = RJ_NM*RJ_NT*RJ_NP*RJ_NLVL;
+	// Bounds: the exhaust temperature is Tb/tr instead of
+	// Tb*pow(p0/pd,(g-1)/g), which differs by a few ulp. Near Mach 0
+	// the thrust (1+D)*ve-v0 is a small difference, so its error is
+	// measured against the engine's full-throttle thrust.
+	const double Frel_max = 1e-10;   // thrust, relative to full-throttle thrust at M, T0, p0
+	const double drel_max = 1e-14;   // fuel flow, relative
+	const uint64_t Tulp_max = 16;    // temperatures [ulp]
+	const ATMCONST *atm = &g_World.atm;
+	double F[RJ_NENG], Fref[RJ_NENG], dmf[RJ_NENG], Tr[3][RJ_NENG], Fmax[RJ_NENG];
+	double erel = 0.0, drel = 0.0;
+	uint64_t Tulp = 0;
+	int i, j, k, nfail = 0;
+	std::vector<RamjetState> state (nstate);
+	for (k = 0; k < nstate; k++)
+		state[k] = RamjetSweep (k);
+
+	Ramjet rj (NULL);
+	for (i = 0; i < RJ_NENG; i++)
+		rj.AddThrusterDefinition (NULL, SCRAM_FHV[i&1], SCRAM_INTAKE_AREA, SCRAM_TEMAX[i&1], SCRAM_MAX_DMF[i&1]);
+
+	// validation
+	for (k = 0; k < nstate; k++) {
+		const RamjetState &s = state[k];
+		double one[RJ_NENG] = {1.0, 1.0, 1.0, 1.0};
+		rj.Thrust_ref (Fmax, atm, one, s.M, s.T0, s.p0);
+		rj.Thrust_ref (Fref, atm, s.lvl, s.M, s.T0, s.p0);
+		for (i = 0; i < RJ_NENG; i++) {
+			dmf[i] = rj.DMF (i);
+			for (j = 0; j < 3; j++) Tr[j][i] = rj.Temp (i, j);
+		}
+		rj.Thrust (F, atm, s.lvl, s.M, s.T0, s.p0);
+		for (i = 0; i < RJ_NENG; i++) {
+			double e = (Fmax[i] > 0.0 ? fabs (F[i]-Fref[i])/Fmax[i] : fabs (F[i]-Fref[i]));
+			double d = (dmf[i] > 0.0 ? fabs (rj.DMF (i)-dmf[i])/dmf[i] : fabs (rj.DMF (i)));
+			uint64_t u = 0;
+			for (j = 0; j < 3; j++) u = max (u, Ulp (rj.Temp (i, j), Tr[j][i]));
+			if (e > erel) erel = e;
+			if (d > drel) drel = d;
+			if (u > Tulp) Tulp = u;
+			if ((e > Frel_max || d > drel_max || u > Tulp_max) && nfail++ < 10)
+				printf ("mismatch: engine %d, M=%g T0=%g p0=%g lvl=%g: F %0.17g/%0.17g, dmf %0.17g/%0.17g, T ulp %llu\n",
+					i, s.M, s.T0, s.p0, s.lvl[i], F[i], Fref[i], rj.DMF (i), dmf[i], (unsigned long long)u);
+		}
+	}
+	printf ("Ramjet::Thrust vs Thrust_ref, %d states x %d engines\n", nstate, RJ_NENG);
+	printf ("  max. error: thrust %0.3g (bound %g), fuel flow %0.3g (bound %g), temperatures %llu ulp (bound %llu)\n",
+		erel, Frel_max, drel, drel_max, (unsigned long long)Tulp, (unsigned long long)Tulp_max);
+
+	// timing
+	for (int ref = 1; ref >= 0; ref--) {
+		double t0 = HostNow (), t, sum = 0.0;
+		long npass = 0;
+		do {
+			for (k = 0; k < nstate; k++) {
+				const RamjetState &s = state[k];
+				if (ref) rj.Thrust_ref (F, atm, s.lvl, s.M, s.T0, s.p0);
+				else     rj.Thrust (F, atm, s.lvl, s.M, s.T0, s.p0);
+				sum += F[0];
+			}
+			npass++;
+		} while ((t = HostNow ()-t0) < HOST_MINTIME);
+		sink = sum;
+		double neng = (double)npass*nstate*RJ_NENG;
+		printf ("  %-10s %6.1f M engines/s (%0.1f ns/engine)\n", ref ? "Thrust_ref" : "Thrust",
+			neng/t*1e-6, t/neng*1e9);
+	}
+
+	if (nfail) printf ("FAILED: %d mismatches\n", nfail);
+	return (nfail ? 1 : 0);
+}
+
+// ==============================================================
+// Ramjet table mode: thrust with the tabulated inlet terms
+// (Ramjet::EnableTable) against the analytic thrust, Mach 0 to the
+// pressure recovery cutoff, checked against the bounds documented
+// in Ramjet.h: 0.1% up to Mach 7.76, and 1.3e-4 of the peak thrust
+// over the Mach range between Mach 7.76 and the cutoff, where the
+// thrust goes to zero.
+
+const int RT_NM = 7810;    // Mach 0-7.81
+const double RT_MREL = 7.76; // upper limit of the relative bound
+
+int ModeRamjetTable (const HostOptions &opt)
+{
+	const double rel_max = 1e-3, peak_max = 1.3e-4;
+	const ATMCONST *atm = &g_World.atm;
+	double F[RJ_NENG], Fa[RT_NM+1][RJ_NENG], Ft[RT_NM+1][RJ_NENG], Fpeak[RJ_NENG], lvl[RJ_NENG];
+	double erel = 0.0, epeak = 0.0;
+	int i, im, it, ip, il, nfail = 0;
+
+	Ramjet ra (NULL), rt (NULL);
+	rt.EnableTable (true);
+	for (i = 0; i < RJ_NENG; i++) {
+		ra.AddThrusterDefinition (NULL, SCRAM_FHV[i&1], SCRAM_INTAKE_AREA, SCRAM_TEMAX[i&1], SCRAM_MAX_DMF[i&1]);
+		rt.AddThrusterDefinition (NULL, SCRAM_FHV[i&1], SCRAM_INTAKE_AREA, SCRAM_TEMAX[i&1], SCRAM_MAX_DMF[i&1]);
+	}
+
+	for (it = 0; it < RJ_NT; it++) {
+		double T0 = 180.0 + it*20.0;
+		for (ip = 0; ip < RJ_NP; ip++) {
+			double p0 = 10.0*pow (10.0, ip*0.5);
+			for (il = 1; il < RJ_NLVL; il++) {
+				for (i = 0; i < RJ_NENG; i++) {
+					lvl[i] = ((il+i*3-1) % (RJ_NLVL-1) + 1)*0.1; // 0.1-1, different for each engine
+					Fpeak[i] = 0.0;
+				}
+				for (im = 0; im <= RT_NM; im++) {
+					double M = im*1e-3;
+					ra.Thrust (Fa[im], atm, lvl, M, T0, p0);
+					rt.Thrust (Ft[im], atm, lvl, M, T0, p0);
+					for (i = 0; i < RJ_NENG; i++)
+						Fpeak[i] = max (Fpeak[i], Fa[im][i]);
+				}
+				for (im = 0; im <= RT_NM; im++) {
+					double M = im*1e-3;
+					for (i = 0; i < RJ_NENG; i++) {
+						double d = fabs (Ft[im][i]-Fa[im][i]);
+						bool fail = false;
+						if (M > RT_MREL) {
+							double e = (Fpeak[i] > 0.0 ? d/Fpeak[i] : d);
+							if (e > epeak) epeak = e;
+							if (e > peak_max) fail = true;
+						} else if (Fa[im][i] > 0.0) {
+							double r = d/Fa[im][i];
+							if (r > erel) erel = r;
+							if (r > rel_max) fail = true;
+						} else if (Ft[im][i] > 0.0) fail = true;
+						if (fail && nfail++ < 10)
+							printf ("mismatch: engine %d, M=%g T0=%g p0=%g lvl=%g: F %0.10g, analytic %0.10g, peak %0.10g\n",
+								i, M, T0, p0, lvl[i], Ft[im][i], Fa[im][i], Fpeak[i]);
+					}
+				}
+			}
+		}
+	}
+	printf ("Ramjet inlet table (%d nodes) vs analytic, Mach 0-%g, %d conditions x %d engines\n",
+		RAMJET_TABLE_NODES, RT_NM*1e-3, RJ_NT*RJ_NP*(RJ_NLVL-1), RJ_NENG);
+	printf ("  max. error: %0.3g relative up to Mach %g (bound %g), %0.3g of peak thrust above (bound %g)\n",
+		erel, RT_MREL, rel_max, epeak, peak_max);
+
+	// timing
+	for (int tab = 0; tab <= 1; tab++) {
+		const Ramjet &rj = (tab ? rt : ra);
+		double t0 = HostNow (), t, sum = 0.0;
+		long npass = 0;
+		for (i = 0; i < RJ_NENG; i++) lvl[i] = 1.0;
+		do {
+			for (im = 0; im <= RT_NM; im++) {
+				rj.Thrust (F, atm, lvl, im*1e-3, 220.0, 1e3);
+				sum += F[0];
+			}
+			npass++;
+		} while ((t = HostNow ()-t0) < HOST_MINTIME);
+		sink = sum;
+		double ncall = (double)npass*(RT_NM+1);
+		printf ("  %-8s %0.1f ns/call (%d engines)\n", tab ? "table" : "analytic", t/ncall*1e9, RJ_NENG);
+	}
+
+	if (nfail) printf ("FAILED: %d mismatches\n", nfail);
+	return (nfail ? 1 : 0);
+}
+
+// ==============================================================
+// Step runs with modified settings, shared by several modes
+
+struct StepRun {
+	double ns;                 // callback time per vessel and step [ns]
+	double nsdk;               // SDK calls per vessel and step
+	double nalloc;             // allocations per vessel and step
+};
+
+typedef void (*FrameFunc)(const std::vector<VESSEL2*> &v, long s);
+
+// Create nvessel vessels with the class configuration opt.cfg plus
+// items (NULL or "ITEM = value" lines separated by ';'), run nstep
+// frames, calling frame (if not NULL) before each, and delete the
+// vessels. The flight state is restored afterwards.
+static StepRun RunSteps (const HostOptions &opt, const char *items, int nvessel, long nstep, FrameFunc frame = NULL)
+{
+	StubWorld world = g_World;
+	HostOptions o = opt;
+	o.cfg = StubCopyFile (opt.cfg);
+	if (items) {
+		std::string s (items);
+		size_t p0 = 0, p1;
+		do {
+			p1 = s.find (';', p0);
+			StubAddLine (o.cfg, s.substr (p0, p1-p0).c_str());
+			p0 = p1+1;
+		} while (p1 != std::string::npos);
+	}
+
+	int i;
+	std::vector<VESSEL2*> v (nvessel);
+	for (i = 0; i < nvessel; i++)
+		v[i] = HostCreate (o, i, o.scn);
+	unsigned long long nsdk0 = SdkCounter::Total (), nalloc0 = HostAllocs (), nsdk = 0;
+	double t = 0.0;
+	for (long s = 0; s < nstep; s++) {
+		if (frame) {
+			unsigned long long n = SdkCounter::Total ();
+			frame (v, s);
+			nsdk += SdkCounter::Total ()-n;
+		}
+		t += HostStep (v, opt.dt);
+	}
+	double nvstep = (double)nvessel*nstep;
+	StepRun r;
+	r.ns = t/nvstep*1e9;
+	r.nsdk = (SdkCounter::Total ()-nsdk0-nsdk)/nvstep;
+	r.nalloc = (HostAllocs ()-nalloc0)/nvstep;
+	for (i = 0; i < nvessel; i++)
+		HostDelete (v[i]);
+	StubCloseFile (o.cfg);
+	g_World = world;
+	return r;
+}
+
+// Set the level of the thrusters that aren't in a thruster group
+// (the scramjets)
+static void SetScramLevel (VESSEL2 *v, double level)
+{
+	VESSELSTUB *stub = (VESSELSTUB*)v->GetHandle ();
+	for (size_t i = 0; i < stub->thruster.size(); i++) {
+		StubThruster *th = stub->thruster[i];
+		bool grouped = false;
+		for (int g = 0; g <= THGROUP_ATT_BACK && !grouped; g++)
+			grouped = (std::find (stub->group[g].th.begin(), stub->group[g].th.end(), th) != stub->group[g].th.end());
+		for (size_t g = 0; g < stub->usergroup.size() && !grouped; g++)
+			grouped = (std::find (stub->usergroup[g]->th.begin(), stub->usergroup[g]->th.end(), th) != stub->usergroup[g]->th.end());
+		if (!grouped) th->level = level;
+	}
+}
+
+// ==============================================================
+// Cruise mode: scramjet cruise at Mach 5 (25 km, 1500 m/s, 80%
+// throttle), each vessel stepped with the scramjet thrust memo off
+// (SCRAMJET_MEMO = -1 -1 -1 -1, i.e. a full thrust calculation in
+// every step) and with the default tolerances. Steady flight, then
+// a cruise that weaves +-500 m in altitude (period 6 min, up to
+// 8.7 m/s vertical speed) and +-30 m/s in airspeed (period 4 min).
+
+static void CruiseSteady (const std::vector<VESSEL2*> &v, long s)
+{
+	if (!s) {
+		StubSetAltitude (25000.0, 1500.0);
+		for (size_t i = 0; i < v.size(); i++)
+			SetScramLevel (v[i], 0.8);
+	}
+}
+
+static void CruiseWeave (const std::vector<VESSEL2*> &v, long s)
+{
+	CruiseSteady (v, s);
+	double t = s*g_World.simdt;
+	StubSetAltitude (25000.0 + 500.0*sin (t*PI2/360.0), 1500.0 + 30.0*sin (t*PI2/240.0));
+}
+
+int ModeCruise (const HostOptions &opt)
+{
+	static const struct { const char *name; FrameFunc frame; } flight[2] = {
+		{"steady", CruiseSteady}, {"weaving", CruiseWeave}
+	};
+	printf ("Scramjet cruise at Mach %0.2f, %d vessel(s), %ld steps of %g s\n",
+		1500.0/sqrt (1.4*287.05*216.65), opt.nvessel, opt.nstep, opt.dt);
+	for (int f = 0; f < 2; f++) {
+		StepRun off = RunSteps (opt, "SCRAMJET = TRUE;SCRAMJET_MEMO = -1 -1 -1 -1", opt.nvessel, opt.nstep, flight[f].frame);
+		StepRun on  = RunSteps (opt, "SCRAMJET = TRUE", opt.nvessel, opt.nstep, flight[f].frame);
+		printf ("  %-9s memo off %6.1f ns/step %5.2f SDK calls/step, memo on %6.1f ns/step %5.2f SDK calls/step\n",
+			flight[f].name, off.ns, off.nsdk, on.ns, on.nsdk);
+	}
+	return 0;
+}
+
+// ==============================================================
+// Airfoil mode: latency of the lift coefficient callbacks
+// registered with CreateAirfoil3, called directly over a sweep of
+// the angle (-180 to 180 deg, 0.1 deg steps) and Mach number (0-8),
+// with the original functions (AERO_REFERENCE) and with the
+// configured ones (tables, or the database with AERO_DATABASE).
+// Also the largest difference between the two.
+
+const int AF_NANG = 3600, AF_NM = 41;
+
+int ModeAirfoil (const HostOptions &opt)
+{
+	const char *item[2] = {"AERO_REFERENCE = TRUE", NULL};
+	const char *label[2] = {"reference", "configured"};
+	std::vector<double> coeff[2][2];
+	int a, m, k, n = AF_NANG*AF_NM;
+
+	printf ("Airfoil callbacks, %d angles x %d Mach numbers\n", AF_NANG, AF_NM);
+	for (int r = 0; r < 2; r++) {
+		HostOptions o = opt;
+		o.cfg = StubCopyFile (opt.cfg);
+		if (item[r]) StubAddLine (o.cfg, item[r]);
+		VESSEL2 *v = HostCreate (o, 0, NULL);
+		VESSELSTUB *stub = (VESSELSTUB*)v->GetHandle ();
+		for (size_t i = 0; i < stub->airfoil.size() && i < 2; i++) {
+			const StubAirfoil *af = stub->airfoil[i];
+			std::vector<double> &c = coeff[r][i];
+			c.resize (n*3);
+			for (a = k = 0; a < AF_NANG; a++)
+				for (m = 0; m < AF_NM; m++, k++)
+					af->cf (v, (a-AF_NANG/2)*(PI/(AF_NANG/2)), m*0.2, 1e7, af->context, &c[k*3], &c[k*3+1], &c[k*3+2]);
+			double t0 = HostNow (), t, sum = 0.0, cl, cm, cd;
+			long npass = 0;
+			do {
+				for (a = 0; a < AF_NANG; a++)
+					for (m = 0; m < AF_NM; m++) {
+						af->cf (v, (a-AF_NANG/2)*(PI/(AF_NANG/2)), m*0.2, 1e7, af->context, &cl, &cm, &cd);
+						sum += cl+cm+cd;
+					}
+				npass++;
+			} while ((t = HostNow ()-t0) < HOST_MINTIME);
+			sink = sum;
+			printf ("  %-10s %-10s %5.1f ns/call\n", label[r],
+				af->align == LIFT_VERTICAL ? "vertical" : "horizontal", t/((double)npass*n)*1e9);
+		}
+		HostDelete (v);
+		StubCloseFile (o.cfg);
+	}
+	for (int i = 0; i < 2; i++) {
+		double d[3] = {0.0, 0.0, 0.0};
+		if (coeff[0][i].size() != coeff[1][i].size()) continue;
+		for (k = 0; k < n*3; k++)
+			d[k%3] = max (d[k%3], fabs (coeff[1][i][k]-coeff[0][i][k]));
+		printf ("  %-10s max. difference: cl %0.3g, cm %0.3g, cd %0.3g\n",
+			i ? "horizontal" : "vertical", d[0], d[1], d[2]);
+	}
+	return 0;
+}
+
+// ==============================================================
+// Spawn mode: time and heap memory per vessel for creating (and
+// then deleting) opt.nvessel vessels, with the scripted autopilot
+// and with the native one (AAP_NATIVE). The number of script
+// interpreters created shows how many vessels share one. The stub
+// interpreters have no Lua state, so the heap figures don't include
+// the memory of a real interpreter.
+
+// Calls so far of the SDK functions whose name contains name
+static unsigned long long SdkCount (const char *name)
+{
+	unsigned long long n = 0;
+	for (SdkCounter *c = SdkCounter::First (); c; c = c->next)
+		if (strstr (c->name, name)) n += c->n;
+	return n;
+}
+
+int ModeSpawn (const HostOptions &opt)
+{
+	const char *item[2] = {NULL, "AAP_NATIVE = TRUE"};
+	const char *label[2] = {"script", "native"};
+	int i, n = opt.nvessel;
+
+	printf ("Spawning %d vessel(s)\n", n);
+	for (int r = 0; r < 2; r++) {
+		HostOptions o = opt;
+		o.cfg = StubCopyFile (opt.cfg);
+		if (item[r]) StubAddLine (o.cfg, item[r]);
+		std::vector<VESSEL2*> v (n);
+		unsigned long long ninterp = SdkCount ("oapiCreateInterpreter");
+		size_t heap = HostHeap ();
+		double t0 = HostNow ();
+		for (i = 0; i < n; i++)
+			v[i] = HostCreate (o, i, o.scn);
+		double t1 = HostNow ();
+		size_t bytes = HostHeap ()-heap;
+		ninterp = SdkCount ("oapiCreateInterpreter")-ninterp;
+		for (i = 0; i < n; i++)
+			HostDelete (v[i]);
+		double t2 = HostNow ();
+		printf ("  %-7s %7.1f us/vessel spawn, %6.1f us/vessel delete, %7.0f bytes/vessel, %llu interpreter(s)\n",
+			label[r], (t1-t0)/n*1e6, (t2-t1)/n*1e6, (double)bytes/n, ninterp);
+		StubCloseFile (o.cfg);
+	}
+	return 0;
+}
+
+// ==============================================================
+// Monitor mode: a script polling dg:GetState() at 10 Hz on every
+// vessel while the vessels are stepped. Reports the cost of one
+// sample (C side, with the stub Lua API: no table is actually
+// filled) and the number of Lua API calls it makes, and the step
+// time with and without the monitor.
+
+static void *const MON_L = &g_World;    // dummy interpreter state
+static double mon_t, mon_tnext;
+static unsigned long long mon_n, mon_nlua, mon_nsdk;
+
+static void MonitorFrame (const std::vector<VESSEL2*> &v, long s)
+{
+	if (!s) mon_tnext = g_World.simt;
+	if (g_World.simt < mon_tnext) return;
+	mon_tnext += 0.1;
+	unsigned long long nlua = g_LuaCalls, nsdk = SdkCounter::Total ();
+	double t0 = HostNow ();
+	for (size_t i = 0; i < v.size(); i++)
+		((Scout*)v[i])->Lua_GetState (MON_L);
+	mon_t += HostNow ()-t0;
+	mon_n += v.size();
+	mon_nlua += g_LuaCalls-nlua;
+	mon_nsdk += SdkCounter::Total ()-nsdk;
+}
+
+int ModeMonitor (const HostOptions &opt)
+{
+	const char *scram[2] = {NULL, "SCRAMJET = TRUE"};
+	printf ("10 Hz dg:GetState monitor, %d vessel(s), %ld steps of %g s\n", opt.nvessel, opt.nstep, opt.dt);
+	for (int r = 0; r < 2; r++) {
+		StepRun off = RunSteps (opt, scram[r], opt.nvessel, opt.nstep);
+		mon_t = 0.0;
+		mon_n = mon_nlua = mon_nsdk = 0;
+		StepRun on = RunSteps (opt, scram[r], opt.nvessel, opt.nstep, MonitorFrame);
+		printf ("  %-12s %5.0f ns/sample, %3.0f Lua API calls/sample, %2.0f SDK calls/sample;"
+			" step %0.1f ns, %0.1f ns with samples\n",
+			scram[r] ? "scramjet" : "no scramjet", mon_t/mon_n*1e9, (double)mon_nlua/mon_n,
+			(double)mon_nsdk/mon_n, off.ns, on.ns + mon_t/(opt.nvessel*(double)opt.nstep)*1e9);
+	}
+	return 0;
+}
+
+// ==============================================================
+// Parse mode: check the scenario number parser and formatter on
+// edge cases, then time clbkLoadStateEx over a synthetic scenario
+// of opt.nvessel vessels. Each vessel block has the generic state
+// lines of a saved Scout (passed on to the stub ParseScenarioLineEx)
+// and every Scout item except SKIN, with values varying from vessel
+// to vessel.
+
+// Scenario block of vessel i
+static FILEHANDLE ParseBlock (int i)
+{
+	static const char *door[9] = {"GEAR", "RCOVER", "NOSECONE", "AIRLOCK", "IAIRLOCK",
+		"AIRBRAKE", "RADIATOR", "LADDER", "HATCH"};
+	char cbuf[256];
+	FILEHANDLE f = StubNewFile ();
+	double a = i*0.618034;
+	StubAddLine (f, "  STATUS Orbiting Earth");
+	sprintf (cbuf, "  RPOS %0.2f %0.2f %0.2f", 6.4e6*cos (a), 1.5e5*sin (3*a), 6.4e6*sin (a));
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  RVEL %0.4f %0.4f %0.4f", -7.8e3*sin (a), 12.5*cos (3*a), 7.8e3*cos (a));
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  AROT %0.4f %0.4f %0.4f", 100*sin (a), 30*cos (a), -170+a);
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  PRPLEVEL 0:%0.6f 1:%0.6f", 0.5+0.5*sin (a), 0.5+0.5*cos (a));
+	StubAddLine (f, cbuf);
+	StubAddLine (f, "  NAVFREQ 0 0 0 0");
+	for (int j = 0; j < 9; j++)
+		if ((i+j) % 3) {
+			sprintf (cbuf, "  %s %d %0.4f", door[j], 1 + (i+j) % 4, ((i*7+j) % 101)/100.0);
+			StubAddLine (f, cbuf);
+		}
+	sprintf (cbuf, "  PSNGR %d %d", 1 + i % 4, 1 + (i+2) % 4);
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  LIGHTS %d %d %d %d", i & 1, (i>>1) & 1, (i>>2) & 1, (i>>3) & 1);
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  TRIM %g", 0.001*(i % 200) - 0.1);
+	StubAddLine (f, cbuf);
+	sprintf (cbuf, "  AAP %d:%g 0:0 %d:%g", i & 1, 1e4 + 37*i, (i>>1) & 1, 250 + 0.5*i);
+	StubAddLine (f, cbuf);
+	return f;
+}
+
+static const struct {
+	const char *str;           // input
+	double val;                // expected value
+	int len;                   // expected number of characters read
+} parsecase[] = {
+	{"0", 0.0, 1}, {"-12.5", -12.5, 5}, {" 1.25e3 x", 1250.0, 7},
+	{"2147483648", 2147483647.0, 10}, {"-99999999999", -2147483647.0, 12},
+	{"1e99999999999", HUGE_VAL, 13}, {"1e-99999999999", 0.0, 14},
+	{"-1e99999999999", -HUGE_VAL, 14}, {"0.1e2147483647", HUGE_VAL, 14}
+};
+
+// ScnWriteFixed cases: value, decimals, buffer size
+static const struct {
+	double val;
+	int ndec, len;
+} writecase[] = {
+	{0.5, 4, 24}, {-1234.56789, 2, 24}, {0.99995, 4, 24}, {1e14, 4, 24},
+	{1e14, 4, 8}, {-0.25, 4, 4}, {1e300, 4, 24}, {HUGE_VAL, 4, 24}
+};
+
+int ModeParse (const HostOptions &opt)
+{
+	int i, n = opt.nvessel, nfail = 0;
+	char buf[32], ref[32];
+
+	for (i = 0; i < (int)(sizeof(writecase)/sizeof(writecase[0])); i++) {
+		int len = writecase[i].len;
+		memset (buf, '#', sizeof(buf));
+		char *p = ScnWriteFixed (buf, len, writecase[i].val, writecase[i].ndec);
+		snprintf (ref, len, "%0.*f", writecase[i].ndec, writecase[i].val);
+		if (strcmp (buf, ref) || *p || p-buf >= len || buf[len] != '#') {
+			printf ("FAIL: %g written as \"%s\" into %d bytes, expected \"%s\"\n", writecase[i].val, buf, len, ref);
+			nfail++;
+		}
+	}
+
+	for (i = 0; i < (int)(sizeof(parsecase)/sizeof(parsecase[0])); i++) {
+		const char *s = parsecase[i].str, *p;
+		double v = -1.0;
+		if (strchr (s, '.') || strchr (s, 'e')) p = ScnReadFloat (s, v);
+		else { int iv = -1; p = ScnReadInt (s, iv); v = iv; }
+		if (!p || p-s != parsecase[i].len || v != parsecase[i].val) {
+			printf ("FAIL: \"%s\" read as %g (%d characters)\n", s, v, p ? (int)(p-s) : -1);
+			nfail++;
+		}
+	}
+
+	std::vector<VESSEL2*> v (n);
+	std::vector<FILEHANDLE> scn (n);
+	size_t nline = 0;
+	for (i = 0; i < n; i++) {
+		v[i] = HostCreate (opt, i, opt.scn);
+		scn[i] = ParseBlock (i);
+		nline += StubFileSize (scn[i]);
+	}
+	long npass = 0;
+	double t = 0.0;
+	do {
+		double t0 = HostNow ();
+		for (i = 0; i < n; i++) {
+			StubRewind (scn[i]);
+			v[i]->clbkLoadStateEx (scn[i], NULL);
+		}
+		t += HostNow ()-t0;
+		npass++;
+	} while (t < HOST_MINTIME);
+	printf ("Scenario load, %d vessel(s), %0.1f lines/vessel: %0.1f us/vessel, %0.0f ns/line, %0.2f ms/scenario\n",
+		n, (double)nline/n, t/(npass*(double)n)*1e6, t/(npass*(double)nline)*1e9, t/npass*1e3);
+	for (i = 0; i < n; i++) {
+		HostDelete (v[i]);
+		StubCloseFile (scn[i]);
+	}
+	printf ("%s: %d number parsing/formatting case(s) failed\n", nfail ? "FAIL" : "OK", nfail);
+	return (nfail ? 1 : 0);
+}
+
+// ==============================================================
+// Skin mode: load opt.nvessel vessels with SKIN entries (SKIN_NDIR
+// different skins, as in a scenario with a few liveries) while the
+// skin files take SKIN_DELAY ms each to open, as with a cold file
+// cache. Reports the time spent creating the vessels, and the
+// frames until all skin textures are loaded with the longest frame.
+
+const int SKIN_NDIR = 5;
+const DWORD SKIN_DELAY = 20;
+
+int ModeSkin (const HostOptions &opt)
+{
+	int i, n = opt.nvessel;
+	char cbuf[64];
+
+	printf ("Loading %d vessel(s) with %d skins, %lu ms per skin file\n", n, SKIN_NDIR, (unsigned long)SKIN_DELAY);
+	std::vector<VESSEL2*> v (n);
+	std::vector<FILEHANDLE> scn (n);
+	for (i = 0; i < n; i++) {
+		scn[i] = StubNewFile ();
+		sprintf (cbuf, "  SKIN Livery%d", i % SKIN_NDIR);
+		StubAddLine (scn[i], cbuf);
+	}
+	int ntex = (n < SKIN_NDIR ? n : SKIN_NDIR)*SKIN_NTEX;
+	unsigned long long ntex0 = SdkCount ("oapiLoadTexture");
+	g_FileDelay = SKIN_DELAY;
+	double t0 = HostNow ();
+	for (i = 0; i < n; i++)
+		v[i] = HostCreate (opt, i, scn[i]);
+	double tload = HostNow ()-t0, tmax = 0.0;
+	long nframe = 0;
+	while (SdkCount ("oapiLoadTexture")-ntex0 < (unsigned long long)ntex && HostNow ()-t0 < 10.0) {
+		double t = HostStep (v, opt.dt);
+		if (t > tmax) tmax = t;
+		nframe++;
+	}
+	double tskin = HostNow ()-t0;
+	g_FileDelay = 0;
+	printf ("  creation %0.1f ms; all %d skin textures after %0.1f ms, %ld frame(s), longest frame %0.2f ms\n",
+		tload*1e3, ntex, tskin*1e3, nframe, tmax*1e3);
+	for (i = 0; i < n; i++) {
+		HostDelete (v[i]);
+		StubCloseFile (scn[i]);
+	}
+	return 0;
+}
+
+// ==============================================================
+// Autosave mode: clbkSaveState of opt.nvessel idle vessels (a few
+// doors open, passengers, lights, trim and autopilot set), first
+// with all fields changed since loading, then repeatedly with
+// nothing changed, as in periodic autosaves. The stub scenario
+// files are created outside the timed loop.
+
+int ModeAutosave (const HostOptions &opt)
+{
+	int i, n = opt.nvessel;
+	char cbuf[64];
+
+	std::vector<VESSEL2*> v (n);
+	std::vector<FILEHANDLE> scn (n);
+	for (i = 0; i < n; i++) {
+		FILEHANDLE f = StubNewFile ();
+		StubAddLine (f, "  GEAR 1 1.0000");
+		StubAddLine (f, "  NOSECONE 1 1.0000");
+		StubAddLine (f, "  RADIATOR 1 1.0000");
+		sprintf (cbuf, "  PSNGR %d %d", 1 + i % 4, 1 + (i+2) % 4);
+		StubAddLine (f, cbuf);
+		StubAddLine (f, "  LIGHTS 1 0 1 0");
+		sprintf (cbuf, "  TRIM %g", 0.001*(i % 200) - 0.1);
+		StubAddLine (f, cbuf);
+		sprintf (cbuf, "  AAP 1:%g 0:0 1:%g", 1e4 + 37*i, 250 + 0.5*i);
+		StubAddLine (f, cbuf);
+		v[i] = HostCreate (opt, i, f);
+		StubCloseFile (f);
+	}
+
+	double tfirst = 0.0, tidle = 0.0;
+	size_t nline = 0;
+	long npass = 0;
+	do {
+		for (i = 0; i < n; i++) scn[i] = StubNewFile ();
+		double t0 = HostNow ();
+		for (i = 0; i < n; i++)
+			v[i]->clbkSaveState (scn[i]);
+		double t = HostNow ()-t0;
+		if (npass) tidle += t;
+		else {
+			tfirst = t;
+			for (i = 0; i < n; i++) nline += StubFileSize (scn[i]);
+		}
+		for (i = 0; i < n; i++) StubCloseFile (scn[i]);
+		npass++;
+	} while (tidle < HOST_MINTIME || npass < 2);
+	printf ("Autosave, %d idle vessel(s), %0.1f lines/vessel: first save %0.2f us/vessel,"
+		" later saves %0.2f us/vessel (%0.2f ms/autosave)\n", n, (double)nline/n,
+		tfirst/n*1e6, tidle/((npass-1)*(double)n)*1e6, tidle/(npass-1)*1e3);
+	for (i = 0; i < n; i++)
+		HostDelete (v[i]);
+	return 0;
+}
+
+// ==============================================================
+// Memory mode: heap bytes per vessel for a scenario of opt.nvessel
+// vessels without scramjets, with scramjets, and with tabulated
+// scramjet inlets, after one step in Mach 5 cruise (which builds
+// the inlet tables). Averaged over all vessels, and over all but
+// the first, which also creates the data shared by the class (and
+// module data kept after the last vessel is deleted, so this part
+// isn't reported on its own). The heap includes the stub's own
+// vessel records (thrusters, animations etc.).
+
+int ModeMemory (const HostOptions &opt)
+{
+	static const struct { const char *name, *item[2]; } cfg[3] = {
+		{"no scramjet", {NULL, NULL}},
+		{"scramjet", {"SCRAMJET = TRUE", NULL}},
+		{"inlet table", {"SCRAMJET = TRUE", "SCRAMJET_TABLE = TRUE"}}
+	};
+	int i, n = opt.nvessel;
+
+	printf ("Heap memory of %d vessel(s), sizeof(Scout) = %u bytes\n", n, (unsigned)sizeof(Scout));
+	for (int r = 0; r < 3; r++) {
+		StubWorld world = g_World;
+		HostOptions o = opt;
+		o.cfg = StubCopyFile (opt.cfg);
+		for (int j = 0; j < 2; j++)
+			if (cfg[r].item[j]) StubAddLine (o.cfg, cfg[r].item[j]);
+		std::vector<VESSEL2*> v (1);
+		size_t heap0 = HostHeap ();
+		v[0] = HostCreate (o, 0, o.scn);
+		CruiseSteady (v, 0);
+		HostStep (v, opt.dt);
+		size_t heap1 = HostHeap ();
+		v.resize (n);
+		for (i = 1; i < n; i++) {
+			v[i] = HostCreate (o, i, o.scn);
+			SetScramLevel (v[i], 0.8);
+		}
+		HostStep (v, opt.dt);
+		size_t heap2 = HostHeap ();
+		printf ("  %-12s %7.0f bytes/vessel, %7.0f bytes/vessel after the first\n",
+			cfg[r].name, (double)(heap2-heap0)/n, n > 1 ? (double)(heap2-heap1)/(n-1) : 0.0);
+		for (i = 0; i < n; i++)
+			HostDelete (v[i]);
+		StubCloseFile (o.cfg);
+		g_World = world;
+	}
+	return 0;
+}
+
+// ==============================================================
+// Fleet mode: step time in Mach 5 scramjet cruise (as in the cruise
+// mode) against the number of vessels, with the fleet batch off,
+// automatic (FLEET_THREADS = -1, one worker per core minus one) and
+// with 1, 2 and 4 worker threads. Total steps per run are about
+// opt.nstep vessel steps, at least 100 frames.
+
+int ModeFleet (const HostOptions &opt)
+{
+	static const int nv[4] = {16, 64, 256, 1024};
+	static const struct { const char *name, *item; } cfg[5] = {
+		{"off", "SCRAMJET = TRUE"},
+		{"auto", "SCRAMJET = TRUE;FLEET_THREADS = -1"},
+		{"1", "SCRAMJET = TRUE;FLEET_THREADS = 1"},
+		{"2", "SCRAMJET = TRUE;FLEET_THREADS = 2"},
+		{"4", "SCRAMJET = TRUE;FLEET_THREADS = 4"}
+	};
+	SYSTEM_INFO si;
+	GetSystemInfo (&si);
+	printf ("Fleet batch, scramjet cruise, ns/step per vessel, %lu processor(s)\n", (unsigned long)si.dwNumberOfProcessors);
+	printf ("  vessels");
+	for (int c = 0; c < 5; c++) printf ("  %7s", cfg[c].name);
+	printf ("\n");
+	for (int k = 0; k < 4; k++) {
+		long nstep = opt.nstep/nv[k];
+		if (nstep < 100) nstep = 100;
+		printf ("  %7d", nv[k]);
+		for (int c = 0; c < 5; c++) {
+			StepRun r = RunSteps (opt, cfg[c].item, nv[k], nstep, CruiseSteady);
+			Fleet::Exit (); // so that the next run starts its own workers
+			printf ("  %7.1f", r.ns);
+		}
+		printf ("\n");
+	}
+	return 0;
+}
@@ -0,0 +1,149 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// SdkStub.h
+// Headless host: internals of the stub Orbiter API shared between
+// StubSdk.cpp and Host.cpp
+//
+// Notes:
+// * Every stub function starts with SDKCALL(), which increments a
+//   per-function counter. The counters register themselves on
+//   first use; SdkCounter::First walks the list.
+// * One VESSELSTUB per vessel holds everything the stubs store.
+//   The OBJHANDLE of a vessel is its VESSELSTUB.
+// * StubWorld is the flight state shared by all vessels. The host
+//   sets it; the stubs only read it.
+// ==============================================================
+
+#ifndef __SDKSTUB_H
+#define __SDKSTUB_H
+
+// standard library first: windows.h defines min and max
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <new>
+#include "Orbitersdk.h"
+
+// ==============================================================
+// Call counters
+
+class SdkCounter {
+public:
+	SdkCounter (const char *_name);
+	const char *name;
+	volatile unsigned long long n;
+	SdkCounter *next;
+
+	static SdkCounter *First () { return first; }
+	static unsigned long long Total ();
+	// Sum of all counters
+
+private:
+	static SdkCounter *first;
+};
+
+#define SDKCALL() \
+	static SdkCounter _sdkc (__PRETTY_FUNCTION__); \
+	__sync_fetch_and_add (&_sdkc.n, 1)
+
+// ==============================================================
+// Per-vessel state
+
+struct StubPropellant {
+	double maxmass, mass, efficiency;
+};
+
+struct StubThruster {
+	VECTOR3 pos, dir;
+	double max0, isp, isp0, level;
+	StubPropellant *res;
+};
+
+struct StubGroup {
+	std::vector<StubThruster*> th;
+};
+
+struct StubAirfoil {
+	AIRFOIL_ORIENTATION align;
+	AirfoilCoeffFuncEx cf;
+	void *context;
+};
+
+struct VESSELSTUB {
+	VESSEL *iface;
+	std::string name, classname;
+	double emptymass;
+	std::vector<StubPropellant*> prop;
+	std::vector<StubThruster*> thruster;
+	StubGroup group[THGROUP_ATT_BACK+1];
+	std::vector<StubGroup*> usergroup;
+	std::vector<StubAirfoil*> airfoil;
+	std::vector<double> anim;
+	double ctrlsurf[AIRCTRL_RUDDERTRIM+1];
+	double wbrake[3];
+	DWORD navmode;
+	int attmode;
+	DWORD adcmode;
+	UINT nmesh;
+};
+
+// ==============================================================
+// Shared flight state (set by the host)
+
+struct StubWorld {
+	double simt, simdt, mjd;  // simulation time, step, date
+	double systime;           // system time
+	double alt;               // altitude [m]
+	double airspeed;          // true airspeed [m/s]
+	double aoa, slip;         // angle of attack, sideslip [rad]
+	double pitch, bank, yaw;  // attitude [rad]
+	double rho, p, T;         // atmospheric density [kg/m^3], pressure [Pa], temperature [K]
+	double mach;              // Mach number
+	bool ground;              // ground contact
+	ATMCONST atm;             // atmosphere constants of the reference body
+	OBJHANDLE hPlanet;        // reference body
+};
+
+extern StubWorld g_World;
+
+extern volatile unsigned long long g_LuaCalls;
+// calls into the stub Lua API
+
+extern DWORD g_FileDelay;
+// simulated latency of CreateFile [ms] (cold file cache)
+
+void StubSetAltitude (double alt, double airspeed);
+// Set altitude and airspeed and derive the atmospheric state from
+// a standard atmosphere
+
+void StubAdvance (VESSELSTUB *v, double dt);
+// Burn propellant for the current thruster levels over dt
+
+// ==============================================================
+// Configuration and scenario files
+
+FILEHANDLE StubOpenFile (const char *path);
+// Read a configuration or scenario file into memory (NULL: not found)
+
+FILEHANDLE StubNewFile ();
+// Empty file, e.g. for items given on the command line or for saving
+
+FILEHANDLE StubCopyFile (FILEHANDLE f);
+// New file with the lines of f
+
+void StubAddLine (FILEHANDLE f, const char *line);
+// Append a line
+
+void StubRewind (FILEHANDLE f);
+// Restart oapiReadScenario_nextline from the first line
+
+size_t StubFileSize (FILEHANDLE f);
+// Number of lines
+
+void StubCloseFile (FILEHANDLE f);
+
+#endif // !__SDKSTUB_H
@@ -0,0 +1,96 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// StubLua.cpp
+// Headless host: empty Lua API. oapiCreateInterpreter returns NULL
+// in the host, so none of these are reached with a valid state;
+// they only satisfy the linker, and let the host time the C side
+// of the script interface with a dummy state.
+//
+// Notes:
+// * Every function counts its call in g_LuaCalls, as a measure of
+//   the work a real interpreter would do.
+// ==============================================================
+
+#include "SdkStub.h"
+
+extern "C" {
+#include "lua/lua.h"
+#include "lua/lauxlib.h"
+}
+
+volatile unsigned long long g_LuaCalls = 0;
+
+#define LUACALL() g_LuaCalls++
+
+int   lua_gettop (lua_State *L) { LUACALL(); return 0; }
+void  lua_settop (lua_State *L, int idx) { LUACALL(); }
+void  lua_pushvalue (lua_State *L, int idx) { LUACALL(); }
+void  lua_remove (lua_State *L, int idx) { LUACALL(); }
+void  lua_insert (lua_State *L, int idx) { LUACALL(); }
+int   lua_type (lua_State *L, int idx) { LUACALL(); return LUA_TNIL; }
+int   lua_isnumber (lua_State *L, int idx) { LUACALL(); return 0; }
+int   lua_isstring (lua_State *L, int idx) { LUACALL(); return 0; }
+int   lua_iscfunction (lua_State *L, int idx) { LUACALL(); return 0; }
+int   lua_isuserdata (lua_State *L, int idx) { LUACALL(); return 0; }
+lua_Number lua_tonumber (lua_State *L, int idx) { LUACALL(); return 0; }
+lua_Integer lua_tointeger (lua_State *L, int idx) { LUACALL(); return 0; }
+int   lua_toboolean (lua_State *L, int idx) { LUACALL(); return 0; }
+const char *lua_tolstring (lua_State *L, int idx, size_t *len) { LUACALL(); if (len) *len = 0; return 0; }
+lua_CFunction lua_tocfunction (lua_State *L, int idx) { LUACALL(); return 0; }
+void *lua_touserdata (lua_State *L, int idx) { LUACALL(); return 0; }
+lua_State *lua_tothread (lua_State *L, int idx) { LUACALL(); return 0; }
+const void *lua_topointer (lua_State *L, int idx) { LUACALL(); return 0; }
+void  lua_pushnil (lua_State *L) { LUACALL(); }
+void  lua_pushnumber (lua_State *L, lua_Number n) { LUACALL(); }
+void  lua_pushinteger (lua_State *L, lua_Integer n) { LUACALL(); }
+void  lua_pushlstring (lua_State *L, const char *s, size_t l) { LUACALL(); }
+void  lua_pushstring (lua_State *L, const char *s) { LUACALL(); }
+const char *lua_pushfstring (lua_State *L, const char *fmt, ...) { LUACALL(); return ""; }
+void  lua_pushcclosure (lua_State *L, lua_CFunction fn, int n) { LUACALL(); }
+void  lua_pushboolean (lua_State *L, int b) { LUACALL(); }
+void  lua_pushlightuserdata (lua_State *L, void *p) { LUACALL(); }
+int   lua_pushthread (lua_State *L) { LUACALL(); return 0; }
+void  lua_gettable (lua_State *L, int idx) { LUACALL(); }
+void  lua_getfield (lua_State *L, int idx, const char *k) { LUACALL(); }
+void  lua_rawget (lua_State *L, int idx) { LUACALL(); }
+void  lua_rawgeti (lua_State *L, int idx, int n) { LUACALL(); }
+void  lua_createtable (lua_State *L, int narr, int nrec) { LUACALL(); }
+void *lua_newuserdata (lua_State *L, size_t sz) { LUACALL(); return 0; }
+int   lua_getmetatable (lua_State *L, int objindex) { LUACALL(); return 0; }
+void  lua_getfenv (lua_State *L, int idx) { LUACALL(); }
+void  lua_settable (lua_State *L, int idx) { LUACALL(); }
+void  lua_setfield (lua_State *L, int idx, const char *k) { LUACALL(); }
+void  lua_rawset (lua_State *L, int idx) { LUACALL(); }
+void  lua_rawseti (lua_State *L, int idx, int n) { LUACALL(); }
+int   lua_setmetatable (lua_State *L, int objindex) { LUACALL(); return 0; }
+int   lua_setfenv (lua_State *L, int idx) { LUACALL(); return 0; }
+void  lua_call (lua_State *L, int nargs, int nresults) { LUACALL(); }
+int   lua_pcall (lua_State *L, int nargs, int nresults, int errfunc) { LUACALL(); return LUA_ERRRUN; }
+int   lua_yield (lua_State *L, int nresults) { LUACALL(); return 0; }
+int   lua_resume (lua_State *L, int narg) { LUACALL(); return LUA_ERRRUN; }
+int   lua_status (lua_State *L) { LUACALL(); return 0; }
+int   lua_error (lua_State *L) { LUACALL(); return 0; }
+lua_State *lua_newthread (lua_State *L) { LUACALL(); return 0; }
+int   lua_getstack (lua_State *L, int level, lua_Debug *ar) { LUACALL(); return 0; }
+int   lua_getinfo (lua_State *L, const char *what, lua_Debug *ar) { LUACALL(); return 0; }
+int   lua_sethook (lua_State *L, lua_Hook func, int mask, int count) { LUACALL(); return 1; }
+
+void luaL_openlib (lua_State *L, const char *libname, const luaL_Reg *l, int nup) { LUACALL(); }
+int luaL_newmetatable (lua_State *L, const char *tname) { LUACALL(); return 0; }
+void *luaL_checkudata (lua_State *L, int ud, const char *tname) { LUACALL(); return 0; }
+int luaL_error (lua_State *L, const char *fmt, ...) { LUACALL(); return 0; }
+const char *luaL_checklstring (lua_State *L, int numArg, size_t *l) { LUACALL(); if (l) *l = 0; return ""; }
+const char *luaL_optlstring (lua_State *L, int numArg, const char *def, size_t *l) { LUACALL(); return def; }
+lua_Number luaL_checknumber (lua_State *L, int numArg) { LUACALL(); return 0; }
+lua_Number luaL_optnumber (lua_State *L, int nArg, lua_Number def) { LUACALL(); return def; }
+lua_Integer luaL_checkinteger (lua_State *L, int numArg) { LUACALL(); return 0; }
+void luaL_checktype (lua_State *L, int narg, int t) { LUACALL(); }
+int luaL_ref (lua_State *L, int t) { LUACALL(); return LUA_NOREF; }
+void luaL_unref (lua_State *L, int t, int ref) { LUACALL(); }
+int luaL_loadfile (lua_State *L, const char *filename) { LUACALL(); return LUA_ERRSYNTAX; }
+int luaL_loadbuffer (lua_State *L, const char *buff, size_t sz, const char *name) { LUACALL(); return LUA_ERRSYNTAX; }
+int luaL_loadstring (lua_State *L, const char *s) { LUACALL(); return LUA_ERRSYNTAX; }
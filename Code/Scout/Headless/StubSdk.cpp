@@ -0,0 +1,994 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// StubSdk.cpp
+// Headless host: stub implementation of the Orbiter API
+//
+// Notes:
+// * Every function records its call with SDKCALL(), so the counts
+//   reflect what the module asks of the simulator, whether the
+//   stub does any work or not.
+// * Vessel setup (thrusters, propellant, groups, animations,
+//   control surfaces, airfoil callbacks) is stored per vessel; the
+//   flight state comes from g_World.
+// ==============================================================
+
+#include "SdkStub.h"
+#include <ctype.h>
+#include <pthread.h>
+
+StubWorld g_World;
+SdkCounter *SdkCounter::first = NULL;
+
+static char dummy_handle;                 // non-NULL handle for resources the host doesn't model
+#define DUMMY ((void*)&dummy_handle)
+
+// ==============================================================
+// Call counters
+
+SdkCounter::SdkCounter (const char *_name)
+{
+	static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+	name = _name;
+	n = 0;
+	pthread_mutex_lock (&mtx);
+	next = first;
+	first = this;
+	pthread_mutex_unlock (&mtx);
+}
+
+unsigned long long SdkCounter::Total ()
+{
+	unsigned long long sum = 0;
+	for (SdkCounter *c = first; c; c = c->next)
+		sum += c->n;
+	return sum;
+}
+
+// ==============================================================
+// Flight state
+
+void StubSetAltitude (double alt, double airspeed)
+{
+	// ISA troposphere and lower stratosphere
+	double T, p;
+	if (alt < 11000.0) {
+		T = 288.15 - 0.0065*alt;
+		p = 101325.0 * pow (T/288.15, 5.2559);
+	} else {
+		T = 216.65;
+		p = 22632.0 * exp (-(alt-11000.0)/6341.6);
+	}
+	g_World.alt = alt;
+	g_World.airspeed = airspeed;
+	g_World.T = T;
+	g_World.p = p;
+	g_World.rho = p/(287.05*T);
+	g_World.mach = airspeed/sqrt (1.4*287.05*T);
+	g_World.ground = (alt <= 0.0);
+}
+
+void StubAdvance (VESSELSTUB *v, double dt)
+{
+	for (size_t i = 0; i < v->thruster.size(); i++) {
+		StubThruster *th = v->thruster[i];
+		if (th->level > 0.0 && th->res && th->isp > 0.0) {
+			double dm = th->level*th->max0/th->isp*dt/th->res->efficiency;
+			th->res->mass = max (0.0, th->res->mass - dm);
+		}
+	}
+}
+
+static double Mass (const VESSELSTUB *v)
+{
+	double m = v->emptymass;
+	for (size_t i = 0; i < v->prop.size(); i++)
+		m += v->prop[i]->mass;
+	return m;
+}
+
+// ==============================================================
+// Configuration and scenario files
+
+struct StubFile {
+	std::vector<std::string> line;
+	size_t pos;
+	char buf[1024];
+};
+
+FILEHANDLE StubOpenFile (const char *path)
+{
+	FILE *f = fopen (path, "rt");
+	if (!f) return NULL;
+	StubFile *sf = new StubFile;
+	sf->pos = 0;
+	char cbuf[1024];
+	while (fgets (cbuf, 1024, f)) {
+		size_t len = strlen (cbuf);
+		while (len && (cbuf[len-1] == '\n' || cbuf[len-1] == '\r')) cbuf[--len] = '\0';
+		sf->line.push_back (cbuf);
+	}
+	fclose (f);
+	return sf;
+}
+
+FILEHANDLE StubNewFile ()
+{
+	StubFile *sf = new StubFile;
+	sf->pos = 0;
+	return sf;
+}
+
+FILEHANDLE StubCopyFile (FILEHANDLE f)
+{
+	StubFile *sf = new StubFile;
+	sf->line = ((StubFile*)f)->line;
+	sf->pos = 0;
+	return sf;
+}
+
+void StubAddLine (FILEHANDLE f, const char *line)
+{
+	((StubFile*)f)->line.push_back (line);
+}
+
+void StubRewind (FILEHANDLE f)
+{
+	((StubFile*)f)->pos = 0;
+}
+
+size_t StubFileSize (FILEHANDLE f)
+{
+	return ((StubFile*)f)->line.size();
+}
+
+void StubCloseFile (FILEHANDLE f)
+{
+	delete (StubFile*)f;
+}
+
+// Value of "item = value" (case-insensitive item), or NULL
+static const char *FindItem (FILEHANDLE f, const char *item)
+{
+	StubFile *sf = (StubFile*)f;
+	size_t len = strlen (item);
+	for (size_t i = 0; i < sf->line.size(); i++) {
+		const char *p = sf->line[i].c_str();
+		while (*p == ' ' || *p == '\t') p++;
+		if (strncasecmp (p, item, len)) continue;
+		p += len;
+		while (*p == ' ' || *p == '\t') p++;
+		if (*p++ != '=') continue;
+		while (*p == ' ' || *p == '\t') p++;
+		return p;
+	}
+	return NULL;
+}
+
+bool oapiReadItem_string (FILEHANDLE f, char *item, char *string)
+{
+	SDKCALL();
+	const char *p = FindItem (f, item);
+	if (!p) return false;
+	strcpy (string, p);
+	return true;
+}
+
+bool oapiReadItem_float (FILEHANDLE f, char *item, double &val)
+{
+	SDKCALL();
+	const char *p = FindItem (f, item);
+	return (p && sscanf (p, "%lf", &val) == 1);
+}
+
+bool oapiReadItem_int (FILEHANDLE f, char *item, int &val)
+{
+	SDKCALL();
+	const char *p = FindItem (f, item);
+	return (p && sscanf (p, "%d", &val) == 1);
+}
+
+bool oapiReadItem_bool (FILEHANDLE f, char *item, bool &val)
+{
+	SDKCALL();
+	const char *p = FindItem (f, item);
+	if (!p) return false;
+	if (!strncasecmp (p, "true", 4)) val = true;
+	else if (!strncasecmp (p, "false", 5)) val = false;
+	else return false;
+	return true;
+}
+
+bool oapiReadItem_vec (FILEHANDLE f, char *item, VECTOR3 &val)
+{
+	SDKCALL();
+	const char *p = FindItem (f, item);
+	return (p && sscanf (p, "%lf%lf%lf", &val.x, &val.y, &val.z) == 3);
+}
+
+bool oapiReadScenario_nextline (FILEHANDLE f, char *&line)
+{
+	SDKCALL();
+	StubFile *sf = (StubFile*)f;
+	while (sf->pos < sf->line.size()) {
+		const char *p = sf->line[sf->pos++].c_str();
+		while (*p == ' ' || *p == '\t') p++;
+		if (!*p || *p == ';') continue;
+		if (!strncasecmp (p, "END", 3) && !isalnum (p[3])) return false;
+		strncpy (sf->buf, p, 1023);
+		sf->buf[1023] = '\0';
+		line = sf->buf;
+		return true;
+	}
+	return false;
+}
+
+void oapiWriteLine (FILEHANDLE f, char *line)
+{
+	SDKCALL();
+	StubAddLine (f, line);
+}
+
+void oapiWriteScenario_string (FILEHANDLE scn, char *item, char *string)
+{
+	SDKCALL();
+	std::string s = std::string("  ") + item + " " + string;
+	StubAddLine (scn, s.c_str());
+}
+
+void oapiWriteScenario_int (FILEHANDLE scn, char *item, int i)
+{
+	SDKCALL();
+	char cbuf[256];
+	snprintf (cbuf, 256, "  %s %d", item, i);
+	StubAddLine (scn, cbuf);
+}
+
+void oapiWriteScenario_float (FILEHANDLE scn, char *item, double d)
+{
+	SDKCALL();
+	char cbuf[256];
+	snprintf (cbuf, 256, "  %s %g", item, d);
+	StubAddLine (scn, cbuf);
+}
+
+void oapiWriteScenario_vec (FILEHANDLE scn, char *item, const VECTOR3 &vec)
+{
+	SDKCALL();
+	char cbuf[256];
+	snprintf (cbuf, 256, "  %s %g %g %g", item, vec.x, vec.y, vec.z);
+	StubAddLine (scn, cbuf);
+}
+
+// ==============================================================
+// General
+
+double oapiGetSimTime () { SDKCALL(); return g_World.simt; }
+double oapiGetSimStep () { SDKCALL(); return g_World.simdt; }
+double oapiGetSysTime () { SDKCALL(); return g_World.systime; }
+double oapiGetSysStep () { SDKCALL(); return g_World.simdt; }
+double oapiGetSimMJD () { SDKCALL(); return g_World.mjd; }
+double oapiGetTimeAcceleration () { SDKCALL(); return 1.0; }
+double oapiRand () { SDKCALL(); return (double)rand()/(double)RAND_MAX; }
+
+void oapiWriteLog (char *line)
+{
+	SDKCALL();
+	fprintf (stderr, "%s\n", line);
+}
+
+void oapiWriteLogV (const char *format, ...)
+{
+	SDKCALL();
+	va_list ap;
+	va_start (ap, format);
+	vfprintf (stderr, format, ap);
+	va_end (ap);
+	fputc ('\n', stderr);
+}
+
+VESSEL *oapiGetVesselInterface (OBJHANDLE hVessel)
+{
+	SDKCALL();
+	return (hVessel ? ((VESSELSTUB*)hVessel)->iface : NULL);
+}
+
+OBJHANDLE oapiGetFocusObject () { SDKCALL(); return NULL; }
+double oapiGetSize (OBJHANDLE hObj) { SDKCALL(); return 10.0; }
+double oapiGetMass (OBJHANDLE hObj) { SDKCALL(); return 0.0; }
+bool oapiGetObjectName (OBJHANDLE hObj, char *name, int n) { SDKCALL(); if (n) name[0] = '\0'; return false; }
+// the reference body is the only object (vessel handles aren't checked)
+int oapiGetObjectType (OBJHANDLE hObj) { SDKCALL(); return (hObj && hObj == g_World.hPlanet ? OBJTP_PLANET : OBJTP_INVALID); }
+OBJHANDLE oapiGetBasePlanet (OBJHANDLE hBase) { SDKCALL(); return NULL; }
+
+const ATMCONST *oapiGetPlanetAtmConstants (OBJHANDLE hPlanet)
+{
+	SDKCALL();
+	return (hPlanet ? &g_World.atm : NULL);
+}
+
+double oapiGetWaveDrag (double M, double M1, double M2, double M3, double cmax)
+{
+	SDKCALL();
+	// same piecewise model as Orbiter
+	if (M < M1) return 0.0;
+	else if (M < M2) return cmax * (M-M1)/(M2-M1);
+	else if (M < M3) return cmax;
+	else return cmax * sqrt ((M3*M3-1.0)/(M*M-1.0));
+}
+
+double oapiGetInducedDrag (double cl, double A, double e)
+{
+	SDKCALL();
+	return cl*cl/(PI*A*e);
+}
+
+void oapiGlobalToEqu (OBJHANDLE hObj, const VECTOR3 &glob, double *lng, double *lat, double *rad)
+{
+	SDKCALL();
+	*lng = *lat = 0.0;
+	*rad = 6.371e6;
+}
+
+bool oapiGetNavData (NAVHANDLE hNav, NAVDATA *data) { SDKCALL(); return false; }
+void oapiGetNavPos (NAVHANDLE hNav, VECTOR3 *gpos) { SDKCALL(); *gpos = _V(0,0,0); }
+DWORD oapiGetNavType (NAVHANDLE hNav) { SDKCALL(); return TRANSMITTER_NONE; }
+float oapiGetNavFreq (NAVHANDLE hNav) { SDKCALL(); return 0.0f; }
+
+// ==============================================================
+// Meshes
+
+struct StubMesh {
+	std::vector<MESHGROUP> grp;
+};
+
+MESHHANDLE oapiLoadMeshGlobal (const char *fname) { SDKCALL(); return new StubMesh; }
+
+MESHHANDLE oapiCreateMesh (DWORD ngrp, MESHGROUP *grp)
+{
+	SDKCALL();
+	StubMesh *mesh = new StubMesh;
+	for (DWORD i = 0; i < ngrp; i++)
+		mesh->grp.push_back (grp[i]);
+	return mesh;
+}
+
+void oapiDeleteMesh (MESHHANDLE hMesh) { SDKCALL(); delete (StubMesh*)hMesh; }
+
+MESHGROUP *oapiMeshGroup (MESHHANDLE hMesh, DWORD idx)
+{
+	SDKCALL();
+	StubMesh *mesh = (StubMesh*)hMesh;
+	return (mesh && idx < mesh->grp.size() ? &mesh->grp[idx] : NULL);
+}
+
+MESHGROUP *oapiMeshGroup (DEVMESHHANDLE hMesh, DWORD idx) { SDKCALL(); return NULL; }
+
+DWORD oapiAddMeshGroup (MESHHANDLE hMesh, MESHGROUP *grp)
+{
+	SDKCALL();
+	StubMesh *mesh = (StubMesh*)hMesh;
+	mesh->grp.push_back (*grp);
+	return (DWORD)mesh->grp.size()-1;
+}
+
+bool oapiAddMeshGroupBlock (MESHHANDLE hMesh, DWORD grpidx, const NTVERTEX *vtx, DWORD nvtx, const WORD *idx, DWORD nidx) { SDKCALL(); return true; }
+int oapiEditMeshGroup (MESHHANDLE hMesh, DWORD grpidx, GROUPEDITSPEC *ges) { SDKCALL(); return 0; }
+int oapiEditMeshGroup (DEVMESHHANDLE hMesh, DWORD grpidx, GROUPEDITSPEC *ges) { SDKCALL(); return 0; }
+bool oapiSetTexture (MESHHANDLE hMesh, DWORD texidx, SURFHANDLE tex) { SDKCALL(); return true; }
+bool oapiSetTexture (DEVMESHHANDLE hMesh, DWORD texidx, SURFHANDLE tex) { SDKCALL(); return true; }
+SURFHANDLE oapiGetTextureHandle (MESHHANDLE hMesh, DWORD texidx) { SDKCALL(); return NULL; }
+
+// ==============================================================
+// Surfaces and drawing
+
+SURFHANDLE oapiLoadTexture (const char *fname, bool dynamic) { SDKCALL(); return DUMMY; }
+void oapiReleaseTexture (SURFHANDLE hTex) { SDKCALL(); }
+SURFHANDLE oapiCreateSurface (int width, int height) { SDKCALL(); return NULL; }
+SURFHANDLE oapiCreateSurface (HBITMAP hBmp, bool release_bmp) { SDKCALL(); return NULL; }
+SURFHANDLE oapiCreateTextureSurface (int width, int height) { SDKCALL(); return NULL; }
+void oapiDestroySurface (SURFHANDLE surf) { SDKCALL(); }
+void oapiSetSurfaceColourKey (SURFHANDLE surf, DWORD ckey) { SDKCALL(); }
+DWORD oapiGetColour (DWORD red, DWORD green, DWORD blue) { SDKCALL(); return red | (green << 8) | (blue << 16); }
+bool oapiBlt (SURFHANDLE tgt, SURFHANDLE src, int tgtx, int tgty, int srcx, int srcy, int w, int h, DWORD ck) { SDKCALL(); return true; }
+bool oapiColourFill (SURFHANDLE tgt, DWORD fillcolor, int tgtx, int tgty, int w, int h) { SDKCALL(); return true; }
+HDC oapiGetDC (SURFHANDLE surf) { SDKCALL(); return NULL; }
+void oapiReleaseDC (SURFHANDLE surf, HDC hDC) { SDKCALL(); }
+oapi::Sketchpad *oapiGetSketchpad (SURFHANDLE surf) { SDKCALL(); return NULL; }
+void oapiReleaseSketchpad (oapi::Sketchpad *skp) { SDKCALL(); }
+oapi::Font *oapiCreateFont (int height, bool prop, char *face, int style) { SDKCALL(); return NULL; }
+void oapiReleaseFont (oapi::Font *font) { SDKCALL(); }
+void oapiRenderHUD (MESHHANDLE hMesh, SURFHANDLE *hTex) { SDKCALL(); }
+PSTREAM_HANDLE oapiParticleSetLevelRef (PSTREAM_HANDLE ph, double *lvl) { SDKCALL(); return ph; }
+SURFHANDLE oapiRegisterParticleTexture (char *path) { SDKCALL(); return DUMMY; }
+
+// ==============================================================
+// Cockpit, panels, HUD and MFDs
+
+int oapiCockpitMode () { SDKCALL(); return COCKPIT_GENERIC; }
+void oapiCameraSetCockpitDir (double polar, double azimuth, bool transition) { SDKCALL(); }
+int oapiGetHUDMode () { SDKCALL(); return HUD_NONE; }
+bool oapiSetHUDMode (int mode) { SDKCALL(); return false; }
+void oapiIncHUDIntensity () { SDKCALL(); }
+void oapiDecHUDIntensity () { SDKCALL(); }
+void oapiToggleHUDColour () { SDKCALL(); }
+void oapiToggleMFD_on (int mfd) { SDKCALL(); }
+void oapiRegisterMFD (int mfd, const MFDSPEC &spec) { SDKCALL(); }
+void oapiRegisterMFD (int mfd, const void *spec) { SDKCALL(); }
+const char *oapiMFDButtonLabel (int mfd, int bt) { SDKCALL(); return NULL; }
+void oapiProcessMFDButton (int mfd, int bt, int event) { SDKCALL(); }
+bool oapiSendMFDKey (int mfd, DWORD key) { SDKCALL(); return false; }
+void oapiRegisterPanelBackground (HBITMAP hBmp, DWORD flag, DWORD ck) { SDKCALL(); }
+void oapiRegisterPanelArea (int id, const RECT &pos, int draw_event, int mouse_event, int bkmode) { SDKCALL(); }
+void oapiSetPanelNeighbours (int left, int right, int top, int bottom) { SDKCALL(); }
+void oapiTriggerPanelRedrawArea (int panel_id, int area_id) { SDKCALL(); }
+void oapiTriggerRedrawArea (int panel_id, int vc_id, int area_id) { SDKCALL(); }
+bool oapiBltPanelAreaBackground (int area_id, SURFHANDLE surf) { SDKCALL(); return false; }
+void oapiSetDefNavDisplay (int mode) { SDKCALL(); }
+void oapiSetDefRCSDisplay (int mode) { SDKCALL(); }
+void oapiVCRegisterArea (int id, const RECT &tgtrect, int draw_event, int mouse_event, int bkmode, SURFHANDLE tgt) { SDKCALL(); }
+void oapiVCRegisterArea (int id, int draw_event, int mouse_event) { SDKCALL(); }
+void oapiVCSetAreaClickmode_Spherical (int id, const VECTOR3 &cnt, double rad) { SDKCALL(); }
+void oapiVCSetAreaClickmode_Quadrilateral (int id, const VECTOR3 &p1, const VECTOR3 &p2, const VECTOR3 &p3, const VECTOR3 &p4) { SDKCALL(); }
+void oapiVCSetNeighbours (int left, int right, int top, int bottom) { SDKCALL(); }
+void oapiVCTriggerRedrawArea (int vc_id, int area_id) { SDKCALL(); }
+void oapiVCRegisterMFD (int mfd, const VCMFDSPEC *spec) { SDKCALL(); }
+void oapiVCRegisterHUD (const VCHUDSPEC *spec) { SDKCALL(); }
+
+// ==============================================================
+// Dialogs and help
+
+HWND oapiOpenDialog (HINSTANCE hDLLInst, int resourceId, DLGPROC msgProc, void *context) { SDKCALL(); return NULL; }
+HWND oapiOpenDialogEx (HINSTANCE hDLLInst, int resourceId, DLGPROC msgProc, DWORD flag, void *context) { SDKCALL(); return NULL; }
+HWND oapiFindDialog (HINSTANCE hDLLInst, int resourceId) { SDKCALL(); return NULL; }
+void oapiCloseDialog (HWND hDlg) { SDKCALL(); }
+void *oapiGetDialogContext (HWND hDlg) { SDKCALL(); return NULL; }
+INT_PTR oapiDefDialogProc (HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lParam) { SDKCALL(); return 0; }
+bool oapiOpenHelp (HELPCONTEXT *hcontext) { SDKCALL(); return false; }
+void oapiRegisterCustomControls (HINSTANCE hInst) { SDKCALL(); }
+void oapiUnregisterCustomControls (HINSTANCE hInst) { SDKCALL(); }
+void oapiSetGaugeParams (HWND hCtrl, GAUGEPARAM *gp, bool redraw) { SDKCALL(); }
+void oapiSetGaugePos (HWND hCtrl, int pos, bool redraw) { SDKCALL(); }
+
+// ==============================================================
+// Script interpreters. The host has no Lua; commands are dropped.
+
+INTERPRETERHANDLE oapiCreateInterpreter () { SDKCALL(); return DUMMY; }
+int oapiDelInterpreter (INTERPRETERHANDLE hInterp) { SDKCALL(); return 0; }
+bool oapiExecScriptCmd (INTERPRETERHANDLE hInterp, const char *cmd) { SDKCALL(); return false; }
+bool oapiAsyncScriptCmd (INTERPRETERHANDLE hInterp, const char *cmd) { SDKCALL(); return false; }
+
+// ==============================================================
+// MFD
+
+MFD::MFD (DWORD w, DWORD h, VESSEL *v) { SDKCALL(); }
+
+// ==============================================================
+// VESSEL
+
+VESSEL::VESSEL (OBJHANDLE hVessel, int fmodel)
+{
+	SDKCALL();
+	stub = (VESSELSTUB*)hVessel;
+	stub->iface = this;
+}
+
+VESSEL::~VESSEL ()
+{
+	SDKCALL();
+	stub->iface = NULL;
+}
+
+OBJHANDLE VESSEL::GetHandle () const { SDKCALL(); return stub; }
+char *VESSEL::GetName () const { SDKCALL(); return (char*)stub->name.c_str(); }
+char *VESSEL::GetClassName () const { SDKCALL(); return (char*)stub->classname.c_str(); }
+int VESSEL::GetFlightModel () const { SDKCALL(); return 1; }
+int VESSEL::GetDamageModel () const { SDKCALL(); return 0; }
+bool VESSEL::GetEnableFocus () const { SDKCALL(); return true; }
+double VESSEL::GetSize () const { SDKCALL(); return 10.0; }
+void VESSEL::SetSize (double size) const { SDKCALL(); }
+void VESSEL::SetVisibilityLimit (double vislimit, double spotlimit) const { SDKCALL(); }
+void VESSEL::SetAlbedoRGB (const VECTOR3 &albedo) const { SDKCALL(); }
+double VESSEL::GetEmptyMass () const { SDKCALL(); return stub->emptymass; }
+void VESSEL::SetEmptyMass (double m) const { SDKCALL(); stub->emptymass = m; }
+double VESSEL::GetMass () const { SDKCALL(); return Mass (stub); }
+void VESSEL::GetPMI (VECTOR3 &pmi) const { SDKCALL(); pmi = _V(15,22,8); }
+void VESSEL::SetPMI (const VECTOR3 &pmi) const { SDKCALL(); }
+void VESSEL::SetCrossSections (const VECTOR3 &cs) const { SDKCALL(); }
+void VESSEL::SetGravityGradientDamping (double damp) const { SDKCALL(); }
+void VESSEL::SetRotDrag (const VECTOR3 &rd) const { SDKCALL(); }
+void VESSEL::SetCW (double cw_z_pos, double cw_z_neg, double cw_x, double cw_y) const { SDKCALL(); }
+void VESSEL::SetWingAspect (double aspect) const { SDKCALL(); }
+void VESSEL::SetWingEffectiveness (double eff) const { SDKCALL(); }
+void VESSEL::SetSurfaceFrictionCoeff (double mu_lng, double mu_lat) const { SDKCALL(); }
+void VESSEL::SetTouchdownPoints (const VECTOR3 &pt1, const VECTOR3 &pt2, const VECTOR3 &pt3) const { SDKCALL(); }
+void VESSEL::SetMaxWheelbrakeForce (double f) const { SDKCALL(); }
+
+void VESSEL::SetWheelbrakeLevel (double level, int which, bool permanent) const
+{
+	SDKCALL();
+	if (which == 0 || which == 1) stub->wbrake[1] = level;
+	if (which == 0 || which == 2) stub->wbrake[2] = level;
+}
+
+double VESSEL::GetWheelbrakeLevel (int which) const
+{
+	SDKCALL();
+	return (which == 0 ? 0.5*(stub->wbrake[1]+stub->wbrake[2]) : stub->wbrake[which]);
+}
+
+void VESSEL::SetNosewheelSteering (bool activate) const { SDKCALL(); }
+bool VESSEL::GroundContact () const { SDKCALL(); return g_World.ground; }
+void VESSEL::SetDockParams (const VECTOR3 &pos, const VECTOR3 &dir, const VECTOR3 &rot) const { SDKCALL(); }
+void VESSEL::SetCameraOffset (const VECTOR3 &co) const { SDKCALL(); }
+void VESSEL::SetCameraDefaultDirection (const VECTOR3 &cd) const { SDKCALL(); }
+void VESSEL::SetCameraDefaultDirection (const VECTOR3 &cd, double tilt) const { SDKCALL(); }
+void VESSEL::SetCameraRotationRange (double left, double right, double up, double down) const { SDKCALL(); }
+void VESSEL::SetCameraShiftRange (const VECTOR3 &fpos, const VECTOR3 &lpos, const VECTOR3 &rpos) const { SDKCALL(); }
+void VESSEL::SetCameraMovement (const VECTOR3 &fpos, double fphi, double ftht,
+	const VECTOR3 &lpos, double lphi, double ltht, const VECTOR3 &rpos, double rphi, double rtht) const { SDKCALL(); }
+bool VESSEL::Undock (UINT n, const OBJHANDLE exclude) const { SDKCALL(); return false; }
+OBJHANDLE VESSEL::GetDockStatus (DOCKHANDLE hDock) const { SDKCALL(); return NULL; }
+DOCKHANDLE VESSEL::GetDockHandle (UINT n) const { SDKCALL(); return NULL; }
+UINT VESSEL::DockCount () const { SDKCALL(); return 0; }
+
+void VESSEL::GetStatusEx (void *status) const
+{
+	SDKCALL();
+	VESSELSTATUS2 *vs = (VESSELSTATUS2*)status;
+	DWORD version = vs->version;
+	memset (vs, 0, sizeof(VESSELSTATUS2));
+	vs->version = version;
+	vs->status = (g_World.ground ? 1 : 0);
+	vs->rbody = g_World.hPlanet;
+}
+
+OBJHANDLE VESSEL::GetSurfaceRef () const { SDKCALL(); return g_World.hPlanet; }
+OBJHANDLE VESSEL::GetAtmRef () const { SDKCALL(); return (g_World.rho > 0.0 ? g_World.hPlanet : NULL); }
+OBJHANDLE VESSEL::GetGravityRef () const { SDKCALL(); return g_World.hPlanet; }
+double VESSEL::GetAltitude () const { SDKCALL(); return g_World.alt; }
+double VESSEL::GetPitch () const { SDKCALL(); return g_World.pitch; }
+double VESSEL::GetBank () const { SDKCALL(); return g_World.bank; }
+double VESSEL::GetYaw () const { SDKCALL(); return g_World.yaw; }
+double VESSEL::GetAOA () const { SDKCALL(); return g_World.aoa; }
+double VESSEL::GetSlipAngle () const { SDKCALL(); return g_World.slip; }
+double VESSEL::GetAirspeed () const { SDKCALL(); return g_World.airspeed; }
+double VESSEL::GetGroundspeed () const { SDKCALL(); return g_World.airspeed; }
+double VESSEL::GetMachNumber () const { SDKCALL(); return g_World.mach; }
+double VESSEL::GetDynPressure () const { SDKCALL(); return 0.5*g_World.rho*g_World.airspeed*g_World.airspeed; }
+double VESSEL::GetAtmPressure () const { SDKCALL(); return g_World.p; }
+double VESSEL::GetAtmTemperature () const { SDKCALL(); return g_World.T; }
+double VESSEL::GetAtmDensity () const { SDKCALL(); return g_World.rho; }
+
+double VESSEL::GetLift () const
+{
+	SDKCALL();
+	// thin airfoil lift of a 48 m^2 wing
+	return 0.5*g_World.rho*g_World.airspeed*g_World.airspeed * 48.0 * PI2*g_World.aoa;
+}
+
+double VESSEL::GetDrag () const
+{
+	SDKCALL();
+	return 0.5*g_World.rho*g_World.airspeed*g_World.airspeed * 48.0 * 0.02;
+}
+
+bool VESSEL::GetAirspeedVector (REFFRAME frame, VECTOR3 &v) const
+{
+	SDKCALL();
+	double V = g_World.airspeed;
+	v = _V(V*sin (g_World.slip), -V*sin (g_World.aoa), V*cos (g_World.aoa)*cos (g_World.slip));
+	return true;
+}
+
+bool VESSEL::GetHorizonAirspeedVector (VECTOR3 &v) const
+{
+	SDKCALL();
+	v = _V(0, 0, g_World.airspeed);
+	return true;
+}
+
+bool VESSEL::GetWeightVector (VECTOR3 &G) const
+{
+	SDKCALL();
+	G = _V(0, -Mass (stub)*9.81, 0);
+	return true;
+}
+
+bool VESSEL::GetThrustVector (VECTOR3 &T) const
+{
+	SDKCALL();
+	T = _V(0,0,0);
+	for (size_t i = 0; i < stub->thruster.size(); i++) {
+		StubThruster *th = stub->thruster[i];
+		T += th->dir * (th->level*th->max0);
+	}
+	return length (T) > 0.0;
+}
+
+void VESSEL::GetAngularVel (VECTOR3 &avel) const { SDKCALL(); avel = _V(0,0,0); }
+void VESSEL::GetAngularAcc (VECTOR3 &aacc) const { SDKCALL(); aacc = _V(0,0,0); }
+void VESSEL::GetAngularMoment (VECTOR3 &amom) const { SDKCALL(); amom = _V(0,0,0); }
+void VESSEL::GetGlobalPos (VECTOR3 &pos) const { SDKCALL(); pos = _V(0, 6.371e6+g_World.alt, 0); }
+
+OBJHANDLE VESSEL::GetEquPos (double &longitude, double &latitude, double &radius) const
+{
+	SDKCALL();
+	longitude = latitude = 0.0;
+	radius = 6.371e6 + g_World.alt;
+	return g_World.hPlanet;
+}
+
+void VESSEL::GetRelativePos (OBJHANDLE hRef, VECTOR3 &pos) const { SDKCALL(); pos = _V(0,0,0); }
+void VESSEL::GetRelativeVel (OBJHANDLE hRef, VECTOR3 &vel) const { SDKCALL(); vel = _V(0,0,0); }
+void VESSEL::GlobalRot (const VECTOR3 &rloc, VECTOR3 &rglob) const { SDKCALL(); rglob = rloc; }
+void VESSEL::HorizonRot (const VECTOR3 &rloc, VECTOR3 &rhorizon) const { SDKCALL(); rhorizon = rloc; }
+
+// --------------------------------------------------------------
+// Propellant and thrusters
+
+PROPELLANT_HANDLE VESSEL::CreatePropellantResource (double maxmass, double mass, double efficiency) const
+{
+	SDKCALL();
+	StubPropellant *ph = new StubPropellant;
+	ph->maxmass = maxmass;
+	ph->mass = (mass < 0.0 ? maxmass : mass);
+	ph->efficiency = efficiency;
+	stub->prop.push_back (ph);
+	return ph;
+}
+
+void VESSEL::SetDefaultPropellantResource (PROPELLANT_HANDLE ph) const { SDKCALL(); }
+double VESSEL::GetPropellantMaxMass (PROPELLANT_HANDLE ph) const { SDKCALL(); return ((StubPropellant*)ph)->maxmass; }
+void VESSEL::SetPropellantMaxMass (PROPELLANT_HANDLE ph, double maxmass) const { SDKCALL(); ((StubPropellant*)ph)->maxmass = maxmass; }
+double VESSEL::GetPropellantMass (PROPELLANT_HANDLE ph) const { SDKCALL(); return ((StubPropellant*)ph)->mass; }
+void VESSEL::SetPropellantMass (PROPELLANT_HANDLE ph, double mass) const { SDKCALL(); ((StubPropellant*)ph)->mass = mass; }
+
+double VESSEL::GetPropellantFlowrate (PROPELLANT_HANDLE ph) const
+{
+	SDKCALL();
+	double rate = 0.0;
+	for (size_t i = 0; i < stub->thruster.size(); i++) {
+		StubThruster *th = stub->thruster[i];
+		if (th->res == ph && th->isp > 0.0) rate += th->level*th->max0/th->isp;
+	}
+	return rate;
+}
+
+double VESSEL::GetTotalPropellantMass () const
+{
+	SDKCALL();
+	return Mass (stub) - stub->emptymass;
+}
+
+THRUSTER_HANDLE VESSEL::CreateThruster (const VECTOR3 &pos, const VECTOR3 &dir, double maxth0,
+	PROPELLANT_HANDLE hp, double isp0, double isp_ref, double p_ref) const
+{
+	SDKCALL();
+	StubThruster *th = new StubThruster;
+	th->pos = pos;
+	th->dir = dir;
+	th->max0 = maxth0;
+	th->isp = th->isp0 = isp0;
+	th->level = 0.0;
+	th->res = (StubPropellant*)hp;
+	stub->thruster.push_back (th);
+	return th;
+}
+
+bool VESSEL::DelThruster (THRUSTER_HANDLE &th) const { SDKCALL(); return false; }
+void VESSEL::SetThrusterResource (THRUSTER_HANDLE th, PROPELLANT_HANDLE ph) const { SDKCALL(); ((StubThruster*)th)->res = (StubPropellant*)ph; }
+void VESSEL::SetThrusterRef (THRUSTER_HANDLE th, const VECTOR3 &pos) const { SDKCALL(); ((StubThruster*)th)->pos = pos; }
+void VESSEL::GetThrusterRef (THRUSTER_HANDLE th, VECTOR3 &pos) const { SDKCALL(); pos = ((StubThruster*)th)->pos; }
+void VESSEL::SetThrusterDir (THRUSTER_HANDLE th, const VECTOR3 &dir) const { SDKCALL(); ((StubThruster*)th)->dir = dir; }
+void VESSEL::GetThrusterDir (THRUSTER_HANDLE th, VECTOR3 &dir) const { SDKCALL(); dir = ((StubThruster*)th)->dir; }
+void VESSEL::SetThrusterMax0 (THRUSTER_HANDLE th, double maxth0) const { SDKCALL(); ((StubThruster*)th)->max0 = maxth0; }
+double VESSEL::GetThrusterMax0 (THRUSTER_HANDLE th) const { SDKCALL(); return ((StubThruster*)th)->max0; }
+double VESSEL::GetThrusterMax (THRUSTER_HANDLE th) const { SDKCALL(); return ((StubThruster*)th)->max0; }
+void VESSEL::SetThrusterIsp (THRUSTER_HANDLE th, double isp) const { SDKCALL(); ((StubThruster*)th)->isp = ((StubThruster*)th)->isp0 = isp; }
+void VESSEL::SetThrusterIsp (THRUSTER_HANDLE th, double isp, double isp_ref, double p_ref) const { SDKCALL(); ((StubThruster*)th)->isp = ((StubThruster*)th)->isp0 = isp; }
+double VESSEL::GetThrusterIsp (THRUSTER_HANDLE th) const { SDKCALL(); return ((StubThruster*)th)->isp; }
+double VESSEL::GetThrusterIsp0 (THRUSTER_HANDLE th) const { SDKCALL(); return ((StubThruster*)th)->isp0; }
+
+void VESSEL::SetThrusterLevel (THRUSTER_HANDLE th, double level) const
+{
+	SDKCALL();
+	((StubThruster*)th)->level = max (0.0, min (1.0, level));
+}
+
+void VESSEL::IncThrusterLevel (THRUSTER_HANDLE th, double dlevel) const
+{
+	SDKCALL();
+	StubThruster *t = (StubThruster*)th;
+	t->level = max (0.0, min (1.0, t->level + dlevel));
+}
+
+double VESSEL::GetThrusterLevel (THRUSTER_HANDLE th) const { SDKCALL(); return ((StubThruster*)th)->level; }
+
+double VESSEL::GetThrusterFlowRate (THRUSTER_HANDLE th) const
+{
+	SDKCALL();
+	StubThruster *t = (StubThruster*)th;
+	return (t->isp > 0.0 ? t->level*t->max0/t->isp : 0.0);
+}
+
+THGROUP_HANDLE VESSEL::CreateThrusterGroup (THRUSTER_HANDLE *th, int nth, THGROUP_TYPE thgt) const
+{
+	SDKCALL();
+	StubGroup *grp;
+	if (thgt <= THGROUP_ATT_BACK) {
+		grp = stub->group+thgt;
+		grp->th.clear();
+	} else {
+		grp = new StubGroup;
+		stub->usergroup.push_back (grp);
+	}
+	for (int i = 0; i < nth; i++)
+		grp->th.push_back ((StubThruster*)th[i]);
+	return grp;
+}
+
+bool VESSEL::DelThrusterGroup (THGROUP_HANDLE &thg, THGROUP_TYPE thgt, bool delth) const
+{
+	SDKCALL();
+	((StubGroup*)thg)->th.clear();
+	thg = NULL;
+	return true;
+}
+
+THGROUP_HANDLE VESSEL::GetThrusterGroupHandle (THGROUP_TYPE thgt) const
+{
+	SDKCALL();
+	return (thgt <= THGROUP_ATT_BACK && stub->group[thgt].th.size() ? stub->group+thgt : NULL);
+}
+
+THRUSTER_HANDLE VESSEL::GetGroupThruster (THGROUP_TYPE thgt, DWORD idx) const
+{
+	SDKCALL();
+	return (thgt <= THGROUP_ATT_BACK && idx < stub->group[thgt].th.size() ? stub->group[thgt].th[idx] : NULL);
+}
+
+THRUSTER_HANDLE VESSEL::GetGroupThruster (THGROUP_HANDLE thg, DWORD idx) const
+{
+	SDKCALL();
+	StubGroup *grp = (StubGroup*)thg;
+	return (idx < grp->th.size() ? grp->th[idx] : NULL);
+}
+
+DWORD VESSEL::GetGroupThrusterCount (THGROUP_TYPE thgt) const
+{
+	SDKCALL();
+	return (thgt <= THGROUP_ATT_BACK ? (DWORD)stub->group[thgt].th.size() : 0);
+}
+
+DWORD VESSEL::GetGroupThrusterCount (THGROUP_HANDLE thg) const
+{
+	SDKCALL();
+	return (DWORD)((StubGroup*)thg)->th.size();
+}
+
+static void SetGroupLevel (StubGroup *grp, double level)
+{
+	level = max (0.0, min (1.0, level));
+	for (size_t i = 0; i < grp->th.size(); i++)
+		grp->th[i]->level = level;
+}
+
+static double GroupLevel (const StubGroup *grp)
+{
+	double level = 0.0;
+	for (size_t i = 0; i < grp->th.size(); i++)
+		level += grp->th[i]->level;
+	return (grp->th.size() ? level/grp->th.size() : 0.0);
+}
+
+void VESSEL::SetThrusterGroupLevel (THGROUP_TYPE thgt, double level) const
+{
+	SDKCALL();
+	if (thgt <= THGROUP_ATT_BACK) SetGroupLevel (stub->group+thgt, level);
+}
+
+void VESSEL::SetThrusterGroupLevel (THGROUP_HANDLE thg, double level) const
+{
+	SDKCALL();
+	SetGroupLevel ((StubGroup*)thg, level);
+}
+
+void VESSEL::IncThrusterGroupLevel (THGROUP_TYPE thgt, double dlevel) const
+{
+	SDKCALL();
+	if (thgt <= THGROUP_ATT_BACK) SetGroupLevel (stub->group+thgt, GroupLevel (stub->group+thgt) + dlevel);
+}
+
+double VESSEL::GetThrusterGroupLevel (THGROUP_TYPE thgt) const
+{
+	SDKCALL();
+	return (thgt <= THGROUP_ATT_BACK ? GroupLevel (stub->group+thgt) : 0.0);
+}
+
+double VESSEL::GetThrusterGroupLevel (THGROUP_HANDLE thg) const
+{
+	SDKCALL();
+	return GroupLevel ((StubGroup*)thg);
+}
+
+int VESSEL::GetAttitudeMode () const { SDKCALL(); return stub->attmode; }
+bool VESSEL::SetAttitudeMode (int mode) const { SDKCALL(); stub->attmode = mode; return true; }
+int VESSEL::ToggleAttitudeMode () const { SDKCALL(); return stub->attmode = (stub->attmode == RCS_ROT ? RCS_LIN : RCS_ROT); }
+DWORD VESSEL::GetADCtrlMode () const { SDKCALL(); return stub->adcmode; }
+void VESSEL::SetADCtrlMode (DWORD mode) const { SDKCALL(); stub->adcmode = mode; }
+UINT VESSEL::AddExhaust (THRUSTER_HANDLE th, double lscale, double wscale, SURFHANDLE tex) const { SDKCALL(); return 0; }
+UINT VESSEL::AddExhaust (THRUSTER_HANDLE th, double lscale, double wscale, const VECTOR3 &pos, const VECTOR3 &dir, SURFHANDLE tex) const { SDKCALL(); return 0; }
+UINT VESSEL::AddExhaust (EXHAUSTSPEC *spec) { SDKCALL(); return 0; }
+PSTREAM_HANDLE VESSEL::AddExhaustStream (THRUSTER_HANDLE th, PARTICLESTREAMSPEC *pss) const { SDKCALL(); return DUMMY; }
+PSTREAM_HANDLE VESSEL::AddExhaustStream (THRUSTER_HANDLE th, const VECTOR3 &pos, PARTICLESTREAMSPEC *pss) const { SDKCALL(); return DUMMY; }
+bool VESSEL::DelExhaustStream (PSTREAM_HANDLE ch) const { SDKCALL(); return true; }
+
+// --------------------------------------------------------------
+// Aerodynamics
+
+AIRFOILHANDLE VESSEL::CreateAirfoil3 (AIRFOIL_ORIENTATION align, const VECTOR3 &ref, AirfoilCoeffFuncEx cf,
+	void *context, double c, double S, double A) const
+{
+	SDKCALL();
+	StubAirfoil *af = new StubAirfoil;
+	af->align = align;
+	af->cf = cf;
+	af->context = context;
+	stub->airfoil.push_back (af);
+	return af;
+}
+
+AIRFOILHANDLE VESSEL::CreateAirfoil (AIRFOIL_ORIENTATION align, const VECTOR3 &ref, AirfoilCoeffFunc cf,
+	double c, double S, double A) const { SDKCALL(); return DUMMY; }
+bool VESSEL::EditAirfoil (AIRFOILHANDLE hAirfoil, DWORD flag, const VECTOR3 &ref, AirfoilCoeffFunc cf,
+	double c, double S, double A) const { SDKCALL(); return true; }
+bool VESSEL::DelAirfoil (AIRFOILHANDLE hAirfoil) const
+{
+	SDKCALL();
+	std::vector<StubAirfoil*>::iterator it = std::find (stub->airfoil.begin(), stub->airfoil.end(), (StubAirfoil*)hAirfoil);
+	if (it == stub->airfoil.end()) return false;
+	delete *it;
+	stub->airfoil.erase (it);
+	return true;
+}
+
+void VESSEL::ClearAirfoilDefinitions () const
+{
+	SDKCALL();
+	for (size_t i = 0; i < stub->airfoil.size(); i++)
+		delete stub->airfoil[i];
+	stub->airfoil.clear ();
+}
+CTRLSURFHANDLE VESSEL::CreateControlSurface2 (AIRCTRL_TYPE type, double area, double dCl, const VECTOR3 &ref,
+	int axis, UINT anim) const { SDKCALL(); return DUMMY; }
+CTRLSURFHANDLE VESSEL::CreateControlSurface3 (AIRCTRL_TYPE type, double area, double dCl, const VECTOR3 &ref,
+	int axis, double delay, UINT anim) const { SDKCALL(); return DUMMY; }
+bool VESSEL::DelControlSurface (CTRLSURFHANDLE hCtrlSurface) const { SDKCALL(); return true; }
+void VESSEL::SetControlSurfaceLevel (AIRCTRL_TYPE type, double level) const { SDKCALL(); stub->ctrlsurf[type] = level; }
+void VESSEL::SetControlSurfaceLevel (AIRCTRL_TYPE type, double level, bool direct) const { SDKCALL(); stub->ctrlsurf[type] = level; }
+double VESSEL::GetControlSurfaceLevel (AIRCTRL_TYPE type) const { SDKCALL(); return stub->ctrlsurf[type]; }
+void VESSEL::CreateVariableDragElement (const double *drag, double factor, const VECTOR3 &ref) const { SDKCALL(); }
+void VESSEL::ClearVariableDragElements () const { SDKCALL(); }
+
+// --------------------------------------------------------------
+// Meshes, animations and lights
+
+UINT VESSEL::AddMesh (const char *meshname, const VECTOR3 *ofs) const { SDKCALL(); return stub->nmesh++; }
+UINT VESSEL::AddMesh (MESHHANDLE hMesh, const VECTOR3 *ofs) const { SDKCALL(); return stub->nmesh++; }
+bool VESSEL::InsertMesh (const char *meshname, UINT idx, const VECTOR3 *ofs) const { SDKCALL(); stub->nmesh++; return true; }
+void VESSEL::ClearMeshes () const { SDKCALL(); stub->nmesh = 0; }
+void VESSEL::ClearMeshes (bool retainAnim) const { SDKCALL(); stub->nmesh = 0; }
+void VESSEL::SetMeshVisibilityMode (UINT meshidx, WORD mode) const { SDKCALL(); }
+bool VESSEL::ShiftMeshes (const VECTOR3 &ofs) const { SDKCALL(); return true; }
+MESHHANDLE VESSEL::GetMeshTemplate (UINT idx) const { SDKCALL(); return NULL; }
+MESHHANDLE VESSEL::CopyMeshFromTemplate (UINT idx) const { SDKCALL(); return NULL; }
+DEVMESHHANDLE VESSEL::GetDevMesh (VISHANDLE vis, UINT idx) const { SDKCALL(); return NULL; }
+void VESSEL::MeshModified (MESHHANDLE hMesh, UINT grp, DWORD modflag) { SDKCALL(); }
+
+UINT VESSEL::CreateAnimation (double initial_state) const
+{
+	SDKCALL();
+	stub->anim.push_back (initial_state);
+	return (UINT)stub->anim.size()-1;
+}
+
+bool VESSEL::DelAnimation (UINT anim) const { SDKCALL(); return anim < stub->anim.size(); }
+
+ANIMATIONCOMPONENT_HANDLE VESSEL::AddAnimationComponent (UINT anim, double state0, double state1,
+	MGROUP_TRANSFORM *trans, ANIMATIONCOMPONENT_HANDLE parent) const
+{
+	SDKCALL();
+	return DUMMY;
+}
+
+bool VESSEL::SetAnimation (UINT anim, double state) const
+{
+	SDKCALL();
+	if (anim >= stub->anim.size()) return false;
+	stub->anim[anim] = state;
+	return true;
+}
+
+double VESSEL::GetAnimation (UINT anim) const
+{
+	SDKCALL();
+	return (anim < stub->anim.size() ? stub->anim[anim] : 0.0);
+}
+
+void VESSEL::ClearBeacons () { SDKCALL(); }
+void VESSEL::AddBeacon (BEACONLIGHTSPEC *bs) { SDKCALL(); }
+bool VESSEL::DelBeacon (BEACONLIGHTSPEC *bs) { SDKCALL(); return true; }
+const BEACONLIGHTSPEC *VESSEL::GetBeacon (DWORD idx) const { SDKCALL(); return NULL; }
+
+LightEmitter *VESSEL::AddSpotLight (const VECTOR3 &pos, const VECTOR3 &dir, double range, double att0,
+	double att1, double att2, double umbra, double penumbra, COLOUR4 diffuse, COLOUR4 specular, COLOUR4 ambient)
+{
+	SDKCALL();
+	return new SpotLight (stub, pos, dir, range, att0, att1, att2, umbra, penumbra, diffuse, specular, ambient);
+}
+
+LightEmitter *VESSEL::AddPointLight (const VECTOR3 &pos, double range, double att0, double att1, double att2,
+	COLOUR4 diffuse, COLOUR4 specular, COLOUR4 ambient)
+{
+	SDKCALL();
+	return new PointLight (stub, pos, range, att0, att1, att2, diffuse, specular, ambient);
+}
+
+void VESSEL::ClearLightEmitters () { SDKCALL(); }
+
+// --------------------------------------------------------------
+// Navigation
+
+NAVHANDLE VESSEL::GetNavSource (DWORD n) const { SDKCALL(); return NULL; }
+DWORD VESSEL::GetNavmodeState (int mode) const { SDKCALL(); return (stub->navmode >> mode) & 1; }
+bool VESSEL::ActivateNavmode (int mode) { SDKCALL(); stub->navmode |= (1u << mode); return true; }
+bool VESSEL::DeactivateNavmode (int mode) { SDKCALL(); stub->navmode &= ~(1u << mode); return true; }
+bool VESSEL::ToggleNavmode (int mode) { SDKCALL(); stub->navmode ^= (1u << mode); return true; }
+bool VESSEL::GetNavRecv (DWORD n) const { SDKCALL(); return false; }
+void VESSEL::InitNavRadios (DWORD nnav) const { SDKCALL(); }
+bool VESSEL::SetNavRecv (DWORD n, DWORD ch) const { SDKCALL(); return true; }
+DWORD VESSEL::GetNavCount () const { SDKCALL(); return 0; }
+void VESSEL::EnableTransponder (bool enable) const { SDKCALL(); }
+bool VESSEL::SetTransponderChannel (DWORD ch) const { SDKCALL(); return true; }
+void VESSEL::SetEnableFocus (bool enable) const { SDKCALL(); }
+
+// --------------------------------------------------------------
+// Miscellaneous
+
+bool VESSEL::RegisterAnimation () const { SDKCALL(); return true; }
+bool VESSEL::Playback () const { SDKCALL(); return false; }
+bool VESSEL::RecordEvent (const char *event_type, const char *event) const { SDKCALL(); return false; }
+void VESSEL::AddForce (const VECTOR3 &F, const VECTOR3 &r) const { SDKCALL(); }
+PSTREAM_HANDLE VESSEL::AddParticleStream (PARTICLESTREAMSPEC *pss, const VECTOR3 &pos, const VECTOR3 &dir, double *lvl) const { SDKCALL(); return DUMMY; }
+void VESSEL::ParseScenarioLineEx (char *line, void *status) const { SDKCALL(); }
+
+// ==============================================================
+// VESSEL2, VESSEL3
+
+VESSEL2::VESSEL2 (OBJHANDLE hVessel, int fmodel): VESSEL (hVessel, fmodel) {}
+
+void VESSEL2::clbkSaveState (FILEHANDLE scn) { SDKCALL(); }
+void VESSEL2::clbkLoadStateEx (FILEHANDLE scn, void *status)
+{
+	SDKCALL();
+	char *line;
+	while (oapiReadScenario_nextline (scn, line))
+		ParseScenarioLineEx (line, status);
+}
+void VESSEL2::DefSetStateEx (const void *status) const { SDKCALL(); }
+
+VESSEL3::VESSEL3 (OBJHANDLE hVessel, int fmodel): VESSEL2 (hVessel, fmodel) {}
+
+bool VESSEL3::clbkDrawHUD (int mode, const HUDPAINTSPEC *hps, oapi::Sketchpad *skp) { SDKCALL(); return true; }
+int VESSEL3::SetPanelBackground (PANELHANDLE hPanel, SURFHANDLE *hSurf, DWORD nsurf, MESHHANDLE hMesh,
+	DWORD width, DWORD height, DWORD baseline, DWORD scrollflag) { SDKCALL(); return 0; }
+int VESSEL3::SetPanelScaling (PANELHANDLE hPanel, double defscale, double extscale) { SDKCALL(); return 0; }
+int VESSEL3::RegisterPanelMFDGeometry (PANELHANDLE hPanel, int MFD_id, int nmesh, int ngroup) { SDKCALL(); return 0; }
+int VESSEL3::RegisterPanelArea (PANELHANDLE hPanel, int id, const RECT &pos, int texidx, const RECT &texpos,
+	int draw_event, int mouse_event, int bkmode) { SDKCALL(); return 0; }
+int VESSEL3::RegisterPanelArea (PANELHANDLE hPanel, int id, const RECT &pos, int draw_event, int mouse_event,
+	SURFHANDLE surf, void *context) { SDKCALL(); return 0; }
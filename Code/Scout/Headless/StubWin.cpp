@@ -0,0 +1,406 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// StubWin.cpp
+// Headless host: Win32 subset on top of pthreads and POSIX files
+// ==============================================================
+
+#include <windows.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+// ==============================================================
+// Kernel objects. All handles point to a StubObject; the type
+// field tells them apart.
+
+struct StubObject {
+	enum Type { THREAD, EVENT, SEMAPHORE, FILE, MAPPING } type;
+	pthread_mutex_t mtx;
+	pthread_cond_t cond;
+	bool manual;   // event: manual reset
+	bool signaled; // event: signaled, thread: finished
+	LONG count;    // semaphore count
+	LONG maxcount; // semaphore limit
+	pthread_t thread;
+	LPTHREAD_START_ROUTINE func;
+	LPVOID prm;
+	int fd;        // file, mapping: file descriptor
+	size_t size;   // mapping: file size
+};
+
+static StubObject *NewObject (StubObject::Type type)
+{
+	StubObject *obj = new StubObject;
+	memset (obj, 0, sizeof(StubObject));
+	obj->type = type;
+	obj->fd = -1;
+	pthread_mutex_init (&obj->mtx, NULL);
+	pthread_cond_init (&obj->cond, NULL);
+	return obj;
+}
+
+static void *ThreadEntry (void *p)
+{
+	StubObject *obj = (StubObject*)p;
+	obj->func (obj->prm);
+	pthread_mutex_lock (&obj->mtx);
+	obj->signaled = true;
+	pthread_cond_broadcast (&obj->cond);
+	pthread_mutex_unlock (&obj->mtx);
+	return NULL;
+}
+
+HANDLE CreateThread (void *sa, SIZE_T stack, LPTHREAD_START_ROUTINE func, LPVOID prm, DWORD flags, LPDWORD id)
+{
+	StubObject *obj = NewObject (StubObject::THREAD);
+	obj->func = func;
+	obj->prm = prm;
+	if (pthread_create (&obj->thread, NULL, ThreadEntry, obj)) {
+		delete obj;
+		return NULL;
+	}
+	if (id) *id = 0;
+	return obj;
+}
+
+HANDLE CreateEvent (void *sa, BOOL manual, BOOL initial, LPCSTR name)
+{
+	StubObject *obj = NewObject (StubObject::EVENT);
+	obj->manual = (manual != FALSE);
+	obj->signaled = (initial != FALSE);
+	return obj;
+}
+
+HANDLE CreateSemaphore (void *sa, LONG initial, LONG maxcount, LPCSTR name)
+{
+	StubObject *obj = NewObject (StubObject::SEMAPHORE);
+	obj->count = initial;
+	obj->maxcount = maxcount;
+	return obj;
+}
+
+BOOL SetEvent (HANDLE h)
+{
+	StubObject *obj = (StubObject*)h;
+	pthread_mutex_lock (&obj->mtx);
+	obj->signaled = true;
+	pthread_cond_broadcast (&obj->cond);
+	pthread_mutex_unlock (&obj->mtx);
+	return TRUE;
+}
+
+BOOL ResetEvent (HANDLE h)
+{
+	StubObject *obj = (StubObject*)h;
+	pthread_mutex_lock (&obj->mtx);
+	obj->signaled = false;
+	pthread_mutex_unlock (&obj->mtx);
+	return TRUE;
+}
+
+BOOL ReleaseSemaphore (HANDLE h, LONG n, LONG *prev)
+{
+	StubObject *obj = (StubObject*)h;
+	pthread_mutex_lock (&obj->mtx);
+	if (prev) *prev = obj->count;
+	bool ok = (obj->count + n <= obj->maxcount);
+	if (ok) {
+		obj->count += n;
+		pthread_cond_broadcast (&obj->cond);
+	}
+	pthread_mutex_unlock (&obj->mtx);
+	return ok;
+}
+
+// Try to take the object without blocking (mutex held)
+static bool Acquire (StubObject *obj)
+{
+	switch (obj->type) {
+	case StubObject::EVENT:
+		if (!obj->signaled) return false;
+		if (!obj->manual) obj->signaled = false;
+		return true;
+	case StubObject::SEMAPHORE:
+		if (obj->count <= 0) return false;
+		obj->count--;
+		return true;
+	case StubObject::THREAD:
+		return obj->signaled;
+	default:
+		return true;
+	}
+}
+
+DWORD WaitForSingleObject (HANDLE h, DWORD ms)
+{
+	StubObject *obj = (StubObject*)h;
+	struct timespec until;
+	if (ms != INFINITE) {
+		clock_gettime (CLOCK_REALTIME, &until);
+		until.tv_sec += ms/1000;
+		until.tv_nsec += (ms%1000)*1000000L;
+		if (until.tv_nsec >= 1000000000L) until.tv_sec++, until.tv_nsec -= 1000000000L;
+	}
+	pthread_mutex_lock (&obj->mtx);
+	while (!Acquire (obj)) {
+		if (ms == 0 ||
+			(ms == INFINITE ? pthread_cond_wait (&obj->cond, &obj->mtx) :
+			 pthread_cond_timedwait (&obj->cond, &obj->mtx, &until)) == ETIMEDOUT) {
+			pthread_mutex_unlock (&obj->mtx);
+			return WAIT_TIMEOUT;
+		}
+	}
+	pthread_mutex_unlock (&obj->mtx);
+	return WAIT_OBJECT_0;
+}
+
+DWORD WaitForMultipleObjects (DWORD n, const HANDLE *h, BOOL all, DWORD ms)
+{
+	// polling is good enough for the shutdown paths that use it
+	for (DWORD t = 0;; t++) {
+		if (all) {
+			DWORD i;
+			for (i = 0; i < n; i++)
+				if (WaitForSingleObject (h[i], 0) != WAIT_OBJECT_0) break;
+			if (i == n) return WAIT_OBJECT_0;
+		} else {
+			for (DWORD i = 0; i < n; i++)
+				if (WaitForSingleObject (h[i], 0) == WAIT_OBJECT_0) return WAIT_OBJECT_0+i;
+		}
+		if (ms != INFINITE && t >= ms) return WAIT_TIMEOUT;
+		usleep (1000);
+	}
+}
+
+BOOL CloseHandle (HANDLE h)
+{
+	StubObject *obj = (StubObject*)h;
+	if (!obj || h == INVALID_HANDLE_VALUE) return FALSE;
+	switch (obj->type) {
+	case StubObject::THREAD:
+		pthread_detach (obj->thread);
+		return TRUE; // the thread may still use obj
+	case StubObject::FILE:
+	case StubObject::MAPPING:
+		if (obj->fd >= 0) close (obj->fd);
+		break;
+	default:
+		break;
+	}
+	pthread_cond_destroy (&obj->cond);
+	pthread_mutex_destroy (&obj->mtx);
+	delete obj;
+	return TRUE;
+}
+
+void Sleep (DWORD ms)
+{
+	usleep (ms*1000);
+}
+
+DWORD GetCurrentThreadId ()
+{
+	return (DWORD)syscall (SYS_gettid);
+}
+
+HANDLE GetCurrentThread ()
+{
+	return (HANDLE)(intptr_t)-2;
+}
+
+BOOL SetThreadPriority (HANDLE h, int prio)
+{
+	return TRUE;
+}
+
+BOOL QueryThreadCycleTime (HANDLE h, ULONGLONG *cycles)
+{
+	// CPU time of the calling thread in ns, in place of cycles
+	struct timespec t;
+	clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t);
+	*cycles = (ULONGLONG)t.tv_sec*1000000000ULL + t.tv_nsec;
+	return TRUE;
+}
+
+BOOL GetThreadTimes (HANDLE h, FILETIME *create, FILETIME *exit, FILETIME *kernel, FILETIME *user)
+{
+	struct timespec t;
+	clock_gettime (CLOCK_THREAD_CPUTIME_ID, &t);
+	ULONGLONG t100 = (ULONGLONG)t.tv_sec*10000000ULL + t.tv_nsec/100;
+	memset (kernel, 0, sizeof(FILETIME));
+	user->dwLowDateTime  = (DWORD)t100;
+	user->dwHighDateTime = (DWORD)(t100 >> 32);
+	return TRUE;
+}
+
+// ==============================================================
+// Critical sections (recursive, as in Win32)
+
+void InitializeCriticalSection (CRITICAL_SECTION *cs)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init (&attr);
+	pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_t *m = new pthread_mutex_t;
+	pthread_mutex_init (m, &attr);
+	pthread_mutexattr_destroy (&attr);
+	cs->impl = m;
+}
+
+void DeleteCriticalSection (CRITICAL_SECTION *cs)
+{
+	pthread_mutex_t *m = (pthread_mutex_t*)cs->impl;
+	pthread_mutex_destroy (m);
+	delete m;
+	cs->impl = NULL;
+}
+
+void EnterCriticalSection (CRITICAL_SECTION *cs)
+{
+	pthread_mutex_lock ((pthread_mutex_t*)cs->impl);
+}
+
+void LeaveCriticalSection (CRITICAL_SECTION *cs)
+{
+	pthread_mutex_unlock ((pthread_mutex_t*)cs->impl);
+}
+
+// ==============================================================
+// Timers and system information
+
+BOOL QueryPerformanceCounter (LARGE_INTEGER *t)
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	t->QuadPart = (LONGLONG)ts.tv_sec*1000000000LL + ts.tv_nsec;
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency (LARGE_INTEGER *f)
+{
+	f->QuadPart = 1000000000LL;
+	return TRUE;
+}
+
+DWORD GetTickCount ()
+{
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (DWORD)(ts.tv_sec*1000 + ts.tv_nsec/1000000);
+}
+
+void GetSystemInfo (SYSTEM_INFO *si)
+{
+	memset (si, 0, sizeof(SYSTEM_INFO));
+	si->dwPageSize = (DWORD)sysconf (_SC_PAGESIZE);
+	si->dwNumberOfProcessors = (DWORD)sysconf (_SC_NPROCESSORS_ONLN);
+}
+
+// ==============================================================
+// Files. Paths use '\' as separator in the sources.
+
+DWORD g_FileDelay = 0;
+
+HANDLE CreateFile (LPCSTR name, DWORD access, DWORD share, void *sa, DWORD disp, DWORD flags, HANDLE tmpl)
+{
+	char path[MAX_PATH];
+	int i;
+	if (g_FileDelay) Sleep (g_FileDelay);
+	for (i = 0; name[i] && i < MAX_PATH-1; i++)
+		path[i] = (name[i] == '\\' ? '/' : name[i]);
+	path[i] = '\0';
+	int fd = open (path, O_RDONLY);
+	if (fd < 0) return INVALID_HANDLE_VALUE;
+	StubObject *obj = NewObject (StubObject::FILE);
+	obj->fd = fd;
+	return obj;
+}
+
+DWORD GetFileSize (HANDLE h, LPDWORD high)
+{
+	struct stat st;
+	if (fstat (((StubObject*)h)->fd, &st)) return INVALID_FILE_SIZE;
+	if (high) *high = (DWORD)((ULONGLONG)st.st_size >> 32);
+	return (DWORD)st.st_size;
+}
+
+BOOL ReadFile (HANDLE h, LPVOID buf, DWORD n, LPDWORD nread, void *ovl)
+{
+	ssize_t r = read (((StubObject*)h)->fd, buf, n);
+	if (r < 0) return FALSE;
+	if (nread) *nread = (DWORD)r;
+	return TRUE;
+}
+
+HANDLE CreateFileMapping (HANDLE h, void *sa, DWORD prot, DWORD sizehigh, DWORD sizelow, LPCSTR name)
+{
+	struct stat st;
+	StubObject *file = (StubObject*)h;
+	if (!file || h == INVALID_HANDLE_VALUE || fstat (file->fd, &st) || !st.st_size) return NULL;
+	StubObject *obj = NewObject (StubObject::MAPPING);
+	obj->fd = dup (file->fd);
+	obj->size = st.st_size;
+	return obj;
+}
+
+LPVOID MapViewOfFile (HANDLE hMap, DWORD access, DWORD ofshigh, DWORD ofslow, SIZE_T n)
+{
+	StubObject *obj = (StubObject*)hMap;
+	void *p = mmap (NULL, obj->size, PROT_READ, MAP_PRIVATE, obj->fd, 0);
+	return (p == MAP_FAILED ? NULL : p);
+}
+
+BOOL UnmapViewOfFile (LPCVOID p)
+{
+	// the size isn't known here; the mapping is released on exit
+	return TRUE;
+}
+
+// ==============================================================
+// GDI, windows and dialogs (no-ops)
+
+HFONT CreateFont (int h, int w, int esc, int orient, int weight, DWORD italic, DWORD underline,
+	DWORD strikeout, DWORD charset, DWORD outprec, DWORD clipprec, DWORD quality, DWORD pitch, LPCSTR face)
+{ return NULL; }
+HBRUSH CreateSolidBrush (COLORREF col) { return NULL; }
+HPEN CreatePen (int style, int width, COLORREF col) { return NULL; }
+HGDIOBJ GetStockObject (int i) { return NULL; }
+HGDIOBJ SelectObject (HDC hDC, HGDIOBJ obj) { return NULL; }
+BOOL DeleteObject (HGDIOBJ obj) { return TRUE; }
+HDC CreateCompatibleDC (HDC hDC) { return NULL; }
+BOOL DeleteDC (HDC hDC) { return TRUE; }
+BOOL BitBlt (HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, DWORD rop) { return TRUE; }
+BOOL StretchBlt (HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, DWORD rop) { return TRUE; }
+BOOL TextOut (HDC hDC, int x, int y, LPCSTR str, int len) { return TRUE; }
+COLORREF SetTextColor (HDC hDC, COLORREF col) { return 0; }
+COLORREF SetBkColor (HDC hDC, COLORREF col) { return 0; }
+int SetBkMode (HDC hDC, int mode) { return 0; }
+UINT SetTextAlign (HDC hDC, UINT align) { return 0; }
+BOOL MoveToEx (HDC hDC, int x, int y, POINT *p) { return TRUE; }
+BOOL LineTo (HDC hDC, int x, int y) { return TRUE; }
+BOOL Rectangle (HDC hDC, int l, int t, int r, int b) { return TRUE; }
+BOOL Ellipse (HDC hDC, int l, int t, int r, int b) { return TRUE; }
+BOOL Polygon (HDC hDC, const POINT *p, int n) { return TRUE; }
+BOOL Polyline (HDC hDC, const POINT *p, int n) { return TRUE; }
+int FillRect (HDC hDC, const RECT *r, HBRUSH br) { return 0; }
+HBITMAP LoadBitmap (HINSTANCE hInst, LPCSTR name) { return NULL; }
+
+LRESULT SendMessage (HWND hWnd, UINT msg, WPARAM wp, LPARAM lp) { return 0; }
+LRESULT SendDlgItemMessage (HWND hWnd, int id, UINT msg, WPARAM wp, LPARAM lp) { return 0; }
+HWND GetDlgItem (HWND hWnd, int id) { return NULL; }
+int GetDlgCtrlID (HWND hWnd) { return 0; }
+BOOL SetWindowText (HWND hWnd, LPCSTR str) { return TRUE; }
+int GetWindowText (HWND hWnd, LPSTR str, int n) { if (n) str[0] = '\0'; return 0; }
+BOOL EnableWindow (HWND hWnd, BOOL enable) { return FALSE; }
+BOOL ShowWindow (HWND hWnd, int cmd) { return FALSE; }
+UINT GetDlgItemInt (HWND hWnd, int id, BOOL *ok, BOOL sign) { if (ok) *ok = FALSE; return 0; }
+BOOL SetDlgItemInt (HWND hWnd, int id, UINT val, BOOL sign) { return TRUE; }
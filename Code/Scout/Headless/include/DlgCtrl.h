@@ -0,0 +1,16 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// DlgCtrl.h
+// Headless host: custom dialog controls (declared in Orbitersdk.h)
+// ==============================================================
+
+#ifndef __DLGCTRL_H
+#define __DLGCTRL_H
+
+#include "Orbitersdk.h"
+
+#endif // !__DLGCTRL_H
@@ -0,0 +1,1004 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Orbitersdk.h
+// Headless host: stub Orbiter API, for building the Scout sources
+// on Linux and driving them without the simulator
+//
+// Notes:
+// * Declares the subset of the Orbiter API (oapi* functions,
+//   VESSEL/VESSEL2/VESSEL3, handles and structures) that the Scout
+//   sources use, with the signatures of the Orbiter 2010 SDK.
+// * The implementations in StubSdk.cpp record every call (see
+//   SdkStub.h) and answer with values from a simple per-vessel
+//   state: thrusters, propellant, mass and control surfaces are
+//   stored, while the flight state (altitude, airspeed, atmosphere)
+//   is set by the host.
+// * Graphics, panel, dialog and scripting functions only return
+//   null handles.
+// ==============================================================
+
+#ifndef __ORBITERSDK_H
+#define __ORBITERSDK_H
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define OAPIFUNC
+#define DLLCLBK extern "C"
+
+// ==============================================================
+// Constants
+
+const double PI    = 3.14159265358979323846;
+const double PI05  = 1.57079632679489661923;
+const double PI2   = 6.28318530717958647692;
+const double RAD   = PI/180.0;
+const double DEG   = 180.0/PI;
+const double C0    = 299792458.0;
+const double TAUA  = 86400.0*365.25;
+const double AU    = 149597870691.0;
+const double GGRAV = 6.67259e-11;
+const double G     = 9.81;
+const double ATMP  = 101.4e3;
+const double ATMD  = 1.293;
+
+// ==============================================================
+// Vectors and matrices
+
+typedef union {
+	double data[3];
+	struct { double x, y, z; };
+} VECTOR3;
+
+typedef union {
+	double data[9];
+	struct { double m11, m12, m13, m21, m22, m23, m31, m32, m33; };
+} MATRIX3;
+
+typedef union {
+	double data[4];
+	struct { double x, y, z, w; };
+} VECTOR4;
+
+typedef struct {
+	float r, g, b, a;
+} COLOUR4;
+
+inline VECTOR3 _V (double x, double y, double z) { VECTOR3 v = {{x,y,z}}; return v; }
+inline void veccpy (VECTOR3 &a, const VECTOR3 &b) { a = b; }
+inline VECTOR3 operator+ (const VECTOR3 &a, const VECTOR3 &b) { return _V(a.x+b.x, a.y+b.y, a.z+b.z); }
+inline VECTOR3 operator- (const VECTOR3 &a, const VECTOR3 &b) { return _V(a.x-b.x, a.y-b.y, a.z-b.z); }
+inline VECTOR3 operator- (const VECTOR3 &a) { return _V(-a.x, -a.y, -a.z); }
+inline VECTOR3 operator* (const VECTOR3 &a, double f) { return _V(a.x*f, a.y*f, a.z*f); }
+inline VECTOR3 operator/ (const VECTOR3 &a, double f) { return _V(a.x/f, a.y/f, a.z/f); }
+inline VECTOR3 &operator+= (VECTOR3 &a, const VECTOR3 &b) { a.x += b.x, a.y += b.y, a.z += b.z; return a; }
+inline VECTOR3 &operator-= (VECTOR3 &a, const VECTOR3 &b) { a.x -= b.x, a.y -= b.y, a.z -= b.z; return a; }
+inline VECTOR3 &operator*= (VECTOR3 &a, double f) { a.x *= f, a.y *= f, a.z *= f; return a; }
+inline VECTOR3 &operator/= (VECTOR3 &a, double f) { a.x /= f, a.y /= f, a.z /= f; return a; }
+inline double dotp (const VECTOR3 &a, const VECTOR3 &b) { return a.x*b.x + a.y*b.y + a.z*b.z; }
+inline VECTOR3 crossp (const VECTOR3 &a, const VECTOR3 &b)
+{ return _V(a.y*b.z - b.y*a.z, a.z*b.x - b.z*a.x, a.x*b.y - b.x*a.y); }
+inline double length (const VECTOR3 &a) { return sqrt (dotp (a, a)); }
+inline double dist (const VECTOR3 &a, const VECTOR3 &b) { return length (a-b); }
+inline void normalise (VECTOR3 &a) { a /= length (a); }
+inline VECTOR3 unit (const VECTOR3 &a) { return a / length (a); }
+inline VECTOR3 mul (const MATRIX3 &A, const VECTOR3 &b)
+{ return _V(A.m11*b.x + A.m12*b.y + A.m13*b.z, A.m21*b.x + A.m22*b.y + A.m23*b.z, A.m31*b.x + A.m32*b.y + A.m33*b.z); }
+inline VECTOR3 tmul (const MATRIX3 &A, const VECTOR3 &b)
+{ return _V(A.m11*b.x + A.m21*b.y + A.m31*b.z, A.m12*b.x + A.m22*b.y + A.m32*b.z, A.m13*b.x + A.m23*b.y + A.m33*b.z); }
+
+// ==============================================================
+// Handles
+
+typedef void *OBJHANDLE;
+typedef void *VISHANDLE;
+typedef void *MESHHANDLE;
+typedef int  *DEVMESHHANDLE;
+typedef void *SURFHANDLE;
+typedef void *PANELHANDLE;
+typedef void *FILEHANDLE;
+typedef void *INTERPRETERHANDLE;
+typedef void *THRUSTER_HANDLE;
+typedef void *PROPELLANT_HANDLE;
+typedef void *THGROUP_HANDLE;
+typedef void *PSTREAM_HANDLE;
+typedef void *AIRFOILHANDLE;
+typedef void *CTRLSURFHANDLE;
+typedef void *NAVHANDLE;
+typedef void *ANIMATIONCOMPONENT_HANDLE;
+typedef void *DOCKHANDLE;
+typedef void *ATTACHMENTHANDLE;
+typedef void *BEACONHANDLE;
+typedef void *LAUNCHPADITEM_HANDLE;
+
+// ==============================================================
+// Enumerations and flags
+
+enum THGROUP_TYPE {
+	THGROUP_MAIN, THGROUP_RETRO, THGROUP_HOVER,
+	THGROUP_ATT_PITCHUP, THGROUP_ATT_PITCHDOWN, THGROUP_ATT_YAWLEFT, THGROUP_ATT_YAWRIGHT,
+	THGROUP_ATT_BANKLEFT, THGROUP_ATT_BANKRIGHT, THGROUP_ATT_RIGHT, THGROUP_ATT_LEFT,
+	THGROUP_ATT_UP, THGROUP_ATT_DOWN, THGROUP_ATT_FORWARD, THGROUP_ATT_BACK,
+	THGROUP_USER = 0x40
+};
+
+enum AIRCTRL_TYPE {
+	AIRCTRL_ELEVATOR, AIRCTRL_RUDDER, AIRCTRL_AILERON, AIRCTRL_FLAP,
+	AIRCTRL_ELEVATORTRIM, AIRCTRL_RUDDERTRIM
+};
+#define AIRCTRL_AXIS_AUTO 0
+#define AIRCTRL_AXIS_YPOS 1
+#define AIRCTRL_AXIS_YNEG 2
+#define AIRCTRL_AXIS_XPOS 3
+#define AIRCTRL_AXIS_XNEG 4
+
+enum AIRFOIL_ORIENTATION { LIFT_VERTICAL, LIFT_HORIZONTAL };
+enum REFFRAME { FRAME_GLOBAL, FRAME_LOCAL, FRAME_REFLOCAL, FRAME_HORIZON };
+
+#define RCS_NONE 0
+#define RCS_ROT  1
+#define RCS_LIN  2
+
+#define HUD_NONE     0
+#define HUD_ORBIT    1
+#define HUD_SURFACE  2
+#define HUD_DOCKING  3
+
+#define MFD_LEFT     0
+#define MFD_RIGHT    1
+
+#define NAVMODE_KILLROT    1
+#define NAVMODE_HLEVEL     2
+#define NAVMODE_PROGRADE   3
+#define NAVMODE_RETROGRADE 4
+#define NAVMODE_NORMAL     5
+#define NAVMODE_ANTINORMAL 6
+#define NAVMODE_HOLDALT    7
+
+#define TRANSMITTER_NONE 0
+#define TRANSMITTER_VOR  1
+#define TRANSMITTER_VTOL 2
+#define TRANSMITTER_ILS  3
+#define TRANSMITTER_IDS  4
+#define TRANSMITTER_XPDR 5
+
+#define OBJTP_INVALID   0
+#define OBJTP_GENERIC   1
+#define OBJTP_CBODY     2
+#define OBJTP_STAR      3
+#define OBJTP_PLANET    4
+#define OBJTP_VESSEL   10
+#define OBJTP_SURFBASE 20
+
+#define VS_FUELRESET    0x00000001
+#define VS_FUELLIST     0x00000002
+#define VS_THRUSTRESET  0x00000004
+#define VS_THRUSTLIST   0x00000008
+#define VS_DOCKINFOLIST 0x00000010
+
+#define COCKPIT_GENERIC 1
+#define COCKPIT_PANELS  2
+#define COCKPIT_VIRTUAL 3
+
+#define MESHVIS_NEVER    0x00
+#define MESHVIS_EXTERNAL 0x01
+#define MESHVIS_COCKPIT  0x02
+#define MESHVIS_ALWAYS   0x03
+#define MESHVIS_VC       0x04
+#define MESHVIS_EXTPASS  0x10
+
+#define PANEL_REDRAW_NEVER   0x00
+#define PANEL_REDRAW_ALWAYS  0x01
+#define PANEL_REDRAW_MOUSE   0x02
+#define PANEL_REDRAW_INIT    0x03
+#define PANEL_REDRAW_USER    0x04
+#define PANEL_MOUSE_IGNORE     0x00
+#define PANEL_MOUSE_LBDOWN     0x01
+#define PANEL_MOUSE_RBDOWN     0x02
+#define PANEL_MOUSE_LBUP       0x04
+#define PANEL_MOUSE_RBUP       0x08
+#define PANEL_MOUSE_LBPRESSED  0x10
+#define PANEL_MOUSE_RBPRESSED  0x20
+#define PANEL_MOUSE_DOWN       0x03
+#define PANEL_MOUSE_UP         0x0C
+#define PANEL_MOUSE_PRESSED    0x30
+#define PANEL_MOUSE_ONREPLAY   0x40
+#define PANEL_MAP_NONE         0x00
+#define PANEL_MAP_BACKGROUND   0x01
+#define PANEL_MAP_CURRENT      0x02
+#define PANEL_MAP_BGONREQUEST  0x03
+#define PANEL_ATTACH_BOTTOM    0x0001
+#define PANEL_ATTACH_TOP       0x0002
+#define PANEL_ATTACH_LEFT      0x0004
+#define PANEL_ATTACH_RIGHT     0x0008
+#define PANEL_MOVEOUT_BOTTOM   0x0010
+#define PANEL_MOVEOUT_TOP      0x0020
+#define PANEL_MOVEOUT_LEFT     0x0040
+#define PANEL_MOVEOUT_RIGHT    0x0080
+
+#define GRPEDIT_SETUSERFLAG 0x0001
+#define GRPEDIT_ADDUSERFLAG 0x0002
+#define GRPEDIT_DELUSERFLAG 0x0004
+#define GRPEDIT_VTXCRDX     0x0008
+#define GRPEDIT_VTXCRDY     0x0010
+#define GRPEDIT_VTXCRDZ     0x0020
+#define GRPEDIT_VTXCRD      (GRPEDIT_VTXCRDX | GRPEDIT_VTXCRDY | GRPEDIT_VTXCRDZ)
+#define GRPEDIT_VTXNMLX     0x0040
+#define GRPEDIT_VTXNMLY     0x0080
+#define GRPEDIT_VTXNMLZ     0x0100
+#define GRPEDIT_VTXNML      (GRPEDIT_VTXNMLX | GRPEDIT_VTXNMLY | GRPEDIT_VTXNMLZ)
+#define GRPEDIT_VTXTEXU     0x0200
+#define GRPEDIT_VTXTEXV     0x0400
+#define GRPEDIT_VTXTEX      (GRPEDIT_VTXTEXU | GRPEDIT_VTXTEXV)
+#define GRPEDIT_VTX         (GRPEDIT_VTXCRD | GRPEDIT_VTXNML | GRPEDIT_VTXTEX)
+
+#define BEACONSHAPE_COMPACT 0
+#define BEACONSHAPE_DIFFUSE 1
+#define BEACONSHAPE_STAR    2
+
+#define SURF_PREDEF_CK 0xFFFFFFFF
+
+#define DLG_ALLOWMULTI   0x1
+#define DLG_CAPTIONCLOSE 0x2
+#define DLG_CAPTIONHELP  0x4
+
+#define VMSG_LUAINTERPRETER 0x0001
+#define VMSG_LUAINSTANCE    0x0002
+#define VMSG_USER           0x1000
+
+#define KEYMOD_LSHIFT   0x2A
+#define KEYMOD_RSHIFT   0x36
+#define KEYMOD_LCONTROL 0x1D
+#define KEYMOD_RCONTROL 0x9D
+#define KEYMOD_LALT     0x38
+#define KEYMOD_RALT     0xB8
+#define KEYDOWN(buf,key) (buf[key] & 0x80)
+#define RESETKEY(buf,key) (buf[key] = 0)
+#define KEYMOD_SHIFT(buf)   (KEYDOWN(buf,KEYMOD_LSHIFT)   || KEYDOWN(buf,KEYMOD_RSHIFT))
+#define KEYMOD_CONTROL(buf) (KEYDOWN(buf,KEYMOD_LCONTROL) || KEYDOWN(buf,KEYMOD_RCONTROL))
+#define KEYMOD_ALT(buf)     (KEYDOWN(buf,KEYMOD_LALT)     || KEYDOWN(buf,KEYMOD_RALT))
+
+#define OAPI_KEY_ESCAPE   0x01
+#define OAPI_KEY_1        0x02
+#define OAPI_KEY_2        0x03
+#define OAPI_KEY_3        0x04
+#define OAPI_KEY_4        0x05
+#define OAPI_KEY_5        0x06
+#define OAPI_KEY_6        0x07
+#define OAPI_KEY_7        0x08
+#define OAPI_KEY_8        0x09
+#define OAPI_KEY_9        0x0A
+#define OAPI_KEY_0        0x0B
+#define OAPI_KEY_MINUS    0x0C
+#define OAPI_KEY_EQUALS   0x0D
+#define OAPI_KEY_Q        0x10
+#define OAPI_KEY_W        0x11
+#define OAPI_KEY_E        0x12
+#define OAPI_KEY_R        0x13
+#define OAPI_KEY_T        0x14
+#define OAPI_KEY_Y        0x15
+#define OAPI_KEY_U        0x16
+#define OAPI_KEY_I        0x17
+#define OAPI_KEY_O        0x18
+#define OAPI_KEY_P        0x19
+#define OAPI_KEY_A        0x1E
+#define OAPI_KEY_S        0x1F
+#define OAPI_KEY_D        0x20
+#define OAPI_KEY_F        0x21
+#define OAPI_KEY_G        0x22
+#define OAPI_KEY_H        0x23
+#define OAPI_KEY_J        0x24
+#define OAPI_KEY_K        0x25
+#define OAPI_KEY_L        0x26
+#define OAPI_KEY_GRAVE    0x29
+#define OAPI_KEY_Z        0x2C
+#define OAPI_KEY_X        0x2D
+#define OAPI_KEY_C        0x2E
+#define OAPI_KEY_V        0x2F
+#define OAPI_KEY_B        0x30
+#define OAPI_KEY_N        0x31
+#define OAPI_KEY_M        0x32
+#define OAPI_KEY_COMMA    0x33
+#define OAPI_KEY_PERIOD   0x34
+#define OAPI_KEY_SLASH    0x35
+#define OAPI_KEY_SPACE    0x39
+#define OAPI_KEY_F1       0x3B
+#define OAPI_KEY_F2       0x3C
+#define OAPI_KEY_F3       0x3D
+#define OAPI_KEY_F4       0x3E
+#define OAPI_KEY_F5       0x3F
+#define OAPI_KEY_F6       0x40
+#define OAPI_KEY_F7       0x41
+#define OAPI_KEY_F8       0x42
+#define OAPI_KEY_F9       0x43
+#define OAPI_KEY_F10      0x44
+#define OAPI_KEY_NUMPAD7  0x47
+#define OAPI_KEY_NUMPAD8  0x48
+#define OAPI_KEY_NUMPAD9  0x49
+#define OAPI_KEY_SUBTRACT 0x4A
+#define OAPI_KEY_NUMPAD4  0x4B
+#define OAPI_KEY_NUMPAD5  0x4C
+#define OAPI_KEY_NUMPAD6  0x4D
+#define OAPI_KEY_ADD      0x4E
+#define OAPI_KEY_NUMPAD1  0x4F
+#define OAPI_KEY_NUMPAD2  0x50
+#define OAPI_KEY_NUMPAD3  0x51
+#define OAPI_KEY_NUMPAD0  0x52
+#define OAPI_KEY_DECIMAL  0x53
+#define OAPI_KEY_MULTIPLY 0x37
+#define OAPI_KEY_DIVIDE   0xB5
+
+// ==============================================================
+// Structures
+
+typedef struct {
+	float x, y, z;
+	float nx, ny, nz;
+	float tu, tv;
+} NTVERTEX;
+
+typedef struct {
+	NTVERTEX *Vtx;
+	WORD *Idx;
+	DWORD nVtx;
+	DWORD nIdx;
+	DWORD MtrlIdx;
+	DWORD TexIdx;
+	DWORD UsrFlag;
+	WORD zBias;
+	WORD Flags;
+	DWORD TexIdxEx[4];
+	float TexMixEx[4];
+} MESHGROUP;
+
+typedef struct {
+	DWORD flags;
+	DWORD UsrFlag;
+	NTVERTEX *Vtx;
+	DWORD nVtx;
+	WORD *vIdx;
+} GROUPEDITSPEC;
+
+typedef struct {
+	double cp, cv;
+	double gamma;
+	double R;
+	double p0, rho0;
+	double altlimit;
+	double radlimit;
+	double horizonalt;
+	VECTOR3 color0;
+} ATMCONST;
+
+typedef struct {
+	int W, H;
+	int CX, CY;
+	double Scale;
+	int Markersize;
+} HUDPAINTSPEC;
+
+typedef struct {
+	DWORD flags;
+	double srcsize;
+	double srcrate;
+	double v0;
+	double srcspread;
+	double lifetime;
+	double growthrate;
+	double atmslowdown;
+	enum LTYPE { EMISSIVE, DIFFUSE } ltype;
+	enum LEVELMAP { LVL_FLAT, LVL_LIN, LVL_SQRT, LVL_PLIN, LVL_PSQRT } levelmap;
+	double lmin, lmax;
+	enum ATMSMAP { ATM_FLAT, ATM_PLIN, ATM_PLOG } atmsmap;
+	double amin, amax;
+	SURFHANDLE tex;
+} PARTICLESTREAMSPEC;
+
+typedef struct {
+	THRUSTER_HANDLE th;
+	double *level;
+	const VECTOR3 *lpos;
+	const VECTOR3 *ldir;
+	double lsize, wsize;
+	double lofs;
+	double modulate;
+	SURFHANDLE tex;
+	DWORD flags;
+	UINT id;
+} EXHAUSTSPEC;
+
+typedef struct {
+	DWORD shape;
+	VECTOR3 *pos;
+	VECTOR3 *col;
+	double size;
+	double falloff;
+	double period;
+	double duration;
+	double tofs;
+	bool active;
+} BEACONLIGHTSPEC;
+
+typedef struct {
+	DWORD nmesh, ngroup;
+	VECTOR3 hudcnt;
+	double size;
+} VCHUDSPEC;
+
+typedef struct {
+	DWORD nmesh, ngroup;
+} VCMFDSPEC;
+
+typedef struct {
+	RECT pos;
+	int nbt_left, nbt_right;
+	int bt_yofs, bt_ydist;
+} MFDSPEC;
+
+typedef struct {
+	DWORD version;
+	DWORD flag;
+	OBJHANDLE rbody, base;
+	int port;
+	int status;
+	VECTOR3 rpos, rvel, vrot, arot;
+	double surf_lng, surf_lat, surf_hdg;
+	DWORD nfuel;
+	struct FUELSPEC { DWORD idx; double level; } *fuel;
+	DWORD nthruster;
+	struct THRUSTSPEC { DWORD idx; double level; } *thruster;
+	DWORD ndockinfo;
+	struct DOCKINFOSPEC { DWORD idx; DWORD ridx; OBJHANDLE rvessel; } *dockinfo;
+	DWORD xpdr;
+} VESSELSTATUS2;
+
+typedef struct {
+	int type;
+	float freq;
+	union {
+		struct { OBJHANDLE hPlanet; double lng, lat; } vor;
+		struct { OBJHANDLE hBase; int npad; } vtol;
+		struct { OBJHANDLE hBase; double appdir; } ils;
+		struct { OBJHANDLE hVessel; void *hDock; } ids;
+		struct { OBJHANDLE hVessel; } xpdr;
+	};
+} NAVDATA;
+
+typedef struct {
+	char *helpfile;
+	char *topic;
+	char *toc;
+	char *index;
+} HELPCONTEXT;
+
+typedef struct {
+	int rangemin, rangemax;
+	enum GAUGEBASE { LEFT, RIGHT, TOP, BOTTOM } base;
+	enum GAUGECOLOR { BLACK, RED } color;
+} GAUGEPARAM;
+
+// ==============================================================
+// Animation transforms
+
+class MGROUP_TRANSFORM {
+public:
+	enum TYPE { NULLTRANSFORM, ROTATE, TRANSLATE, SCALE };
+	MGROUP_TRANSFORM (): mesh(0), grp(0), ngrp(0) {}
+	MGROUP_TRANSFORM (UINT _mesh, UINT *_grp, UINT _ngrp): mesh(_mesh), grp(_grp), ngrp(_ngrp) {}
+	virtual ~MGROUP_TRANSFORM () {}
+	virtual TYPE Type() const { return NULLTRANSFORM; }
+	UINT mesh;
+	UINT *grp;
+	UINT ngrp;
+};
+
+class MGROUP_ROTATE: public MGROUP_TRANSFORM {
+public:
+	MGROUP_ROTATE (UINT _mesh, UINT *_grp, UINT _ngrp, const VECTOR3 &_ref, const VECTOR3 &_axis, float _angle)
+	: MGROUP_TRANSFORM (_mesh, _grp, _ngrp), ref(_ref), axis(_axis), angle(_angle) {}
+	TYPE Type() const { return ROTATE; }
+	VECTOR3 ref, axis;
+	float angle;
+};
+
+class MGROUP_TRANSLATE: public MGROUP_TRANSFORM {
+public:
+	MGROUP_TRANSLATE (UINT _mesh, UINT *_grp, UINT _ngrp, const VECTOR3 &_shift)
+	: MGROUP_TRANSFORM (_mesh, _grp, _ngrp), shift(_shift) {}
+	TYPE Type() const { return TRANSLATE; }
+	VECTOR3 shift;
+};
+
+class MGROUP_SCALE: public MGROUP_TRANSFORM {
+public:
+	MGROUP_SCALE (UINT _mesh, UINT *_grp, UINT _ngrp, const VECTOR3 &_ref, const VECTOR3 &_scale)
+	: MGROUP_TRANSFORM (_mesh, _grp, _ngrp), ref(_ref), scale(_scale) {}
+	TYPE Type() const { return SCALE; }
+	VECTOR3 ref, scale;
+};
+
+// ==============================================================
+// Light emitters
+
+class LightEmitter {
+public:
+	enum TYPE { LT_NONE, LT_POINT, LT_SPOT, LT_DIRECTIONAL };
+	enum VISIBILITY { VIS_EXTERNAL = 1, VIS_COCKPIT = 2, VIS_ALWAYS = 3 };
+	LightEmitter (): intens(1.0), ref(NULL), active(true) {}
+	virtual ~LightEmitter () {}
+	void SetIntensity (double in) { intens = in; }
+	double GetIntensity () const { return intens; }
+	void SetIntensityRef (double *pin) { ref = pin; }
+	void Activate (bool act) { active = act; }
+	bool IsActive () const { return active; }
+	void SetVisibility (VISIBILITY v) {}
+protected:
+	double intens, *ref;
+	bool active;
+};
+
+class PointLight: public LightEmitter {
+public:
+	PointLight (OBJHANDLE hV, const VECTOR3 &p, double r, double att0, double att1, double att2,
+		COLOUR4 d, COLOUR4 s, COLOUR4 a) {}
+};
+
+class SpotLight: public PointLight {
+public:
+	SpotLight (OBJHANDLE hV, const VECTOR3 &p, const VECTOR3 &d, double r, double att0, double att1, double att2,
+		double umbra, double penumbra, COLOUR4 dc, COLOUR4 sc, COLOUR4 ac)
+	: PointLight (hV, p, r, att0, att1, att2, dc, sc, ac) {}
+};
+
+// ==============================================================
+// Sketchpad (drawing does nothing)
+
+namespace oapi {
+	class Font { public: virtual ~Font () {} };
+	class Pen { public: virtual ~Pen () {} };
+	class Brush { public: virtual ~Brush () {} };
+
+	class Sketchpad {
+	public:
+		enum TAlign_horizontal { LEFT, CENTER, RIGHT };
+		enum TAlign_vertical { TOP, BASELINE, BOTTOM };
+		enum BkgMode { BK_TRANSPARENT, BK_OPAQUE };
+		Sketchpad (SURFHANDLE s = NULL) {}
+		virtual ~Sketchpad () {}
+		Font *SetFont (Font *font) const { return NULL; }
+		Pen *SetPen (Pen *pen) const { return NULL; }
+		Brush *SetBrush (Brush *brush) const { return NULL; }
+		void SetTextAlign (TAlign_horizontal th = LEFT, TAlign_vertical tv = TOP) {}
+		DWORD SetTextColor (DWORD col) { return 0; }
+		DWORD SetBackgroundColor (DWORD col) { return 0; }
+		void SetBackgroundMode (BkgMode mode) {}
+		DWORD GetCharSize () { return 0; }
+		DWORD GetTextWidth (const char *str, int len = 0) { return 0; }
+		bool Text (int x, int y, const char *str, int len) { return true; }
+		void Pixel (int x, int y, DWORD col) {}
+		void MoveTo (int x, int y) {}
+		void LineTo (int x, int y) {}
+		void Line (int x0, int y0, int x1, int y1) {}
+		void Rectangle (int x0, int y0, int x1, int y1) {}
+		void Ellipse (int x0, int y0, int x1, int y1) {}
+		void Polygon (const oapi::Sketchpad *pt, int npt) {}
+		HDC GetDC () { return NULL; }
+	};
+}
+
+#define FONT_NORMAL    0
+#define FONT_BOLD      1
+#define FONT_ITALIC    2
+#define FONT_UNDERLINE 4
+
+// ==============================================================
+// MFD
+
+class VESSEL;
+
+class MFD {
+public:
+	MFD (DWORD w, DWORD h, VESSEL *v);
+	virtual ~MFD () {}
+};
+
+// ==============================================================
+// Vessel interface
+
+typedef void (*AirfoilCoeffFunc)(double aoa, double M, double Re, double *cl, double *cm, double *cd);
+typedef void (*AirfoilCoeffFuncEx)(class VESSEL *v, double aoa, double M, double Re, void *context,
+	double *cl, double *cm, double *cd);
+
+struct VESSELSTUB;
+
+class VESSEL {
+public:
+	VESSEL (OBJHANDLE hVessel, int fmodel = 1);
+	virtual ~VESSEL ();
+	OBJHANDLE GetHandle () const;
+	char *GetName () const;
+	char *GetClassName () const;
+	int GetFlightModel () const;
+	int GetDamageModel () const;
+	bool GetEnableFocus () const;
+	double GetSize () const;
+	void SetSize (double size) const;
+	void SetVisibilityLimit (double vislimit, double spotlimit = -1) const;
+	void SetAlbedoRGB (const VECTOR3 &albedo) const;
+	double GetEmptyMass () const;
+	void SetEmptyMass (double m) const;
+	double GetMass () const;
+	void GetPMI (VECTOR3 &pmi) const;
+	void SetPMI (const VECTOR3 &pmi) const;
+	void SetCrossSections (const VECTOR3 &cs) const;
+	void SetGravityGradientDamping (double damp) const;
+	void SetRotDrag (const VECTOR3 &rd) const;
+	void SetCW (double cw_z_pos, double cw_z_neg, double cw_x, double cw_y) const;
+	void SetWingAspect (double aspect) const;
+	void SetWingEffectiveness (double eff) const;
+	void SetSurfaceFrictionCoeff (double mu_lng, double mu_lat) const;
+	void SetTouchdownPoints (const VECTOR3 &pt1, const VECTOR3 &pt2, const VECTOR3 &pt3) const;
+	void SetMaxWheelbrakeForce (double f) const;
+	void SetWheelbrakeLevel (double level, int which = 0, bool permanent = true) const;
+	double GetWheelbrakeLevel (int which) const;
+	void SetNosewheelSteering (bool activate) const;
+	bool GroundContact () const;
+	void SetDockParams (const VECTOR3 &pos, const VECTOR3 &dir, const VECTOR3 &rot) const;
+	void SetCameraOffset (const VECTOR3 &co) const;
+	void SetCameraDefaultDirection (const VECTOR3 &cd) const;
+	void SetCameraDefaultDirection (const VECTOR3 &cd, double tilt) const;
+	void SetCameraRotationRange (double left, double right, double up, double down) const;
+	void SetCameraShiftRange (const VECTOR3 &fpos, const VECTOR3 &lpos, const VECTOR3 &rpos) const;
+	void SetCameraMovement (const VECTOR3 &fpos, double fphi, double ftht,
+		const VECTOR3 &lpos, double lphi, double ltht, const VECTOR3 &rpos, double rphi, double rtht) const;
+	bool Undock (UINT n, const OBJHANDLE exclude = 0) const;
+	OBJHANDLE GetDockStatus (DOCKHANDLE hDock) const;
+	DOCKHANDLE GetDockHandle (UINT n) const;
+	UINT DockCount () const;
+	void GetStatusEx (void *status) const;
+	OBJHANDLE GetSurfaceRef () const;
+	OBJHANDLE GetAtmRef () const;
+	OBJHANDLE GetGravityRef () const;
+	double GetAltitude () const;
+	double GetPitch () const;
+	double GetBank () const;
+	double GetYaw () const;
+	double GetAOA () const;
+	double GetSlipAngle () const;
+	double GetAirspeed () const;
+	double GetGroundspeed () const;
+	double GetMachNumber () const;
+	double GetDynPressure () const;
+	double GetAtmPressure () const;
+	double GetAtmTemperature () const;
+	double GetAtmDensity () const;
+	double GetLift () const;
+	double GetDrag () const;
+	bool GetAirspeedVector (REFFRAME frame, VECTOR3 &v) const;
+	bool GetHorizonAirspeedVector (VECTOR3 &v) const;
+	bool GetWeightVector (VECTOR3 &G) const;
+	bool GetThrustVector (VECTOR3 &T) const;
+	void GetAngularVel (VECTOR3 &avel) const;
+	void GetAngularAcc (VECTOR3 &aacc) const;
+	void GetAngularMoment (VECTOR3 &amom) const;
+	void GetGlobalPos (VECTOR3 &pos) const;
+	OBJHANDLE GetEquPos (double &longitude, double &latitude, double &radius) const;
+	void GetRelativePos (OBJHANDLE hRef, VECTOR3 &pos) const;
+	void GetRelativeVel (OBJHANDLE hRef, VECTOR3 &vel) const;
+	void GlobalRot (const VECTOR3 &rloc, VECTOR3 &rglob) const;
+	void HorizonRot (const VECTOR3 &rloc, VECTOR3 &rhorizon) const;
+
+	PROPELLANT_HANDLE CreatePropellantResource (double maxmass, double mass = -1.0, double efficiency = 1.0) const;
+	void SetDefaultPropellantResource (PROPELLANT_HANDLE ph) const;
+	double GetPropellantMaxMass (PROPELLANT_HANDLE ph) const;
+	void SetPropellantMaxMass (PROPELLANT_HANDLE ph, double maxmass) const;
+	double GetPropellantMass (PROPELLANT_HANDLE ph) const;
+	void SetPropellantMass (PROPELLANT_HANDLE ph, double mass) const;
+	double GetPropellantFlowrate (PROPELLANT_HANDLE ph) const;
+	double GetTotalPropellantMass () const;
+
+	THRUSTER_HANDLE CreateThruster (const VECTOR3 &pos, const VECTOR3 &dir, double maxth0,
+		PROPELLANT_HANDLE hp = NULL, double isp0 = 0.0, double isp_ref = 0.0, double p_ref = 101.4e3) const;
+	bool DelThruster (THRUSTER_HANDLE &th) const;
+	void SetThrusterResource (THRUSTER_HANDLE th, PROPELLANT_HANDLE ph) const;
+	void SetThrusterRef (THRUSTER_HANDLE th, const VECTOR3 &pos) const;
+	void GetThrusterRef (THRUSTER_HANDLE th, VECTOR3 &pos) const;
+	void SetThrusterDir (THRUSTER_HANDLE th, const VECTOR3 &dir) const;
+	void GetThrusterDir (THRUSTER_HANDLE th, VECTOR3 &dir) const;
+	void SetThrusterMax0 (THRUSTER_HANDLE th, double maxth0) const;
+	double GetThrusterMax0 (THRUSTER_HANDLE th) const;
+	double GetThrusterMax (THRUSTER_HANDLE th) const;
+	void SetThrusterIsp (THRUSTER_HANDLE th, double isp) const;
+	void SetThrusterIsp (THRUSTER_HANDLE th, double isp, double isp_ref, double p_ref = 101.4e3) const;
+	double GetThrusterIsp (THRUSTER_HANDLE th) const;
+	double GetThrusterIsp0 (THRUSTER_HANDLE th) const;
+	void SetThrusterLevel (THRUSTER_HANDLE th, double level) const;
+	void IncThrusterLevel (THRUSTER_HANDLE th, double dlevel) const;
+	double GetThrusterLevel (THRUSTER_HANDLE th) const;
+	double GetThrusterFlowRate (THRUSTER_HANDLE th) const;
+	THGROUP_HANDLE CreateThrusterGroup (THRUSTER_HANDLE *th, int nth, THGROUP_TYPE thgt) const;
+	bool DelThrusterGroup (THGROUP_HANDLE &thg, THGROUP_TYPE thgt, bool delth = false) const;
+	THGROUP_HANDLE GetThrusterGroupHandle (THGROUP_TYPE thgt) const;
+	THRUSTER_HANDLE GetGroupThruster (THGROUP_TYPE thgt, DWORD idx) const;
+	THRUSTER_HANDLE GetGroupThruster (THGROUP_HANDLE thg, DWORD idx) const;
+	DWORD GetGroupThrusterCount (THGROUP_TYPE thgt) const;
+	DWORD GetGroupThrusterCount (THGROUP_HANDLE thg) const;
+	void SetThrusterGroupLevel (THGROUP_TYPE thgt, double level) const;
+	void SetThrusterGroupLevel (THGROUP_HANDLE thg, double level) const;
+	void IncThrusterGroupLevel (THGROUP_TYPE thgt, double dlevel) const;
+	double GetThrusterGroupLevel (THGROUP_TYPE thgt) const;
+	double GetThrusterGroupLevel (THGROUP_HANDLE thg) const;
+	int GetAttitudeMode () const;
+	bool SetAttitudeMode (int mode) const;
+	int ToggleAttitudeMode () const;
+	DWORD GetADCtrlMode () const;
+	void SetADCtrlMode (DWORD mode) const;
+	UINT AddExhaust (THRUSTER_HANDLE th, double lscale, double wscale, SURFHANDLE tex = 0) const;
+	UINT AddExhaust (THRUSTER_HANDLE th, double lscale, double wscale, const VECTOR3 &pos, const VECTOR3 &dir, SURFHANDLE tex = 0) const;
+	UINT AddExhaust (EXHAUSTSPEC *spec);
+	PSTREAM_HANDLE AddExhaustStream (THRUSTER_HANDLE th, PARTICLESTREAMSPEC *pss = 0) const;
+	PSTREAM_HANDLE AddExhaustStream (THRUSTER_HANDLE th, const VECTOR3 &pos, PARTICLESTREAMSPEC *pss = 0) const;
+	bool DelExhaustStream (PSTREAM_HANDLE ch) const;
+
+	AIRFOILHANDLE CreateAirfoil3 (AIRFOIL_ORIENTATION align, const VECTOR3 &ref, AirfoilCoeffFuncEx cf,
+		void *context, double c, double S, double A) const;
+	AIRFOILHANDLE CreateAirfoil (AIRFOIL_ORIENTATION align, const VECTOR3 &ref, AirfoilCoeffFunc cf,
+		double c, double S, double A) const;
+	bool EditAirfoil (AIRFOILHANDLE hAirfoil, DWORD flag, const VECTOR3 &ref, AirfoilCoeffFunc cf,
+		double c, double S, double A) const;
+	bool DelAirfoil (AIRFOILHANDLE hAirfoil) const;
+	void ClearAirfoilDefinitions () const;
+	CTRLSURFHANDLE CreateControlSurface2 (AIRCTRL_TYPE type, double area, double dCl, const VECTOR3 &ref,
+		int axis = AIRCTRL_AXIS_AUTO, UINT anim = (UINT)-1) const;
+	CTRLSURFHANDLE CreateControlSurface3 (AIRCTRL_TYPE type, double area, double dCl, const VECTOR3 &ref,
+		int axis = AIRCTRL_AXIS_AUTO, double delay = 1.0, UINT anim = (UINT)-1) const;
+	bool DelControlSurface (CTRLSURFHANDLE hCtrlSurface) const;
+	void SetControlSurfaceLevel (AIRCTRL_TYPE type, double level) const;
+	void SetControlSurfaceLevel (AIRCTRL_TYPE type, double level, bool direct) const;
+	double GetControlSurfaceLevel (AIRCTRL_TYPE type) const;
+	void CreateVariableDragElement (const double *drag, double factor, const VECTOR3 &ref) const;
+	void ClearVariableDragElements () const;
+
+	UINT AddMesh (const char *meshname, const VECTOR3 *ofs = 0) const;
+	UINT AddMesh (MESHHANDLE hMesh, const VECTOR3 *ofs = 0) const;
+	bool InsertMesh (const char *meshname, UINT idx, const VECTOR3 *ofs = 0) const;
+	void ClearMeshes () const;
+	void ClearMeshes (bool retainAnim) const;
+	void SetMeshVisibilityMode (UINT meshidx, WORD mode) const;
+	bool ShiftMeshes (const VECTOR3 &ofs) const;
+	MESHHANDLE GetMeshTemplate (UINT idx) const;
+	MESHHANDLE CopyMeshFromTemplate (UINT idx) const;
+	DEVMESHHANDLE GetDevMesh (VISHANDLE vis, UINT idx) const;
+	void MeshModified (MESHHANDLE hMesh, UINT grp, DWORD modflag);
+	UINT CreateAnimation (double initial_state) const;
+	bool DelAnimation (UINT anim) const;
+	ANIMATIONCOMPONENT_HANDLE AddAnimationComponent (UINT anim, double state0, double state1,
+		MGROUP_TRANSFORM *trans, ANIMATIONCOMPONENT_HANDLE parent = NULL) const;
+	bool SetAnimation (UINT anim, double state) const;
+	double GetAnimation (UINT anim) const;
+	void ClearBeacons ();
+	void AddBeacon (BEACONLIGHTSPEC *bs);
+	bool DelBeacon (BEACONLIGHTSPEC *bs);
+	const BEACONLIGHTSPEC *GetBeacon (DWORD idx) const;
+	LightEmitter *AddSpotLight (const VECTOR3 &pos, const VECTOR3 &dir, double range, double att0,
+		double att1, double att2, double umbra, double penumbra, COLOUR4 diffuse, COLOUR4 specular, COLOUR4 ambient);
+	LightEmitter *AddPointLight (const VECTOR3 &pos, double range, double att0, double att1, double att2,
+		COLOUR4 diffuse, COLOUR4 specular, COLOUR4 ambient);
+	void ClearLightEmitters ();
+
+	NAVHANDLE GetNavSource (DWORD n) const;
+	DWORD GetNavmodeState (int mode) const;
+	bool ActivateNavmode (int mode);
+	bool DeactivateNavmode (int mode);
+	bool ToggleNavmode (int mode);
+	bool GetNavRecv (DWORD n) const;
+	void InitNavRadios (DWORD nnav) const;
+	bool SetNavRecv (DWORD n, DWORD ch) const;
+	DWORD GetNavCount () const;
+	void EnableTransponder (bool enable) const;
+	bool SetTransponderChannel (DWORD ch) const;
+	void SetEnableFocus (bool enable) const;
+
+	bool RegisterAnimation () const;
+	bool Playback () const;
+	bool RecordEvent (const char *event_type, const char *event) const;
+	void AddForce (const VECTOR3 &F, const VECTOR3 &r) const;
+	PSTREAM_HANDLE AddParticleStream (PARTICLESTREAMSPEC *pss, const VECTOR3 &pos, const VECTOR3 &dir, double *lvl) const;
+	void ParseScenarioLineEx (char *line, void *status) const;
+
+	// stub internals
+	VESSELSTUB *stub;
+};
+
+class VESSEL2: public VESSEL {
+public:
+	VESSEL2 (OBJHANDLE hVessel, int fmodel = 1);
+	virtual void clbkSetClassCaps (FILEHANDLE cfg) {}
+	virtual void clbkSaveState (FILEHANDLE scn);
+	virtual void clbkLoadStateEx (FILEHANDLE scn, void *status);
+	virtual void clbkSetStateEx (const void *status) {}
+	void DefSetStateEx (const void *status) const;
+	virtual void clbkPostCreation () {}
+	virtual void clbkFocusChanged (bool getfocus, OBJHANDLE hNewVessel, OBJHANDLE hOldVessel) {}
+	virtual void clbkPreStep (double simt, double simdt, double mjd) {}
+	virtual void clbkPostStep (double simt, double simdt, double mjd) {}
+	virtual bool clbkPlaybackEvent (double simt, double event_t, const char *event_type, const char *event) { return false; }
+	virtual void clbkVisualCreated (VISHANDLE vis, int refcount) {}
+	virtual void clbkVisualDestroyed (VISHANDLE vis, int refcount) {}
+	virtual void clbkDrawHUD (int mode, const HUDPAINTSPEC *hps, HDC hDC) {}
+	virtual void clbkRCSMode (int mode) {}
+	virtual void clbkADCtrlMode (DWORD mode) {}
+	virtual void clbkHUDMode (int mode) {}
+	virtual void clbkMFDMode (int mfd, int mode) {}
+	virtual void clbkNavMode (int mode, bool active) {}
+	virtual void clbkDockEvent (int dock, OBJHANDLE mate) {}
+	virtual void clbkAnimate (double simt) {}
+	virtual int clbkConsumeDirectKey (char *kstate) { return 0; }
+	virtual int clbkConsumeBufferedKey (DWORD key, bool down, char *kstate) { return 0; }
+	virtual bool clbkLoadGenericCockpit () { return false; }
+	virtual bool clbkLoadPanel (int id) { return false; }
+	virtual bool clbkPanelMouseEvent (int id, int event, int mx, int my) { return false; }
+	virtual bool clbkPanelRedrawEvent (int id, int event, SURFHANDLE surf) { return false; }
+	virtual bool clbkLoadVC (int id) { return false; }
+	virtual bool clbkVCMouseEvent (int id, int event, VECTOR3 &p) { return false; }
+	virtual bool clbkVCRedrawEvent (int id, int event, SURFHANDLE surf) { return false; }
+};
+
+class VESSEL3: public VESSEL2 {
+public:
+	VESSEL3 (OBJHANDLE hVessel, int fmodel = 1);
+	virtual int clbkGeneric (int msgid = 0, int prm = 0, void *context = NULL) { return 0; }
+	virtual bool clbkLoadPanel2D (int id, PANELHANDLE hPanel, DWORD viewW, DWORD viewH) { return false; }
+	virtual bool clbkPanelMouseEvent (int id, int event, int mx, int my, void *context) { return false; }
+	virtual bool clbkPanelRedrawEvent (int id, int event, SURFHANDLE surf, void *context) { return false; }
+	virtual bool clbkDrawHUD (int mode, const HUDPAINTSPEC *hps, oapi::Sketchpad *skp);
+	virtual void clbkRenderHUD (int mode, const HUDPAINTSPEC *hps, SURFHANDLE hDefaultTex) {}
+	virtual void clbkGetRadiationForce (const VECTOR3 &mflux, VECTOR3 &F, VECTOR3 &pos) {}
+	int SetPanelBackground (PANELHANDLE hPanel, SURFHANDLE *hSurf, DWORD nsurf, MESHHANDLE hMesh,
+		DWORD width, DWORD height, DWORD baseline = 0, DWORD scrollflag = 0);
+	int SetPanelScaling (PANELHANDLE hPanel, double defscale, double extscale);
+	int RegisterPanelMFDGeometry (PANELHANDLE hPanel, int MFD_id, int nmesh, int ngroup);
+	int RegisterPanelArea (PANELHANDLE hPanel, int id, const RECT &pos, int texidx, const RECT &texpos,
+		int draw_event, int mouse_event, int bkmode);
+	int RegisterPanelArea (PANELHANDLE hPanel, int id, const RECT &pos, int draw_event, int mouse_event,
+		SURFHANDLE surf = NULL, void *context = NULL);
+	bool RegisterMFDMode (void *spec) { return false; }
+};
+
+inline RECT _R (int left, int top, int right, int bottom) { RECT r = {left, top, right, bottom}; return r; }
+
+// ==============================================================
+// oapi functions
+
+OAPIFUNC double oapiGetSimTime ();
+OAPIFUNC double oapiGetSimStep ();
+OAPIFUNC double oapiGetSysTime ();
+OAPIFUNC double oapiGetSysStep ();
+OAPIFUNC double oapiGetSimMJD ();
+OAPIFUNC double oapiGetTimeAcceleration ();
+OAPIFUNC double oapiRand ();
+OAPIFUNC void oapiWriteLog (char *line);
+OAPIFUNC void oapiWriteLogV (const char *format, ...);
+OAPIFUNC VESSEL *oapiGetVesselInterface (OBJHANDLE hVessel);
+OAPIFUNC OBJHANDLE oapiGetFocusObject ();
+OAPIFUNC double oapiGetSize (OBJHANDLE hObj);
+OAPIFUNC double oapiGetMass (OBJHANDLE hObj);
+OAPIFUNC bool oapiGetObjectName (OBJHANDLE hObj, char *name, int n);
+OAPIFUNC int oapiGetObjectType (OBJHANDLE hObj);
+OAPIFUNC OBJHANDLE oapiGetBasePlanet (OBJHANDLE hBase);
+OAPIFUNC const ATMCONST *oapiGetPlanetAtmConstants (OBJHANDLE hPlanet);
+OAPIFUNC double oapiGetWaveDrag (double M, double M1, double M2, double M3, double cmax);
+OAPIFUNC double oapiGetInducedDrag (double cl, double A, double e);
+OAPIFUNC void oapiGlobalToEqu (OBJHANDLE hObj, const VECTOR3 &glob, double *lng, double *lat, double *rad);
+OAPIFUNC bool oapiGetNavData (NAVHANDLE hNav, NAVDATA *data);
+OAPIFUNC void oapiGetNavPos (NAVHANDLE hNav, VECTOR3 *gpos);
+OAPIFUNC DWORD oapiGetNavType (NAVHANDLE hNav);
+OAPIFUNC float oapiGetNavFreq (NAVHANDLE hNav);
+
+// scenario and configuration files
+OAPIFUNC bool oapiReadItem_string (FILEHANDLE f, char *item, char *string);
+OAPIFUNC bool oapiReadItem_float (FILEHANDLE f, char *item, double &val);
+OAPIFUNC bool oapiReadItem_int (FILEHANDLE f, char *item, int &val);
+OAPIFUNC bool oapiReadItem_bool (FILEHANDLE f, char *item, bool &val);
+OAPIFUNC bool oapiReadItem_vec (FILEHANDLE f, char *item, VECTOR3 &val);
+OAPIFUNC bool oapiReadScenario_nextline (FILEHANDLE f, char *&line);
+OAPIFUNC void oapiWriteLine (FILEHANDLE f, char *line);
+OAPIFUNC void oapiWriteScenario_string (FILEHANDLE scn, char *item, char *string);
+OAPIFUNC void oapiWriteScenario_int (FILEHANDLE scn, char *item, int i);
+OAPIFUNC void oapiWriteScenario_float (FILEHANDLE scn, char *item, double d);
+OAPIFUNC void oapiWriteScenario_vec (FILEHANDLE scn, char *item, const VECTOR3 &vec);
+
+// meshes
+OAPIFUNC MESHHANDLE oapiLoadMeshGlobal (const char *fname);
+OAPIFUNC MESHHANDLE oapiCreateMesh (DWORD ngrp, MESHGROUP *grp);
+OAPIFUNC void oapiDeleteMesh (MESHHANDLE hMesh);
+OAPIFUNC MESHGROUP *oapiMeshGroup (MESHHANDLE hMesh, DWORD idx);
+OAPIFUNC MESHGROUP *oapiMeshGroup (DEVMESHHANDLE hMesh, DWORD idx);
+OAPIFUNC DWORD oapiAddMeshGroup (MESHHANDLE hMesh, MESHGROUP *grp);
+OAPIFUNC bool oapiAddMeshGroupBlock (MESHHANDLE hMesh, DWORD grpidx, const NTVERTEX *vtx, DWORD nvtx, const WORD *idx, DWORD nidx);
+OAPIFUNC int oapiEditMeshGroup (MESHHANDLE hMesh, DWORD grpidx, GROUPEDITSPEC *ges);
+OAPIFUNC int oapiEditMeshGroup (DEVMESHHANDLE hMesh, DWORD grpidx, GROUPEDITSPEC *ges);
+OAPIFUNC bool oapiSetTexture (MESHHANDLE hMesh, DWORD texidx, SURFHANDLE tex);
+OAPIFUNC bool oapiSetTexture (DEVMESHHANDLE hMesh, DWORD texidx, SURFHANDLE tex);
+OAPIFUNC SURFHANDLE oapiGetTextureHandle (MESHHANDLE hMesh, DWORD texidx);
+
+// surfaces and drawing
+OAPIFUNC SURFHANDLE oapiLoadTexture (const char *fname, bool dynamic = false);
+OAPIFUNC void oapiReleaseTexture (SURFHANDLE hTex);
+OAPIFUNC SURFHANDLE oapiCreateSurface (int width, int height);
+OAPIFUNC SURFHANDLE oapiCreateSurface (HBITMAP hBmp, bool release_bmp = true);
+OAPIFUNC SURFHANDLE oapiCreateTextureSurface (int width, int height);
+OAPIFUNC void oapiDestroySurface (SURFHANDLE surf);
+OAPIFUNC void oapiSetSurfaceColourKey (SURFHANDLE surf, DWORD ckey);
+OAPIFUNC DWORD oapiGetColour (DWORD red, DWORD green, DWORD blue);
+OAPIFUNC bool oapiBlt (SURFHANDLE tgt, SURFHANDLE src, int tgtx, int tgty, int srcx, int srcy, int w, int h, DWORD ck = SURF_PREDEF_CK);
+OAPIFUNC bool oapiColourFill (SURFHANDLE tgt, DWORD fillcolor, int tgtx = 0, int tgty = 0, int w = 0, int h = 0);
+OAPIFUNC HDC oapiGetDC (SURFHANDLE surf);
+OAPIFUNC void oapiReleaseDC (SURFHANDLE surf, HDC hDC);
+OAPIFUNC oapi::Sketchpad *oapiGetSketchpad (SURFHANDLE surf);
+OAPIFUNC void oapiReleaseSketchpad (oapi::Sketchpad *skp);
+OAPIFUNC oapi::Font *oapiCreateFont (int height, bool prop, char *face, int style = FONT_NORMAL);
+OAPIFUNC void oapiReleaseFont (oapi::Font *font);
+OAPIFUNC void oapiRenderHUD (MESHHANDLE hMesh, SURFHANDLE *hTex);
+OAPIFUNC PSTREAM_HANDLE oapiParticleSetLevelRef (PSTREAM_HANDLE ph, double *lvl);
+OAPIFUNC SURFHANDLE oapiRegisterParticleTexture (char *path);
+
+// cockpit, panels, HUD and MFDs
+OAPIFUNC int oapiCockpitMode ();
+OAPIFUNC void oapiCameraSetCockpitDir (double polar, double azimuth, bool transition = false);
+OAPIFUNC int oapiGetHUDMode ();
+OAPIFUNC bool oapiSetHUDMode (int mode);
+OAPIFUNC void oapiIncHUDIntensity ();
+OAPIFUNC void oapiDecHUDIntensity ();
+OAPIFUNC void oapiToggleHUDColour ();
+OAPIFUNC void oapiToggleMFD_on (int mfd);
+OAPIFUNC void oapiRegisterMFD (int mfd, const MFDSPEC &spec);
+OAPIFUNC void oapiRegisterMFD (int mfd, const void *spec);
+OAPIFUNC const char *oapiMFDButtonLabel (int mfd, int bt);
+OAPIFUNC void oapiProcessMFDButton (int mfd, int bt, int event);
+OAPIFUNC bool oapiSendMFDKey (int mfd, DWORD key);
+OAPIFUNC void oapiRegisterPanelBackground (HBITMAP hBmp, DWORD flag = 0, DWORD ck = (DWORD)-1);
+OAPIFUNC void oapiRegisterPanelArea (int id, const RECT &pos, int draw_event = PANEL_REDRAW_NEVER,
+	int mouse_event = PANEL_MOUSE_IGNORE, int bkmode = PANEL_MAP_NONE);
+OAPIFUNC void oapiSetPanelNeighbours (int left, int right, int top, int bottom);
+OAPIFUNC void oapiTriggerPanelRedrawArea (int panel_id, int area_id);
+OAPIFUNC void oapiTriggerRedrawArea (int panel_id, int vc_id, int area_id);
+OAPIFUNC bool oapiBltPanelAreaBackground (int area_id, SURFHANDLE surf);
+OAPIFUNC void oapiSetDefNavDisplay (int mode);
+OAPIFUNC void oapiSetDefRCSDisplay (int mode);
+OAPIFUNC void oapiVCRegisterArea (int id, const RECT &tgtrect, int draw_event, int mouse_event, int bkmode, SURFHANDLE tgt);
+OAPIFUNC void oapiVCRegisterArea (int id, int draw_event, int mouse_event);
+OAPIFUNC void oapiVCSetAreaClickmode_Spherical (int id, const VECTOR3 &cnt, double rad);
+OAPIFUNC void oapiVCSetAreaClickmode_Quadrilateral (int id, const VECTOR3 &p1, const VECTOR3 &p2, const VECTOR3 &p3, const VECTOR3 &p4);
+OAPIFUNC void oapiVCSetNeighbours (int left, int right, int top, int bottom);
+OAPIFUNC void oapiVCTriggerRedrawArea (int vc_id, int area_id);
+OAPIFUNC void oapiVCRegisterMFD (int mfd, const VCMFDSPEC *spec);
+OAPIFUNC void oapiVCRegisterHUD (const VCHUDSPEC *spec);
+
+// dialogs and help
+OAPIFUNC HWND oapiOpenDialog (HINSTANCE hDLLInst, int resourceId, DLGPROC msgProc, void *context = 0);
+OAPIFUNC HWND oapiOpenDialogEx (HINSTANCE hDLLInst, int resourceId, DLGPROC msgProc, DWORD flag = 0, void *context = 0);
+OAPIFUNC HWND oapiFindDialog (HINSTANCE hDLLInst, int resourceId);
+OAPIFUNC void oapiCloseDialog (HWND hDlg);
+OAPIFUNC void *oapiGetDialogContext (HWND hDlg);
+OAPIFUNC INT_PTR oapiDefDialogProc (HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lParam);
+OAPIFUNC bool oapiOpenHelp (HELPCONTEXT *hcontext);
+OAPIFUNC void oapiRegisterCustomControls (HINSTANCE hInst);
+OAPIFUNC void oapiUnregisterCustomControls (HINSTANCE hInst);
+OAPIFUNC void oapiSetGaugeParams (HWND hCtrl, GAUGEPARAM *gp, bool redraw = true);
+OAPIFUNC void oapiSetGaugePos (HWND hCtrl, int pos, bool redraw = true);
+
+// script interpreters
+OAPIFUNC INTERPRETERHANDLE oapiCreateInterpreter ();
+OAPIFUNC int oapiDelInterpreter (INTERPRETERHANDLE hInterp);
+OAPIFUNC bool oapiExecScriptCmd (INTERPRETERHANDLE hInterp, const char *cmd);
+OAPIFUNC bool oapiAsyncScriptCmd (INTERPRETERHANDLE hInterp, const char *cmd);
+
+#endif // !__ORBITERSDK_H
@@ -0,0 +1,28 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ScnEditorAPI.h
+// Headless host: scenario editor page interface
+// ==============================================================
+
+#ifndef __SCNEDITORAPI_H
+#define __SCNEDITORAPI_H
+
+#include <windows.h>
+
+#define WM_SCNEDITOR     (WM_USER+0x10)
+#define SE_ADDFUNCBUTTON 0x01
+#define SE_ADDPAGEBUTTON 0x02
+#define SE_GETVESSEL     0x03
+
+typedef struct {
+	char btnlabel[32];
+	HINSTANCE hDLL;
+	WORD ResId;
+	DLGPROC TabProc;
+} EditorPageSpec;
+
+#endif // !__SCNEDITORAPI_H
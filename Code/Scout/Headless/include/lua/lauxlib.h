@@ -0,0 +1,42 @@
+/*
+** Headless host: declarations of the Lua 5.1 auxiliary library
+** functions used by the Scout sources
+*/
+
+#ifndef lauxlib_h
+#define lauxlib_h
+
+#include "lua.h"
+
+#define LUA_NOREF  (-2)
+#define LUA_REFNIL (-1)
+
+typedef struct luaL_Reg {
+	const char *name;
+	lua_CFunction func;
+} luaL_Reg;
+#define luaL_reg luaL_Reg
+
+void luaL_openlib (lua_State *L, const char *libname, const luaL_Reg *l, int nup);
+int luaL_newmetatable (lua_State *L, const char *tname);
+void *luaL_checkudata (lua_State *L, int ud, const char *tname);
+int luaL_error (lua_State *L, const char *fmt, ...);
+const char *luaL_checklstring (lua_State *L, int numArg, size_t *l);
+const char *luaL_optlstring (lua_State *L, int numArg, const char *def, size_t *l);
+lua_Number luaL_checknumber (lua_State *L, int numArg);
+lua_Number luaL_optnumber (lua_State *L, int nArg, lua_Number def);
+lua_Integer luaL_checkinteger (lua_State *L, int numArg);
+void luaL_checktype (lua_State *L, int narg, int t);
+int luaL_ref (lua_State *L, int t);
+void luaL_unref (lua_State *L, int t, int ref);
+int luaL_loadfile (lua_State *L, const char *filename);
+int luaL_loadbuffer (lua_State *L, const char *buff, size_t sz, const char *name);
+int luaL_loadstring (lua_State *L, const char *s);
+
+#define luaL_checkstring(L,n)   (luaL_checklstring(L, (n), NULL))
+#define luaL_optstring(L,n,d)   (luaL_optlstring(L, (n), (d), NULL))
+#define luaL_getmetatable(L,n)  (lua_getfield(L, LUA_REGISTRYINDEX, (n)))
+#define luaL_dofile(L, fn)      (luaL_loadfile(L, fn) || lua_pcall(L, 0, LUA_MULTRET, 0))
+#define LUA_MULTRET (-1)
+
+#endif
@@ -0,0 +1,135 @@
+/*
+** Headless host: declarations of the Lua 5.1 API functions used by
+** the Scout sources. The host never creates a Lua state, so the
+** implementations in StubLua.cpp are empty.
+*/
+
+#ifndef lua_h
+#define lua_h
+
+#include <stddef.h>
+
+#define LUA_REGISTRYINDEX (-10000)
+#define LUA_ENVIRONINDEX  (-10001)
+#define LUA_GLOBALSINDEX  (-10002)
+#define lua_upvalueindex(i) (LUA_GLOBALSINDEX-(i))
+
+#define LUA_YIELD     1
+#define LUA_ERRRUN    2
+#define LUA_ERRSYNTAX 3
+#define LUA_ERRMEM    4
+#define LUA_ERRERR    5
+
+#define LUA_TNONE          (-1)
+#define LUA_TNIL           0
+#define LUA_TBOOLEAN       1
+#define LUA_TLIGHTUSERDATA 2
+#define LUA_TNUMBER        3
+#define LUA_TSTRING        4
+#define LUA_TTABLE         5
+#define LUA_TFUNCTION      6
+#define LUA_TUSERDATA      7
+#define LUA_TTHREAD        8
+
+#define LUA_HOOKCALL    0
+#define LUA_HOOKRET     1
+#define LUA_HOOKLINE    2
+#define LUA_HOOKCOUNT   3
+#define LUA_HOOKTAILRET 4
+#define LUA_MASKCALL  (1 << LUA_HOOKCALL)
+#define LUA_MASKRET   (1 << LUA_HOOKRET)
+#define LUA_MASKLINE  (1 << LUA_HOOKLINE)
+#define LUA_MASKCOUNT (1 << LUA_HOOKCOUNT)
+
+#define LUA_IDSIZE 60
+
+typedef struct lua_State lua_State;
+typedef int (*lua_CFunction) (lua_State *L);
+typedef double lua_Number;
+typedef ptrdiff_t lua_Integer;
+
+typedef struct lua_Debug {
+	int event;
+	const char *name;
+	const char *namewhat;
+	const char *what;
+	const char *source;
+	int currentline;
+	int nups;
+	int linedefined;
+	int lastlinedefined;
+	char short_src[LUA_IDSIZE];
+	int i_ci;
+} lua_Debug;
+
+typedef void (*lua_Hook) (lua_State *L, lua_Debug *ar);
+
+int   lua_gettop (lua_State *L);
+void  lua_settop (lua_State *L, int idx);
+void  lua_pushvalue (lua_State *L, int idx);
+void  lua_remove (lua_State *L, int idx);
+void  lua_insert (lua_State *L, int idx);
+int   lua_type (lua_State *L, int idx);
+int   lua_isnumber (lua_State *L, int idx);
+int   lua_isstring (lua_State *L, int idx);
+int   lua_iscfunction (lua_State *L, int idx);
+int   lua_isuserdata (lua_State *L, int idx);
+lua_Number lua_tonumber (lua_State *L, int idx);
+lua_Integer lua_tointeger (lua_State *L, int idx);
+int   lua_toboolean (lua_State *L, int idx);
+const char *lua_tolstring (lua_State *L, int idx, size_t *len);
+lua_CFunction lua_tocfunction (lua_State *L, int idx);
+void *lua_touserdata (lua_State *L, int idx);
+lua_State *lua_tothread (lua_State *L, int idx);
+const void *lua_topointer (lua_State *L, int idx);
+void  lua_pushnil (lua_State *L);
+void  lua_pushnumber (lua_State *L, lua_Number n);
+void  lua_pushinteger (lua_State *L, lua_Integer n);
+void  lua_pushlstring (lua_State *L, const char *s, size_t l);
+void  lua_pushstring (lua_State *L, const char *s);
+const char *lua_pushfstring (lua_State *L, const char *fmt, ...);
+void  lua_pushcclosure (lua_State *L, lua_CFunction fn, int n);
+void  lua_pushboolean (lua_State *L, int b);
+void  lua_pushlightuserdata (lua_State *L, void *p);
+int   lua_pushthread (lua_State *L);
+void  lua_gettable (lua_State *L, int idx);
+void  lua_getfield (lua_State *L, int idx, const char *k);
+void  lua_rawget (lua_State *L, int idx);
+void  lua_rawgeti (lua_State *L, int idx, int n);
+void  lua_createtable (lua_State *L, int narr, int nrec);
+void *lua_newuserdata (lua_State *L, size_t sz);
+int   lua_getmetatable (lua_State *L, int objindex);
+void  lua_getfenv (lua_State *L, int idx);
+void  lua_settable (lua_State *L, int idx);
+void  lua_setfield (lua_State *L, int idx, const char *k);
+void  lua_rawset (lua_State *L, int idx);
+void  lua_rawseti (lua_State *L, int idx, int n);
+int   lua_setmetatable (lua_State *L, int objindex);
+int   lua_setfenv (lua_State *L, int idx);
+void  lua_call (lua_State *L, int nargs, int nresults);
+int   lua_pcall (lua_State *L, int nargs, int nresults, int errfunc);
+int   lua_yield (lua_State *L, int nresults);
+int   lua_resume (lua_State *L, int narg);
+int   lua_status (lua_State *L);
+int   lua_error (lua_State *L);
+lua_State *lua_newthread (lua_State *L);
+int   lua_getstack (lua_State *L, int level, lua_Debug *ar);
+int   lua_getinfo (lua_State *L, const char *what, lua_Debug *ar);
+int   lua_sethook (lua_State *L, lua_Hook func, int mask, int count);
+
+#define lua_pop(L,n)            lua_settop(L, -(n)-1)
+#define lua_newtable(L)         lua_createtable(L, 0, 0)
+#define lua_pushcfunction(L,f)  lua_pushcclosure(L, (f), 0)
+#define lua_isfunction(L,n)     (lua_type(L, (n)) == LUA_TFUNCTION)
+#define lua_istable(L,n)        (lua_type(L, (n)) == LUA_TTABLE)
+#define lua_islightuserdata(L,n) (lua_type(L, (n)) == LUA_TLIGHTUSERDATA)
+#define lua_isnil(L,n)          (lua_type(L, (n)) == LUA_TNIL)
+#define lua_isboolean(L,n)      (lua_type(L, (n)) == LUA_TBOOLEAN)
+#define lua_isthread(L,n)       (lua_type(L, (n)) == LUA_TTHREAD)
+#define lua_isnone(L,n)         (lua_type(L, (n)) == LUA_TNONE)
+#define lua_isnoneornil(L, n)   (lua_type(L, (n)) <= 0)
+#define lua_tostring(L,i)       lua_tolstring(L, (i), NULL)
+#define lua_setglobal(L,s)      lua_setfield(L, LUA_GLOBALSINDEX, (s))
+#define lua_getglobal(L,s)      lua_getfield(L, LUA_GLOBALSINDEX, (s))
+
+#endif
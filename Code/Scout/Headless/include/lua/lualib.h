@@ -0,0 +1,10 @@
+/*
+** Headless host: Lua standard library declarations (none are used)
+*/
+
+#ifndef lualib_h
+#define lualib_h
+
+#include "lua.h"
+
+#endif
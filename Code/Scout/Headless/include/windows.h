@@ -0,0 +1,280 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// windows.h
+// Headless host: the subset of the Win32 API used by the Scout
+// sources, for building on Linux
+//
+// Notes:
+// * Threads, events, semaphores, critical sections, Interlocked*
+//   and the performance counter are functional (pthreads).
+// * File mapping and ReadFile work on regular files.
+// * GDI, dialog and window functions do nothing and return null
+//   handles. They are only reached from panel and dialog code,
+//   which the host never calls.
+// ==============================================================
+
+#ifndef __HEADLESS_WINDOWS_H
+#define __HEADLESS_WINDOWS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+// ==============================================================
+// Basic types
+
+typedef unsigned int DWORD;
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef unsigned int UINT;
+typedef int INT;
+typedef long LONG;
+typedef unsigned long ULONG;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+#ifndef __int64
+#define __int64 long long
+#endif
+typedef float FLOAT;
+typedef char CHAR;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+typedef const char *LPCTSTR;
+typedef char *LPTSTR;
+typedef void *LPVOID;
+typedef const void *LPCVOID;
+typedef DWORD *LPDWORD;
+typedef intptr_t INT_PTR;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef intptr_t LRESULT;
+typedef DWORD COLORREF;
+typedef void *HANDLE;
+typedef struct HWND__ *HWND;
+typedef struct HDC__ *HDC;
+typedef struct HINSTANCE__ *HINSTANCE;
+typedef HINSTANCE HMODULE;
+typedef struct HGDIOBJ__ *HGDIOBJ;
+typedef HGDIOBJ HFONT, HPEN, HBRUSH, HBITMAP;
+typedef struct HICON__ *HICON;
+typedef struct HMENU__ *HMENU;
+typedef ULONG_PTR SIZE_T;
+typedef LONG volatile *LPLONG_VOLATILE;
+
+#define TRUE  1
+#define FALSE 0
+#define CALLBACK
+#define WINAPI
+#define APIENTRY
+#define __cdecl
+#define __stdcall
+#define INFINITE 0xFFFFFFFF
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define MAX_PATH 260
+
+typedef union {
+	struct { DWORD LowPart; LONG HighPart; };
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct { LONG left, top, right, bottom; } RECT;
+typedef struct { LONG x, y; } POINT;
+typedef struct { DWORD dwLowDateTime, dwHighDateTime; } FILETIME;
+
+typedef struct {
+	WORD wProcessorArchitecture;
+	DWORD dwPageSize;
+	DWORD dwNumberOfProcessors;
+} SYSTEM_INFO;
+
+typedef struct {
+	void *impl;          // pthread_mutex_t, allocated on init
+} CRITICAL_SECTION;
+
+typedef DWORD (WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+// BOOL return as in the SDK headers the module was written against
+// (INT_PTR and BOOL have the same size on the 32-bit target)
+typedef BOOL (CALLBACK *DLGPROC)(HWND, UINT, WPARAM, LPARAM);
+typedef LRESULT (CALLBACK *WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+#define LOWORD(l) ((WORD)((DWORD_PTR_)(l) & 0xffff))
+#define HIWORD(l) ((WORD)(((DWORD_PTR_)(l) >> 16) & 0xffff))
+typedef uintptr_t DWORD_PTR_;
+#define MAKEINTRESOURCE(i) ((LPSTR)(uintptr_t)((WORD)(i)))
+#define RGB(r,g,b) ((COLORREF)(((BYTE)(r)|((WORD)((BYTE)(g))<<8))|(((DWORD)(BYTE)(b))<<16)))
+
+#ifndef max
+#define max(a,b) (((a) > (b)) ? (a) : (b))
+#endif
+#ifndef min
+#define min(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+// ==============================================================
+// MSVC runtime names
+
+#define _stricmp   strcasecmp
+#define _strnicmp  strncasecmp
+#define _snprintf  snprintf
+#define _vsnprintf vsnprintf
+#define _finite(x) isfinite(x)
+#define _isnan(x)  isnan(x)
+#define sprintf_s  snprintf
+#define __forceinline inline
+#define __declspec(x)
+
+// ==============================================================
+// Threads and synchronisation (functional)
+
+#define WAIT_OBJECT_0 0
+#define WAIT_TIMEOUT  258
+#define WAIT_FAILED   0xFFFFFFFF
+
+HANDLE CreateThread (void *sa, SIZE_T stack, LPTHREAD_START_ROUTINE func, LPVOID prm, DWORD flags, LPDWORD id);
+HANDLE CreateEvent (void *sa, BOOL manual, BOOL initial, LPCSTR name);
+HANDLE CreateSemaphore (void *sa, LONG initial, LONG maxcount, LPCSTR name);
+BOOL SetEvent (HANDLE h);
+BOOL ResetEvent (HANDLE h);
+BOOL ReleaseSemaphore (HANDLE h, LONG n, LONG *prev);
+DWORD WaitForSingleObject (HANDLE h, DWORD ms);
+DWORD WaitForMultipleObjects (DWORD n, const HANDLE *h, BOOL all, DWORD ms);
+BOOL CloseHandle (HANDLE h);
+void Sleep (DWORD ms);
+DWORD GetCurrentThreadId ();
+HANDLE GetCurrentThread ();
+BOOL SetThreadPriority (HANDLE h, int prio);
+#define THREAD_PRIORITY_BELOW_NORMAL (-1)
+#define THREAD_PRIORITY_LOWEST       (-2)
+#define THREAD_PRIORITY_IDLE         (-15)
+BOOL QueryThreadCycleTime (HANDLE h, ULONGLONG *cycles);
+BOOL GetThreadTimes (HANDLE h, FILETIME *create, FILETIME *exit, FILETIME *kernel, FILETIME *user);
+
+void InitializeCriticalSection (CRITICAL_SECTION *cs);
+void DeleteCriticalSection (CRITICAL_SECTION *cs);
+void EnterCriticalSection (CRITICAL_SECTION *cs);
+void LeaveCriticalSection (CRITICAL_SECTION *cs);
+
+inline LONG InterlockedIncrement (LONG volatile *p) { return __sync_add_and_fetch (p, 1); }
+inline LONG InterlockedDecrement (LONG volatile *p) { return __sync_sub_and_fetch (p, 1); }
+inline LONG InterlockedExchange (LONG volatile *p, LONG v) { return __sync_lock_test_and_set (p, v); }
+inline LONG InterlockedExchangeAdd (LONG volatile *p, LONG v) { return __sync_fetch_and_add (p, v); }
+inline LONG InterlockedCompareExchange (LONG volatile *p, LONG v, LONG cmp) { return __sync_val_compare_and_swap (p, cmp, v); }
+inline void MemoryBarrier () { __sync_synchronize (); }
+
+BOOL QueryPerformanceCounter (LARGE_INTEGER *t);
+BOOL QueryPerformanceFrequency (LARGE_INTEGER *f);
+DWORD GetTickCount ();
+void GetSystemInfo (SYSTEM_INFO *si);
+
+// ==============================================================
+// Files (functional for regular files)
+
+#define GENERIC_READ          0x80000000
+#define GENERIC_WRITE         0x40000000
+#define FILE_SHARE_READ       0x00000001
+#define OPEN_EXISTING         3
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY         0x02
+#define FILE_MAP_READ         0x0004
+#define INVALID_FILE_SIZE     0xFFFFFFFF
+
+HANDLE CreateFile (LPCSTR name, DWORD access, DWORD share, void *sa, DWORD disp, DWORD flags, HANDLE tmpl);
+DWORD GetFileSize (HANDLE h, LPDWORD high);
+BOOL ReadFile (HANDLE h, LPVOID buf, DWORD n, LPDWORD nread, void *ovl);
+HANDLE CreateFileMapping (HANDLE h, void *sa, DWORD prot, DWORD sizehigh, DWORD sizelow, LPCSTR name);
+LPVOID MapViewOfFile (HANDLE hMap, DWORD access, DWORD ofshigh, DWORD ofslow, SIZE_T n);
+BOOL UnmapViewOfFile (LPCVOID p);
+
+// ==============================================================
+// GDI (no-ops)
+
+#define PS_SOLID       0
+#define TRANSPARENT    1
+#define OPAQUE         2
+#define SRCCOPY        0x00CC0020
+#define TA_LEFT        0
+#define TA_RIGHT       2
+#define TA_CENTER      6
+#define TA_TOP         0
+#define TA_BOTTOM      8
+#define TA_BASELINE    24
+#define NULL_BRUSH     5
+#define NULL_PEN       8
+#define BLACK_BRUSH    4
+#define WHITE_PEN      6
+#define BLACK_PEN      7
+#define DEFAULT_QUALITY 0
+#define ANTIALIASED_QUALITY 4
+#define FW_BOLD        700
+#define FW_NORMAL      400
+
+HFONT CreateFont (int h, int w, int esc, int orient, int weight, DWORD italic, DWORD underline,
+	DWORD strikeout, DWORD charset, DWORD outprec, DWORD clipprec, DWORD quality, DWORD pitch, LPCSTR face);
+HBRUSH CreateSolidBrush (COLORREF col);
+HPEN CreatePen (int style, int width, COLORREF col);
+HGDIOBJ GetStockObject (int i);
+HGDIOBJ SelectObject (HDC hDC, HGDIOBJ obj);
+BOOL DeleteObject (HGDIOBJ obj);
+HDC CreateCompatibleDC (HDC hDC);
+BOOL DeleteDC (HDC hDC);
+BOOL BitBlt (HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, DWORD rop);
+BOOL StretchBlt (HDC dst, int x, int y, int w, int h, HDC src, int sx, int sy, int sw, int sh, DWORD rop);
+BOOL TextOut (HDC hDC, int x, int y, LPCSTR str, int len);
+COLORREF SetTextColor (HDC hDC, COLORREF col);
+COLORREF SetBkColor (HDC hDC, COLORREF col);
+int SetBkMode (HDC hDC, int mode);
+UINT SetTextAlign (HDC hDC, UINT align);
+BOOL MoveToEx (HDC hDC, int x, int y, POINT *p);
+BOOL LineTo (HDC hDC, int x, int y);
+BOOL Rectangle (HDC hDC, int l, int t, int r, int b);
+BOOL Ellipse (HDC hDC, int l, int t, int r, int b);
+BOOL Polygon (HDC hDC, const POINT *p, int n);
+BOOL Polyline (HDC hDC, const POINT *p, int n);
+int FillRect (HDC hDC, const RECT *r, HBRUSH br);
+HBITMAP LoadBitmap (HINSTANCE hInst, LPCSTR name);
+
+// ==============================================================
+// Windows and dialogs (no-ops)
+
+#define WM_INITDIALOG  0x0110
+#define WM_COMMAND     0x0111
+#define WM_HSCROLL     0x0114
+#define WM_VSCROLL     0x0115
+#define WM_USER        0x0400
+#define BM_GETCHECK    0x00F0
+#define BM_SETCHECK    0x00F1
+#define BST_UNCHECKED  0
+#define BST_CHECKED    1
+#define IDOK           1
+#define IDCANCEL       2
+#define IDHELP         9
+#define SB_LINELEFT    0
+#define SB_LINERIGHT   1
+#define SB_THUMBTRACK  5
+#define SB_THUMBPOSITION 4
+
+LRESULT SendMessage (HWND hWnd, UINT msg, WPARAM wp, LPARAM lp);
+LRESULT SendDlgItemMessage (HWND hWnd, int id, UINT msg, WPARAM wp, LPARAM lp);
+HWND GetDlgItem (HWND hWnd, int id);
+int GetDlgCtrlID (HWND hWnd);
+BOOL SetWindowText (HWND hWnd, LPCSTR str);
+int GetWindowText (HWND hWnd, LPSTR str, int n);
+BOOL EnableWindow (HWND hWnd, BOOL enable);
+BOOL ShowWindow (HWND hWnd, int cmd);
+UINT GetDlgItemInt (HWND hWnd, int id, BOOL *ok, BOOL sign);
+BOOL SetDlgItemInt (HWND hWnd, int id, UINT val, BOOL sign);
+
+#endif // !__HEADLESS_WINDOWS_H
@@ -0,0 +1,79 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Insignia.cpp
+// Shared fuselage insignia surfaces
+// ==============================================================
+
+#include "Insignia.h"
+#include "StepProfile.h"
+#include <string.h>
+
+Insignia::ENTRY *Insignia::entry = NULL;
+int Insignia::nentry = 0;
+int Insignia::nbuf = 0;
+
+// ==============================================================
+
+SURFHANDLE Insignia::Acquire (SURFHANDLE base, const char *name, bool &paint)
+{
+	char mark[INSIGNIA_MARKLEN+1];
+	strncpy (mark, name, INSIGNIA_MARKLEN);
+	mark[INSIGNIA_MARKLEN] = '\0';
+
+	int i;
+	for (i = 0; i < nentry; i++)
+		if (entry[i].base == base && !strcmp (entry[i].mark, mark)) {
+			entry[i].refs++;
+			paint = false;
+			return entry[i].tex;
+		}
+
+	SURFHANDLE tex = oapiCreateTextureSurface (256, 256);
+	if (!tex) {
+		paint = false;
+		return NULL;
+	}
+	if (nentry == nbuf) {
+		ENTRY *tmp = new ENTRY[nbuf += 16];
+		if (nentry) {
+			memcpy (tmp, entry, nentry*sizeof(ENTRY));
+			delete []entry;
+		}
+		entry = tmp;
+	}
+	ENTRY &e = entry[nentry++];
+	e.base = base;
+	strcpy (e.mark, mark);
+	e.tex = tex;
+	e.refs = 1;
+	paint = true;
+	PROFILE_COUNT (INSIGNIA_PAINT);
+	return tex;
+}
+
+// ==============================================================
+
+void Insignia::Release (SURFHANDLE tex)
+{
+	for (int i = 0; i < nentry; i++)
+		if (entry[i].tex == tex) {
+			if (!--entry[i].refs) {
+				oapiDestroySurface (tex);
+				entry[i] = entry[--nentry];
+			}
+			return;
+		}
+}
+
+// ==============================================================
+
+void Insignia::Exit ()
+{
+	if (nbuf) delete []entry;
+	entry = NULL;
+	nentry = nbuf = 0;
+}
@@ -0,0 +1,56 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Insignia.h
+// Shared fuselage insignia surfaces
+//
+// Notes:
+// * The insignia texture of a Scout is its base panel texture (the
+//   mesh template's, or the one of its skin) with the first 10
+//   characters of the vessel name painted on it. Vessels with the
+//   same base and the same name prefix look the same, so they
+//   share one surface.
+// * Surfaces are only created for vessels with a visual, and are
+//   destroyed when the last visual using them goes away.
+// * Main thread only.
+// ==============================================================
+
+#ifndef __INSIGNIA_H
+#define __INSIGNIA_H
+
+#include "Orbitersdk.h"
+
+const int INSIGNIA_MARKLEN = 10;
+// number of name characters painted on the insignia
+
+class Insignia {
+public:
+	static SURFHANDLE Acquire (SURFHANDLE base, const char *name, bool &paint);
+	// Return the insignia surface for base texture base and vessel
+	// name name. If paint is returned true, the surface is new and
+	// the caller must copy the base texture into it and paint the
+	// markings.
+
+	static void Release (SURFHANDLE tex);
+	// Unregister a user of surface tex. The surface is destroyed
+	// with the last user.
+
+	static void Exit ();
+	// Module cleanup
+
+private:
+	struct ENTRY {
+		SURFHANDLE base;      // base panel texture (may be NULL)
+		char mark[INSIGNIA_MARKLEN+1]; // painted name prefix
+		SURFHANDLE tex;       // shared surface
+		int refs;             // number of users
+	};
+
+	static ENTRY *entry;         // surface list
+	static int nentry, nbuf;     // list length, allocated size
+};
+
+#endif // !__INSIGNIA_H
@@ -192,7 +192,7 @@ bool InstrAOA::Redraw2D (SURFHANDLE surf)
 		}
 
 		// wing load LEDs
-		double load = vessel->GetLift() / 190.0;
+		double load = ((Scout*)vessel)->FrameState().lift / 190.0;
 		static double rowh = 60.0;
 		static double loadmax = WINGLOAD_MAX*60.0/51.0;
 		double h = min(fabs(load)/loadmax,1.0)*rowh;
@@ -0,0 +1,294 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// LuaProfile.cpp
+// Sampling profiler for scripts running in Scout interpreters
+// ==============================================================
+
+#include "LuaProfile.h"
+#include "Orbitersdk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+#include "lua\lua.h"
+#include "lua\lualib.h"
+#include "lua\lauxlib.h"
+}
+
+bool LuaProfile::enabled = false;
+bool LuaProfile::csinit = false;
+CRITICAL_SECTION LuaProfile::cs;
+double LuaProfile::cps = 1e9;
+LuaProfile::FUNC *LuaProfile::func = NULL;
+LuaProfile::STATE LuaProfile::state[LUAPROF_NTHREAD];
+int LuaProfile::nstate = 0;
+
+// ==============================================================
+
+void LuaProfile::Enable ()
+{
+	if (enabled) return;
+	if (!csinit) {
+		InitializeCriticalSection (&cs);
+		csinit = true;
+	}
+
+	// calibrate the cycle counter against the performance counter
+	// by spinning for 10 ms
+	LARGE_INTEGER freq, t0, t1;
+	QueryPerformanceFrequency (&freq);
+	QueryPerformanceCounter (&t0);
+	ULONGLONG c0 = Cycles ();
+	do QueryPerformanceCounter (&t1);
+	while (t1.QuadPart - t0.QuadPart < freq.QuadPart/100);
+	ULONGLONG c1 = Cycles ();
+	if (c1 > c0)
+		cps = (double)(c1-c0) * (double)freq.QuadPart / (double)(t1.QuadPart-t0.QuadPart);
+
+	FUNC *tab = new FUNC[LUAPROF_NFUNC+1];
+	memset (tab, 0, (LUAPROF_NFUNC+1)*sizeof(FUNC));
+	strcpy (tab[LUAPROF_NFUNC].name, "(other)");
+	tab[LUAPROF_NFUNC].line = -1;
+	tab[LUAPROF_NFUNC].used = true;
+	EnterCriticalSection (&cs);
+	func = tab;
+	nstate = 0;
+	enabled = true;
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+void LuaProfile::Install (lua_State *L)
+{
+	if (enabled)
+		lua_sethook (L, Hook, LUA_MASKCALL | LUA_MASKCOUNT, LUAPROF_COUNT);
+}
+
+// ==============================================================
+// Cycles used by the calling thread
+
+ULONGLONG LuaProfile::Cycles ()
+{
+	ULONGLONG c;
+	return (QueryThreadCycleTime (GetCurrentThread(), &c) ? c : 0);
+}
+
+// ==============================================================
+// 64-bit FNV-1a hash of a chunk's source text
+
+ULONGLONG LuaProfile::SourceHash (const char *src)
+{
+	ULONGLONG h = 14695981039346656037ull;
+	for (; *src; src++) {
+		h ^= (unsigned char)*src;
+		h *= 1099511628211ull;
+	}
+	return h;
+}
+
+// ==============================================================
+// Find or create the table entry of the function at activation
+// record ar. Called with cs held.
+
+LuaProfile::FUNC *LuaProfile::Lookup (lua_State *L, lua_Debug *ar)
+{
+	FUNC *f;
+
+	if (!lua_getinfo (L, "f", ar)) return func+LUAPROF_NFUNC;
+
+	// entry cached for this function object?
+	lua_getfield (L, LUA_REGISTRYINDEX, LUAPROF_CACHE);
+	if (!lua_istable (L, -1)) {
+		lua_pop (L, 1);
+		lua_newtable (L);
+		lua_createtable (L, 0, 1);
+		lua_pushstring (L, "k");
+		lua_setfield (L, -2, "__mode");
+		lua_setmetatable (L, -2);
+		lua_pushvalue (L, -1);
+		lua_setfield (L, LUA_REGISTRYINDEX, LUAPROF_CACHE);
+	}
+	lua_pushvalue (L, -2);
+	lua_rawget (L, -2);
+	if (lua_islightuserdata (L, -1)) {
+		f = (FUNC*)lua_touserdata (L, -1);
+		lua_pop (L, 3);
+		return f;
+	}
+	lua_pop (L, 1);
+
+	// first sight: hash the source and find or create the entry
+	f = Lookup (L, ar, lua_tocfunction (L, -2));
+	lua_pushvalue (L, -2);
+	lua_pushlightuserdata (L, f);
+	lua_rawset (L, -3);
+	lua_pop (L, 2);
+	return f;
+}
+
+// ==============================================================
+// Table entry of the function at activation record ar, by source
+// hash (cfunc: entry point of a C function, or NULL). Called with
+// cs held.
+
+LuaProfile::FUNC *LuaProfile::Lookup (lua_State *L, lua_Debug *ar, lua_CFunction cfunc)
+{
+	ULONGLONG key;
+	int line;
+
+	if (!lua_getinfo (L, "Sn", ar)) return func+LUAPROF_NFUNC;
+	if (ar->what[0] == 'C') {
+		key = (ULONGLONG)(size_t)cfunc;
+		line = -1;
+	} else {
+		key = (ar->source ? SourceHash (ar->source) : 0);
+		line = ar->linedefined;
+	}
+	if (!key) return func+LUAPROF_NFUNC;
+
+	// open addressing, linear probing
+	DWORD h = (DWORD)(key ^ (key >> 32)) * 2654435761u + (DWORD)line * 40503u;
+	for (int i = 0; i < LUAPROF_NFUNC; i++) {
+		FUNC *f = func + ((h+i) % LUAPROF_NFUNC);
+		if (f->used && f->key == key && f->line == line) return f;
+		if (!f->used) {
+			f->used = true;
+			f->key = key;
+			f->line = line;
+			// name and location, truncated to fit
+			if (line < 0) _snprintf (f->name, 64, "%.59s [C]", ar->name ? ar->name : "?");
+			else          _snprintf (f->name, 64, "%.27s (%.20s:%d)", ar->name ? ar->name : "?", ar->short_src, line);
+			f->name[63] = '\0';
+			for (char *c = f->name; *c; c++)
+				if (*c == '"') *c = '\''; // keep the CSV field quoting intact
+			return f;
+		}
+	}
+	return func+LUAPROF_NFUNC;
+}
+
+// ==============================================================
+
+void LuaProfile::Hook (lua_State *L, lua_Debug *ar)
+{
+	if (!enabled) return;
+	if (ar->event == LUA_HOOKCALL) {
+		EnterCriticalSection (&cs);
+		if (func) Lookup (L, ar)->ncall++;
+		LeaveCriticalSection (&cs);
+		return;
+	}
+	if (ar->event != LUA_HOOKCOUNT) return;
+
+	ULONGLONG now = Cycles ();
+	DWORD tid = GetCurrentThreadId();
+	int i;
+
+	EnterCriticalSection (&cs);
+	if (!func) { // profiler shut down since the check above
+		LeaveCriticalSection (&cs);
+		return;
+	}
+	for (i = 0; i < nstate; i++)
+		if (state[i].tid == tid) break;
+	if (i == nstate) {
+		if (nstate < LUAPROF_NTHREAD) {
+			state[nstate].tid = tid;
+			state[nstate++].tprev = now;
+		}
+		LeaveCriticalSection (&cs);
+		return;
+	}
+	double dt = (double)(now - state[i].tprev) / cps;
+	state[i].tprev = now;
+
+	if (dt <= LUAPROF_MAXDT) {
+		FUNC *seen[LUAPROF_MAXDEPTH];
+		int level, nseen = 0;
+		lua_Debug sar;
+		for (level = 0; level < LUAPROF_MAXDEPTH && lua_getstack (L, level, &sar); level++) {
+			FUNC *f = Lookup (L, &sar);
+			if (!level) {
+				f->nsample++;
+				f->tself += dt;
+			}
+			// book total time once per function, even if recursive
+			for (i = 0; i < nseen; i++)
+				if (seen[i] == f) break;
+			if (i == nseen) {
+				seen[nseen++] = f;
+				f->ttotal += dt;
+			}
+		}
+	}
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+int LuaProfile::CompareSelf (const void *a, const void *b)
+{
+	double ta = (*(FUNC* const*)a)->tself;
+	double tb = (*(FUNC* const*)b)->tself;
+	return (ta > tb ? -1 : ta < tb ? 1 : 0);
+}
+
+// ==============================================================
+
+int LuaProfile::Dump ()
+{
+	if (!enabled) return -1;
+
+	FILE *f = fopen (LUAPROF_FILE, "wt");
+	if (!f) return -1;
+
+	// sort a snapshot of the used entries by self time
+	FUNC *list = new FUNC[LUAPROF_NFUNC+1];
+	FUNC **order = new FUNC*[LUAPROF_NFUNC+1];
+	int i, n = 0;
+	EnterCriticalSection (&cs);
+	for (i = 0; i <= LUAPROF_NFUNC; i++)
+		if (func[i].ncall || func[i].nsample)
+			list[n++] = func[i];
+	LeaveCriticalSection (&cs);
+	for (i = 0; i < n; i++) order[i] = list+i;
+	qsort (order, n, sizeof(FUNC*), CompareSelf);
+
+	fprintf (f, "function,calls,samples,self_ms,total_ms\n");
+	for (i = 0; i < n; i++) {
+		FUNC *p = order[i];
+		fprintf (f, "\"%s\",%lu,%lu,%0.3f,%0.3f\n", p->name,
+			(unsigned long)p->ncall, (unsigned long)p->nsample, p->tself*1e3, p->ttotal*1e3);
+	}
+	fclose (f);
+	delete []order;
+	delete []list;
+
+	char cbuf[256];
+	sprintf (cbuf, "Scout: Lua profile of %d functions written to %s", n, LUAPROF_FILE);
+	oapiWriteLog (cbuf);
+	return n;
+}
+
+// ==============================================================
+
+void LuaProfile::Exit ()
+{
+	if (!enabled) return;
+	Dump ();
+
+	// Interpreters that outlive the profiler keep their hooks, which
+	// may be running on other threads: release the table under cs.
+	// The hooks find func == NULL and return. cs itself is kept.
+	EnterCriticalSection (&cs);
+	enabled = false;
+	delete []func;
+	func = NULL;
+	LeaveCriticalSection (&cs);
+}
@@ -0,0 +1,120 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// LuaProfile.h
+// Sampling profiler for scripts running in Scout interpreters
+//
+// Notes:
+// * Opt-in with LUA_PROFILE = TRUE in the class cfg. The hook is
+//   installed in every interpreter that Scout::Lua_InitInterpreter
+//   sees after that, including the autopilot interpreters.
+// * A call hook counts calls per function. A count hook samples
+//   the stack every LUAPROF_COUNT instructions; the CPU time the
+//   thread used since its previous sample is booked as self time
+//   of the running function and as total time of every distinct
+//   function on the stack.
+// * The sample clock is the thread's cycle counter
+//   (QueryThreadCycleTime), converted to seconds with a rate
+//   calibrated in Enable. An interpreter waiting for its next
+//   command uses no cycles, so idle time between frames isn't
+//   booked to the script that happened to run last. Intervals
+//   over LUAPROF_MAXDT (e.g. non-script work of the interpreter
+//   thread) are still dropped.
+// * Interpreters run in their own threads, so the sample clock is
+//   kept per thread; coroutines inherit the hooks of the thread
+//   that created them.
+// * Functions are identified by a hash of their chunk's source
+//   text plus first line, so the same script loaded into several
+//   interpreters (or reloaded) is booked to one entry, and a chunk
+//   freed and replaced by another can't inherit its entries. C
+//   functions are identified by their entry point. The source is
+//   hashed only the first time a function object is seen in an
+//   interpreter; its entry is then cached in a weak-keyed registry
+//   table (LUAPROF_CACHE) keyed by the function. Entries are
+//   aggregated in a fixed-size table of LUAPROF_NFUNC entries;
+//   functions that don't fit are booked to a single overflow entry.
+// * The table is written as CSV (LUAPROF_FILE) when the module is
+//   unloaded, or when a script calls dg:ProfileDump().
+// ==============================================================
+
+#ifndef __LUAPROFILE_H
+#define __LUAPROFILE_H
+
+#include <windows.h>
+
+struct lua_State;
+
+const int LUAPROF_NFUNC = 512;
+// size of the function table
+
+const int LUAPROF_COUNT = 1000;
+// instructions between samples
+
+const double LUAPROF_MAXDT = 0.05;
+// max. CPU time booked for one sample interval [s]
+
+const int LUAPROF_NTHREAD = 16;
+// max. number of interpreter threads timed
+
+const int LUAPROF_MAXDEPTH = 32;
+// max. stack depth booked for total time
+
+#define LUAPROF_FILE "ScoutLuaProfile.csv"
+// output file, relative to the Orbiter root directory
+
+#define LUAPROF_CACHE "LuaProfile.func"
+// registry key of the function -> entry cache
+
+class LuaProfile {
+public:
+	static void Enable ();
+	// Switch the profiler on for interpreters initialised from now on
+
+	static void Install (lua_State *L);
+	// Install the hooks in interpreter L if the profiler is enabled
+
+	static int Dump ();
+	// Write the table to LUAPROF_FILE. Returns the number of
+	// functions written, or -1 if the profiler is not enabled or
+	// the file can't be created.
+
+	static void Exit ();
+	// Dump (if enabled) and release the function table. Call from
+	// ExitModule. Hooks still installed in live interpreters become
+	// no-ops.
+
+private:
+	struct FUNC {
+		ULONGLONG key;        // source hash, or C function entry
+		int line;             // first line of the function (-1 for C)
+		bool used;            // entry in use?
+		char name[64];        // function name and location
+		DWORD ncall;          // number of calls
+		DWORD nsample;        // samples with the function running
+		double tself, ttotal; // self and total time [s]
+	};
+	struct STATE {
+		DWORD tid;            // interpreter thread
+		ULONGLONG tprev;      // thread cycles at the previous sample
+	};
+
+	static void Hook (lua_State *L, struct lua_Debug *ar);
+	static FUNC *Lookup (lua_State *L, struct lua_Debug *ar);
+	static FUNC *Lookup (lua_State *L, struct lua_Debug *ar, int (*cfunc)(lua_State*));
+	static int CompareSelf (const void *a, const void *b);
+	static ULONGLONG SourceHash (const char *src);
+	static ULONGLONG Cycles ();
+
+	static bool enabled;
+	static bool csinit;       // cs initialised (once, never deleted)
+	static CRITICAL_SECTION cs;
+	static double cps;        // thread cycles per second
+	static FUNC *func;        // function table (LUAPROF_NFUNC+1 entries, last = overflow)
+	static STATE state[LUAPROF_NTHREAD]; // sample clocks
+	static int nstate;
+};
+
+#endif // !__LUAPROFILE_H
@@ -10,114 +10,280 @@
 
 #include "Ramjet.h"
 
+Ramjet::TABLE *Ramjet::tab_first = 0;
+int Ramjet::ninst = 0;
+
 // constructor
 Ramjet::Ramjet (VESSEL *_vessel): vessel(_vessel)
 {
 	nthdef = 0;    // no thrusters associated yet
+	nbuf = 0;
+	th = 0;
+	buf = 0;
+	tab_enabled = false;
+	tab = 0;
+	ninst++;
 }
 
 // destructor
 Ramjet::~Ramjet ()
 {
-	if (nthdef) {  // delete list of thruster definitions
-		for (UINT i = 0; i < nthdef; i++)
-			delete thdef[i];
-		delete []thdef;
+	if (nbuf) {    // delete engine arrays
+		delete []th;
+		delete []buf;
+	}
+	if (!--ninst) { // last instance: free the inlet tables
+		while (tab_first) {
+			TABLE *next = tab_first->next;
+			delete tab_first;
+			tab_first = next;
+		}
+	}
+}
+
+// enlarge engine arrays (capacity is doubled, so repeated calls to
+// AddThrusterDefinition don't reallocate for every engine)
+void Ramjet::Grow ()
+{
+	const UINT nfield = 9;
+	double **fld[nfield] = {&Qr, &Ai, &Tb_max, &dmf_max, &dmf, &F, T, T+1, T+2};
+	UINT i, n = (nbuf ? nbuf*2 : 2);
+
+	THRUSTER_HANDLE *tmp_th = new THRUSTER_HANDLE[n];
+	double *tmp = new double[n*nfield];
+	memset (tmp, 0, n*nfield*sizeof(double));
+	for (i = 0; i < nfield; i++) {
+		if (nthdef) memcpy (tmp+i*n, *fld[i], nthdef*sizeof(double));
+		*fld[i] = tmp+i*n;
 	}
+	if (nbuf) {
+		memcpy (tmp_th, th, nthdef*sizeof(THRUSTER_HANDLE));
+		delete []th;
+		delete []buf;
+	}
+	th = tmp_th;
+	buf = tmp;
+	nbuf = n;
+}
+
+// switch table mode on or off
+void Ramjet::EnableTable (bool enable)
+{
+	tab_enabled = enable;
+}
+
+// The pressure recovery 1-0.075*(M-1)^1.35 drops to zero at Mcut,
+// so the table covers [0,Mcut] and no thrust is produced beyond.
+static const double precov_a = 0.075;
+static const double precov_b = 1.35;
+
+const Ramjet::TABLE *Ramjet::Table (const ATMCONST *atm)
+{
+	TABLE *t;
+	for (t = tab_first; t; t = t->next)
+		if (t->atm == atm) return t;
+
+	const double Mcut = 1.0 + pow (1.0/precov_a, 1.0/precov_b);
+	const double dM = Mcut/RAMJET_TABLE_NODES;
+	const double ex = atm->gamma/(atm->gamma-1.0);
+	double M, tr, precov;
+
+	t = new TABLE;
+	for (UINT i = 0; i <= RAMJET_TABLE_NODES; i++) {
+		M = i*dM;
+		tr = 1.0 + 0.5*(atm->gamma-1.0) * M*M;
+		precov = max (0.0, 1.0-precov_a*pow (max(M,1.0)-1.0, precov_b));
+		t->pfac[i] = pow (tr, ex) * precov;
+	}
+	t->pfac[RAMJET_TABLE_NODES] = 0.0; // exact zero at cutoff
+	t->idM = 1.0/dM;
+	t->atm = atm;
+	t->next = tab_first;
+	tab_first = t;
+	return t;
 }
 
 // add new thruster definition to list
 void Ramjet::AddThrusterDefinition (THRUSTER_HANDLE th,
 	double Qr, double Ai, double Tb_max, double dmf_max)
 {
-	THDEF *thd   = new THDEF;
-	thd->th      = th;
-	thd->Qr      = Qr;
-	thd->Ai      = Ai;
-	thd->Tb_max  = Tb_max;
-	thd->dmf_max = dmf_max;
-	thd->dmf     = 0.0;
-	thd->F       = 0.0;
-	for (int i = 0; i < 3; i++) thd->T[i] = 0.0;
-
-	THDEF **tmp = new THDEF*[nthdef+1];
-	if (nthdef) {
-		memcpy (tmp, thdef, nthdef*sizeof (THDEF*));
-		delete []thdef;
-	}
-	thdef = tmp;
-	thdef[nthdef++] = thd;
+	if (nthdef == nbuf) Grow ();
+
+	UINT i = nthdef++;
+	this->th[i]      = th;
+	this->Qr[i]      = Qr;
+	this->Ai[i]      = Ai;
+	this->Tb_max[i]  = Tb_max;
+	this->dmf_max[i] = dmf_max;
+	dmf[i]           = 0.0;
+	F[i]             = 0.0;
+	T[0][i] = T[1][i] = T[2][i] = 0.0;
 }
 
 // calculate current thrust force for all engines
-void Ramjet::Thrust (double *F) const
+void Ramjet::Thrust (double *Fres) const
 {
 	const OBJHANDLE hBody = vessel->GetAtmRef();
+	if (hBody)
+		Thrust (Fres, hBody, vessel->GetMachNumber(), vessel->GetAtmTemperature(), vessel->GetAtmPressure());
+	else
+		Thrust (Fres, hBody, 0.0, 0.0, 0.0);
+}
+
+// calculate thrust force for all engines for a given flight state
+void Ramjet::Thrust (double *Fres, OBJHANDLE hBody, double M, double T0, double p0) const
+{
 	const ATMCONST *atm = (hBody ? oapiGetPlanetAtmConstants (hBody) : 0);
+	double lvl[16] = {0.0}, *plvl = (nthdef <= 16 ? lvl : new double[nthdef]);
+	for (UINT i = 0; i < nthdef; i++)
+		plvl[i] = (atm ? vessel->GetThrusterLevel (th[i]) : 0.0);
+	Thrust (Fres, atm, plvl, M, T0, p0);
+	if (plvl != lvl) delete []plvl;
+}
+
+// build the inlet table ahead of a call from a worker thread
+void Ramjet::Prepare (const ATMCONST *atm) const
+{
+	if (tab_enabled && atm && (!tab || tab->atm != atm)) tab = Table (atm);
+}
+
+// calculate thrust force for all engines for a given flight state
+// and throttle levels (no Orbiter API calls)
+void Ramjet::Thrust (double *Fres, const ATMCONST *atm, const double *lvls, double M, double T0, double p0) const
+{
+	UINT i;
 
 	if (atm) { // atmospheric parameters available
-		
-		double M, Fs, T0, Td, Tb, Tb0, Te, p0, pd, D, rho, cp, v0, ve, tr, lvl, dma, dmf, precov, dmafac;
-		const double eps = 1e-4;
+
+		double Td, Tb, Tb0, pd, D, cp, icp, v0, tr, lvl, dma, dmfi, precov, dmafac, Tfac, vefac;
+		const double dma_scale = 2.7e-4;
+
+		cp  = atm->gamma * atm->R / (atm->gamma-1.0);      // specific heat (pressure)
+		icp = 1.0/cp;
+		v0  = M * sqrt (atm->gamma * atm->R * T0);         // freestream velocity
+		tr  = (1.0 + 0.5*(atm->gamma-1.0) * M*M);          // temperature ratio
+		Td  = T0 * tr;                                     // diffuser temperature
+		if (tab_enabled) {                                 // inlet terms from table
+			if (!tab || tab->atm != atm) tab = Table (atm);
+			double x = M*tab->idM, u;
+			UINT k = (UINT)x;
+			if (k < RAMJET_TABLE_NODES) {
+				u = x-k;
+				dmafac = dma_scale*p0*(tab->pfac[k] + (tab->pfac[k+1]-tab->pfac[k])*u);
+			} else dmafac = 0.0;                           // beyond pressure recovery cutoff
+		} else {
+			pd  = p0 * pow (tr, atm->gamma/(atm->gamma-1.0)); // diffuser pressure
+			precov = max (0.0, 1.0-precov_a*pow (max(M,1.0)-1.0, precov_b)); // pressure recovery
+			dmafac = dma_scale*precov*pd;
+		}
+
+		// Isentropic expansion from pd back to p0 gives
+		// Te/Tb = (p0/pd)^((g-1)/g) = 1/tr for every engine, so the
+		// exhaust temperature ratio doesn't need a pow per engine.
+		Tfac  = 1.0/tr;
+		vefac = 2.0*cp*(1.0-Tfac);
+
+		for (i = 0; i < nthdef; i++) {
+			Tb0 = Tb_max[i];                               // max burner temperature
+			if (Tb0 > Td) {                                // we are within operational range
+				lvl  = lvls[i];                            // throttle level
+				D    = (Tb0-Td) / (Qr[i]*icp - Tb0);       // max fuel-to-air ratio (what if negative?)
+				D   *= lvl;                                // actual fuel-to-air ratio
+
+				dma  = dmafac * Ai[i];                     // air mass flow rate [kg/s]
+				dmfi = D * dma;                            // fuel mass flow rate
+				if (dmfi > dmf_max[i]) {                   // max fuel rate exceeded
+					dmfi = dmf_max[i];
+					D = dmfi/dma;
+				}
+				Tb   = (D*Qr[i]*icp + Td) / (1.0+D);       // actual burner temperature
+				F[i] = Fres[i] = max (0.0, ((1.0+D)*sqrt (vefac*Tb) - v0)*dma); // thrust force
+				dmf[i]  = dmfi;
+				T[1][i] = Tb;
+				T[2][i] = Tb*Tfac;                         // exhaust temperature
+
+			} else {                                       // overheating!
+
+				F[i] = Fres[i] = 0.0;
+				dmf[i] = 0.0;
+				T[1][i] = T[2][i] = Td;
+
+			}
+			T[0][i] = Td;
+		}
+
+	} else {   // no atmospheric parameters
+
+		for (i = 0; i < nthdef; i++) {
+			F[i] = Fres[i] = 0.0;
+			dmf[i] = 0.0;
+		}
+
+	}
+}
+
+#ifdef RAMJET_REFERENCE
+// original thrust calculation, for validation
+void Ramjet::Thrust_ref (double *Fres, const ATMCONST *atm, const double *lvls, double M, double T0, double p0) const
+{
+	if (atm) { // atmospheric parameters available
+
+		double Fs, Td, Tb, Tb0, Te, pd, D, cp, v0, ve, tr, lvl, dma, dmfi, precov, dmafac;
 		const double dma_scale = 2.7e-4;
 
-		M   = vessel->GetMachNumber();                     // Mach number
-		T0  = vessel->GetAtmTemperature();                 // freestream temperature
-		p0  = vessel->GetAtmPressure();                    // freestream pressure
-		rho = vessel->GetAtmDensity();                     // freestream density
 		cp  = atm->gamma * atm->R / (atm->gamma-1.0);      // specific heat (pressure)
 		v0  = M * sqrt (atm->gamma * atm->R * T0);         // freestream velocity
 		tr  = (1.0 + 0.5*(atm->gamma-1.0) * M*M);          // temperature ratio
 		Td  = T0 * tr;                                     // diffuser temperature
 		pd  = p0 * pow (Td/T0, atm->gamma/(atm->gamma-1.0)); // diffuser pressure
-		precov = max (0.0, 1.0-0.075*pow (max(M,1.0)-1.0, 1.35)); // pressure recovery
+		precov = max (0.0, 1.0-precov_a*pow (max(M,1.0)-1.0, precov_b)); // pressure recovery
 		dmafac = dma_scale*precov*pd;
 
 		for (UINT i = 0; i < nthdef; i++) {
-			Tb0 = thdef[i]->Tb_max;                        // max burner temperature
+			Tb0 = Tb_max[i];                               // max burner temperature
 			if (Tb0 > Td) {                                // we are within operational range
-				lvl  = vessel->GetThrusterLevel (thdef[i]->th); // throttle level
-				D    = (Tb0-Td) / (thdef[i]->Qr/cp - Tb0); // max fuel-to-air ratio (what if negative?)
+				lvl  = lvls[i];                            // throttle level
+				D    = (Tb0-Td) / (Qr[i]/cp - Tb0);        // max fuel-to-air ratio
 				D   *= lvl;                                // actual fuel-to-air ratio
 
-				dma = dmafac * thdef[i]->Ai;               // air mass flow rate [kg/s]
-				//dma  = rho * v0 * thdef[i]->Ai;            // air mass flow rate
-				dmf  = D * dma;                            // fuel mass flow rate
-				if (dmf > thdef[i]->dmf_max) {             // max fuel rate exceeded
-					dmf = thdef[i]->dmf_max;
-					D = dmf/dma;
+				dma  = dmafac * Ai[i];                     // air mass flow rate [kg/s]
+				dmfi = D * dma;                            // fuel mass flow rate
+				if (dmfi > dmf_max[i]) {                   // max fuel rate exceeded
+					dmfi = dmf_max[i];
+					D = dmfi/dma;
 				}
-				Tb   = (D*thdef[i]->Qr/cp + Td) / (1.0+D); // actual burner temperature
+				Tb   = (D*Qr[i]/cp + Td) / (1.0+D);        // actual burner temperature
 				Te   = Tb * pow (p0/pd, (atm->gamma-1.0)/atm->gamma); // exhaust temperature
 				ve   = sqrt (2.0*cp*(Tb-Te));              // exhaust velocity
-			    Fs  = (1.0+D)*ve - v0;                     // specific thrust
-				thdef[i]->F = F[i] = max (0.0, Fs*dma);    // thrust force
-				thdef[i]->dmf = dmf;
-				thdef[i]->T[1] = Tb;
-				thdef[i]->T[2] = Te;
+				Fs   = (1.0+D)*ve - v0;                    // specific thrust
+				F[i] = Fres[i] = max (0.0, Fs*dma);        // thrust force
+				dmf[i]  = dmfi;
+				T[1][i] = Tb;
+				T[2][i] = Te;
 
 			} else {                                       // overheating!
 
-				thdef[i]->F = F[i] = 0.0;
-				thdef[i]->dmf = 0.0;
-				thdef[i]->T[1] = thdef[i]->T[2] = Td;
+				F[i] = Fres[i] = 0.0;
+				dmf[i] = 0.0;
+				T[1][i] = T[2][i] = Td;
 
 			}
-			thdef[i]->T[0] = Td;
+			T[0][i] = Td;
 		}
 
 	} else {   // no atmospheric parameters
 
 		for (UINT i = 0; i < nthdef; i++) {
-			thdef[i]->F = F[i] = 0.0;
-			thdef[i]->dmf = 0.0;
+			F[i] = Fres[i] = 0.0;
+			dmf[i] = 0.0;
 		}
 
 	}
 }
+#endif
 
 double Ramjet::TSFC (UINT idx) const
 {
 	const double eps = 1e-5;
-	return thdef[idx]->dmf/(thdef[idx]->F+eps);
+	return dmf[idx]/(F[idx]+eps);
 }
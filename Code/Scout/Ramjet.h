@@ -20,6 +20,10 @@
 
 #include "Orbitersdk.h"
 
+const UINT RAMJET_TABLE_NODES = 4096;
+// number of Mach intervals in the inlet performance table (32 KB
+// per atmosphere)
+
 class Ramjet {
 public:
 	Ramjet (VESSEL *_vessel);
@@ -49,31 +53,89 @@ public:
 	// On input, F must point to an array of at least the same
 	// length as the number of thruster definitions (nthdef)
 
-	inline double DMF (UINT idx) const { return thdef[idx]->dmf; }
+	void Thrust (double *F, OBJHANDLE hBody, double M, double T0, double p0) const;
+	// As above, but with the atmospheric flight state (reference
+	// body, Mach number, freestream temperature and pressure)
+	// supplied by the caller instead of queried from the vessel
+
+	void Thrust (double *F, const ATMCONST *atm, const double *lvl, double M, double T0, double p0) const;
+	// As above, with the atmosphere constants (NULL: no atmosphere)
+	// and the throttle level of each thruster also supplied by the
+	// caller. This version doesn't call the Orbiter API, so it can
+	// run on a worker thread, provided that Prepare has been called
+	// for atm on the main thread.
+
+#ifdef RAMJET_REFERENCE
+	void Thrust_ref (double *F, const ATMCONST *atm, const double *lvl, double M, double T0, double p0) const;
+	// Original per-engine evaluation, with the diffuser pressure and
+	// the exhaust temperature computed through pow() for every
+	// engine. Same arguments and outputs as Thrust, analytic inlet
+	// terms only. Kept to validate Thrust (see the headless host).
+#endif
+
+	void Prepare (const ATMCONST *atm) const;
+	// In table mode, make sure that the inlet table for atm exists
+
+	inline double DMF (UINT idx) const { return dmf[idx]; }
 	// returns current fuel mass flow of thruster idx
 
-	inline double Temp (UINT idx, UINT which) const { return thdef[idx]->T[which]; }
+	inline double Temp (UINT idx, UINT which) const { return T[which][idx]; }
 	// returns diffuser, combustion or exhaust temperature [K] of thruster idx
 
 	double TSFC (UINT idx) const;
 	// returns thrust-specific fuel consumption of thruster idx
 	// based on last thrust calculation
 
+	void EnableTable (bool enable);
+	// Select table mode for Thrust(). In table mode the inlet terms
+	// (diffuser pressure ratio and pressure recovery), which depend
+	// only on Mach number and the atmosphere constants, are read from
+	// a table built once per reference body instead of being
+	// evaluated with pow() at every call. With RAMJET_TABLE_NODES=4096
+	// the interpolated thrust stays within 0.1% of the analytic
+	// value (Earth, Mach 0-7.76, T0 180-300 K, p0 10 Pa-100 kPa), and
+	// within 1.3e-4 of the peak thrust between Mach 7.76 and the
+	// recovery cutoff (Mach 7.81), where thrust goes to zero. The
+	// headless host checks both bounds (mode ramjettable).
+	// The tables are shared by all Ramjet instances.
+
 private:
+	struct TABLE {             // inlet table for one atmosphere
+		const ATMCONST *atm;   // atmosphere the table was built for
+		double idM;            // inverse Mach node spacing
+		double pfac[RAMJET_TABLE_NODES+1]; // (pd/p0)*precov at Mach nodes
+		TABLE *next;           // next table in the list
+	};
+
+	static const TABLE *Table (const ATMCONST *atm);
+	// return the table for atmosphere atm, building it on first use
+
+	void Grow ();
+	// enlarge the engine arrays to hold at least one more engine
+
 	VESSEL *vessel;            // vessel pointer
-	
-	struct THDEF {             // list of ramjet thrusters
-		THRUSTER_HANDLE th;    //   thruster handle                -+
-		double Qr;             //   fuel heating parameter [J/kg]   | static
-		double Ai;             //   air intake cross section [m^2]  | parameters
-		double Tb_max;         //   max. burner temperature [K]     |
-		double dmf_max;        //   max. fuel flow rate [kg/s]     -+
-
-		double dmf;            //   current fuel mass rate [kg/s]  -+ dynamic
-		double F;              //   current thrust [N]              | parameters
-		double T[3];           //   temperatures                   -+
-	} **thdef;
 	UINT nthdef;               // number of ramjet thrusters
+	UINT nbuf;                 // allocated capacity of the engine arrays
+
+	// Engine list, stored as one array per parameter so that Thrust()
+	// runs through contiguous memory. All double arrays share the
+	// single allocation 'buf'.
+	THRUSTER_HANDLE *th;       //   thruster handles               -+
+	double *Qr;                //   fuel heating parameter [J/kg]   | static
+	double *Ai;                //   air intake cross section [m^2]  | parameters
+	double *Tb_max;            //   max. burner temperature [K]     |
+	double *dmf_max;           //   max. fuel flow rate [kg/s]     -+
+
+	double *dmf;               //   current fuel mass rate [kg/s]  -+ dynamic
+	double *F;                 //   current thrust [N]              | parameters
+	double *T[3];              //   temperatures                   -+
+	double *buf;               // storage for all double arrays
+
+	bool tab_enabled;          // use table mode in Thrust()
+	mutable const TABLE *tab;  // table of the last atmosphere
+
+	static TABLE *tab_first;   // inlet tables of all instances
+	static int ninst;          // number of instances (tables are freed with the last)
 };
 
 #endif // !__RAMJET_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ScnParse.cpp
+// Number parsing and formatting for scenario lines
+// ==============================================================
+
+#include "ScnParse.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+
+// exactly representable powers of 10
+static const double pow10tab[23] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Rounding error of the product p = a*b (Dekker), so that
+// a*b = p + error exactly
+static double ProductError (double a, double b, double p)
+{
+	const double split = 134217729.0; // 2^27+1
+	double t, ah, al, bh, bl;
+	t = split*a; ah = t-(t-a); al = a-ah;
+	t = split*b; bh = t-(t-b); bl = b-bh;
+	return ((ah*bh - p) + ah*bl + al*bh) + al*bl;
+}
+
+static inline const char *SkipBlanks (const char *p)
+{
+	while (*p == ' ' || *p == '\t') p++;
+	return p;
+}
+
+static inline bool IsDigit (char c)
+{
+	return (c >= '0' && c <= '9');
+}
+
+// ==============================================================
+
+const char *ScnReadInt (const char *p, int &val)
+{
+	p = SkipBlanks (p);
+	bool neg = (*p == '-');
+	if (*p == '-' || *p == '+') p++;
+	if (!IsDigit (*p)) return NULL;
+	int v = 0;
+	for (; IsDigit (*p); p++) {
+		int d = *p - '0';
+		v = (v <= (INT_MAX-d)/10 ? v*10 + d : INT_MAX); // saturate
+	}
+	val = (neg ? -v : v);
+	return p;
+}
+
+// ==============================================================
+
+const char *ScnReadFloat (const char *p, double &val)
+{
+	p = SkipBlanks (p);
+	const char *p0 = p;
+	bool neg = (*p == '-');
+	if (*p == '-' || *p == '+') p++;
+
+	unsigned __int64 m = 0;  // significant digits
+	int nsig = 0;            // number of significant digits
+	int nexp = 0;            // decimal exponent of m
+	int ndig = 0;            // total digits read
+	for (; IsDigit (*p); p++, ndig++) {
+		if (!nsig && *p == '0') continue; // leading zeros
+		if (nsig < 19) m = m*10 + (*p - '0'), nsig++;
+		else           nexp++, nsig++;
+	}
+	if (*p == '.') {
+		for (p++; IsDigit (*p); p++, ndig++) {
+			if (!nsig && *p == '0') { nexp--; continue; }
+			if (nsig < 19) m = m*10 + (*p - '0'), nsig++, nexp--;
+			else           nsig++;
+		}
+	}
+	if (!ndig) return NULL;
+	if ((*p == 'e' || *p == 'E') &&
+		(IsDigit (p[1]) || ((p[1] == '-' || p[1] == '+') && IsDigit (p[2])))) {
+		int e = 0;
+		p = ScnReadInt (p+1, e);
+		// far beyond the double range either way; keeps nexp from overflowing
+		if (e > 9999) e = 9999;
+		else if (e < -9999) e = -9999;
+		nexp += e;
+	}
+
+	if (nsig <= 15 && nexp >= -22 && nexp <= 22) {
+		// both m and the power of 10 are exact, so a single rounding
+		double v = (double)(__int64)m;
+		v = (nexp < 0 ? v / pow10tab[-nexp] : v * pow10tab[nexp]);
+		val = (neg ? -v : v);
+		return p;
+	}
+
+	char *end;
+	val = strtod (p0, &end);
+	return end;
+}
+
+// ==============================================================
+
+const char *ScnReadToken (const char *p, char *buf, int len)
+{
+	p = SkipBlanks (p);
+	int n = 0;
+	while (*p && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+		if (n < len-1) buf[n++] = *p;
+		p++;
+	}
+	buf[n] = '\0';
+	return (n ? p : NULL);
+}
+
+// ==============================================================
+
+char *ScnWriteInt (char *p, int val)
+{
+	char tmp[12];
+	int n = 0;
+	unsigned int u = (val < 0 ? 0u - (unsigned int)val : (unsigned int)val);
+	if (val < 0) *p++ = '-';
+	do {
+		tmp[n++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u);
+	while (n) *p++ = tmp[--n];
+	*p = '\0';
+	return p;
+}
+
+// ==============================================================
+
+// sprintf fallback of ScnWriteFixed, truncated to len-1 characters
+static char *WriteFixedPrintf (char *p, int len, double val, int ndec)
+{
+	int n = _snprintf (p, len, "%0.*f", ndec, val);
+	if (n < 0 || n >= len) n = len-1; // MS _snprintf: -1 and no terminator
+	p[n] = '\0';
+	return p+n;
+}
+
+char *ScnWriteFixed (char *p, int len, double val, int ndec)
+{
+	if (len < 1) return p;
+	if (ndec < 0) ndec = 0;
+	else if (ndec > 9) ndec = 9;
+	double a = fabs (val);
+	if (!(a < 1e15)) // also catches inf and nan
+		return WriteFixedPrintf (p, len, val, ndec);
+
+	// integer and fractional part are exact; only the scaled
+	// fraction is rounded, by its exact value if it looks like a tie
+	double ia = floor (a), fa = a-ia;
+	double t = fa*pow10tab[ndec], it = floor (t);
+	unsigned __int64 scale = (unsigned __int64)pow10tab[ndec];
+	unsigned __int64 ip = (unsigned __int64)ia;
+	unsigned __int64 fp = (unsigned __int64)it;
+	if (t-it > 0.5 || (t-it == 0.5 && ProductError (fa, pow10tab[ndec], t) >= 0.0)) fp++;
+	if (fp == scale) ip++, fp = 0;
+
+	char tmp[20];
+	int n = 0;
+	do {
+		tmp[n++] = (char)('0' + (int)(ip % 10));
+		ip /= 10;
+	} while (ip);
+	if ((val < 0.0) + n + (ndec ? ndec+1 : 0) >= len)
+		return WriteFixedPrintf (p, len, val, ndec); // doesn't fit
+
+	if (val < 0.0) *p++ = '-';
+	while (n) *p++ = tmp[--n];
+	if (ndec) {
+		*p++ = '.';
+		for (int i = ndec-1; i >= 0; i--) {
+			p[i] = (char)('0' + (int)(fp % 10));
+			fp /= 10;
+		}
+		p += ndec;
+	}
+	*p = '\0';
+	return p;
+}
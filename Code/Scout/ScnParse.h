@@ -0,0 +1,48 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ScnParse.h
+// Number parsing and formatting for scenario lines
+//
+// Notes:
+// * Replacements for sscanf/sprintf on the scenario load and save
+//   paths. They work in place on the caller's buffer, don't
+//   allocate and don't depend on the locale.
+// * The read functions skip leading blanks and return a pointer
+//   past the number, or NULL (with val unchanged) if there is no
+//   number at p, so that calls can be chained.
+// * ScnReadInt saturates at +-INT_MAX. Exponents beyond +-9999 are
+//   clamped by ScnReadFloat, giving inf or 0 as strtod would.
+// * ScnReadFloat is exact for up to 15 significant digits and
+//   decimal exponents up to 22, which covers everything the Scout
+//   writes. Longer numbers are handed to strtod.
+// * ScnWriteFixed matches "%0.*f" for |val| < 1e15. Exact ties
+//   round away from zero, as in the MS runtime. Larger values, and
+//   results that don't fit the buffer, go to _snprintf; the output
+//   is truncated to the buffer size.
+// ==============================================================
+
+#ifndef __SCNPARSE_H
+#define __SCNPARSE_H
+
+const char *ScnReadInt (const char *p, int &val);
+// Read a decimal integer, saturating at +-INT_MAX
+
+const char *ScnReadFloat (const char *p, double &val);
+// Read a floating point number
+
+const char *ScnReadToken (const char *p, char *buf, int len);
+// Copy the next blank-delimited token into buf (at most len-1
+// characters, zero-terminated)
+
+char *ScnWriteInt (char *p, int val);
+// Write val in decimal, return a pointer to the terminating zero
+
+char *ScnWriteFixed (char *p, int len, double val, int ndec);
+// Write val with ndec (0-9) decimals into the len bytes at p,
+// return a pointer to the terminating zero
+
+#endif // !__SCNPARSE_H
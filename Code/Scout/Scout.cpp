@@ -12,6 +12,7 @@
 
 #include "Scout.h"
 #include "AAP.h"
+#include "AeroDB.h"
 #include "MFDButton.h"
 #include "Horizon.h"
 #include "InstrHsi.h"
@@ -38,8 +39,17 @@
 #include "ScnEditorAPI.h"
 #include "DlgCtrl.h"
 #include "meshres.h"
+#include "StepProfile.h"
+#include "LuaProfile.h"
+#include "Sequencer.h"
+#include "ScnParse.h"
+#include "SkinManager.h"
+#include "Insignia.h"
+#include "ScoutClass.h"
+#include "Fleet.h"
 #include <stdio.h>
 #include <math.h>
+#include <ctype.h>
 
 // ==============================================================
 // Global parameters
@@ -69,11 +79,14 @@ void UpdateCtrlDialog (Scout *dg, HWND hWnd = 0);
 // Airfoil coefficient functions
 // Return lift, moment and zero-lift drag coefficients as a
 // function of angle of attack (alpha or beta)
+// The *_ref versions evaluate the breakpoint model directly and
+// are used with AERO_REFERENCE in the class cfg. The default
+// versions read the same model from uniform-grid tables.
 // ==============================================================
 
 // 1. vertical lift component (wings and body)
 
-void VLiftCoeff (VESSEL *v, double aoa, double M, double Re, void *context, double *cl, double *cm, double *cd)
+void VLiftCoeff_ref (VESSEL *v, double aoa, double M, double Re, void *context, double *cl, double *cm, double *cd)
 {
 	int i;
 	const int nabsc = 9;
@@ -92,7 +105,7 @@ void VLiftCoeff (VESSEL *v, double aoa, double M, double Re, void *context, doub
 
 // 2. horizontal lift component (vertical stabilisers and body)
 
-void HLiftCoeff (VESSEL *v, double beta, double M, double Re, void *context, double *cl, double *cm, double *cd)
+void HLiftCoeff_ref (VESSEL *v, double beta, double M, double Re, void *context, double *cl, double *cm, double *cd)
 {
 	int i;
 	const int nabsc = 8;
@@ -104,15 +117,175 @@ void HLiftCoeff (VESSEL *v, double beta, double M, double Re, void *context, dou
 	*cd = 0.015 + oapiGetInducedDrag (*cl, 1.5, 0.6) + oapiGetWaveDrag (M, 0.75, 1.0, 1.1, 0.04);
 }
 
+// 3. tabulated versions
+// The angle grid has 1 degree spacing. All breakpoints of the
+// reference model lie on grid nodes, so lift and moment are
+// reproduced to rounding; the interpolated profile drag differs
+// by less than 4e-5. Induced drag is quadratic in cl and is
+// applied with a precomputed factor. Wave drag is tabulated up to
+// AERO_MACHMAX with nodes on the drag-rise breakpoints; beyond
+// that it is computed directly.
+
+const int AERO_NANG = 360;                   // angle intervals over [-180,180] deg
+const double AERO_DANG = 2.0*PI/AERO_NANG;   // angle node spacing [rad]
+const int AERO_NMACH = 1000;                 // Mach intervals over [0,AERO_MACHMAX]
+const double AERO_MACHMAX = 10.0;
+const double AERO_DMACH = AERO_MACHMAX/AERO_NMACH;
+
+static struct {
+	double cl_v[AERO_NANG+1], cm_v[AERO_NANG+1], cd_v[AERO_NANG+1]; // vertical lift: cl, cm, profile drag
+	double cl_h[AERO_NANG+1], cd_h[AERO_NANG+1];                    // horizontal lift: cl, profile drag
+	double cdw[AERO_NMACH+1];                                       // wave drag
+	double kv, kh;                                                  // induced drag factors
+} g_aero;
+
+void InitAeroTables ()
+{
+	int i;
+	double a, cd;
+	g_aero.kv = oapiGetInducedDrag (1.0, 1.5, 0.7);
+	g_aero.kh = oapiGetInducedDrag (1.0, 1.5, 0.6);
+	for (i = 0; i <= AERO_NANG; i++) {
+		a = -PI + i*AERO_DANG;
+		VLiftCoeff_ref (0, a, 0.0, 0.0, 0, g_aero.cl_v+i, g_aero.cm_v+i, &cd);
+		g_aero.cd_v[i] = cd - g_aero.kv*g_aero.cl_v[i]*g_aero.cl_v[i];
+		HLiftCoeff_ref (0, a, 0.0, 0.0, 0, g_aero.cl_h+i, &cd, &cd);
+		g_aero.cd_h[i] = cd - g_aero.kh*g_aero.cl_h[i]*g_aero.cl_h[i];
+	}
+	for (i = 0; i <= AERO_NMACH; i++)
+		g_aero.cdw[i] = oapiGetWaveDrag (i*AERO_DMACH, 0.75, 1.0, 1.1, 0.04);
+}
+
+static inline double WaveDrag (double M)
+{
+	double x = M*(1.0/AERO_DMACH);
+	int i = (int)x;
+	if (i >= AERO_NMACH) return oapiGetWaveDrag (M, 0.75, 1.0, 1.1, 0.04);
+	return g_aero.cdw[i] + (g_aero.cdw[i+1]-g_aero.cdw[i]) * (x-i);
+}
+
+static inline int AngleIndex (double a, double &f)
+{
+	double x = (a+PI)*(1.0/AERO_DANG);
+	int i = (int)x;
+	if      (i < 0)          i = 0;
+	else if (i >= AERO_NANG) i = AERO_NANG-1;
+	f = x-i;
+	return i;
+}
+
+void VLiftCoeff (VESSEL *v, double aoa, double M, double Re, void *context, double *cl, double *cm, double *cd)
+{
+	double f;
+	int i = AngleIndex (aoa, f);
+	*cl = g_aero.cl_v[i] + (g_aero.cl_v[i+1]-g_aero.cl_v[i]) * f;
+	*cm = g_aero.cm_v[i] + (g_aero.cm_v[i+1]-g_aero.cm_v[i]) * f;
+	*cd = g_aero.cd_v[i] + (g_aero.cd_v[i+1]-g_aero.cd_v[i]) * f + g_aero.kv * *cl * *cl + WaveDrag (M);
+}
+
+void HLiftCoeff (VESSEL *v, double beta, double M, double Re, void *context, double *cl, double *cm, double *cd)
+{
+	double f;
+	int i = AngleIndex (beta, f);
+	*cl = g_aero.cl_h[i] + (g_aero.cl_h[i+1]-g_aero.cl_h[i]) * f;
+	*cm = 0.0;
+	*cd = g_aero.cd_h[i] + (g_aero.cd_h[i+1]-g_aero.cd_h[i]) * f + g_aero.kh * *cl * *cl + WaveDrag (M);
+}
+
+// 4. database versions
+// Used when the class cfg names an aerodynamic database
+// (AERO_DATABASE). The airfoil context is the AeroDB instance; the
+// angle not passed to the callback is taken from the vessel.
+
+void VLiftCoeff_db (VESSEL *v, double aoa, double M, double Re, void *context, double *cl, double *cm, double *cd)
+{
+	((AeroDB*)context)->VLift (M, aoa, v->GetSlipAngle(), cl, cm, cd);
+}
+
+void HLiftCoeff_db (VESSEL *v, double beta, double M, double Re, void *context, double *cl, double *cm, double *cd)
+{
+	((AeroDB*)context)->HLift (M, v->GetAOA(), beta, cl, cm, cd);
+}
+
 // ==============================================================
 // Specialised vessel class Scout
 // ==============================================================
 
+// ==============================================================
+// HUD annunciators (see HUDOverlay)
+// To add an annunciator, define its geometry and state function
+// and append it to hudelem.
+// ==============================================================
+
+// landing gear: steady when down, blinking while in transit
+static const float hud_xgear[12] = {-4,-2,-4,-2,2,4,2,4,-1,1,-1,1};
+static const float hud_ygear[12] = {-2,-2,-4,-4,-2,-2,-4,-4,-6,-6,-8,-8};
+static const float hud_ugear[12] = {405,423,405,423,405,423,405,423,405,423,405,423};
+static const float hud_vgear[12] = {104,104,86,86,104,104,86,86,104,104,86,86};
+static const WORD hud_igear[18] = {
+	0,3,1, 3,0,2,
+	4,7,5, 7,4,6,
+	8,11,9, 11,8,10
+};
+static int HUDState_Gear (VESSEL *v)
+{
+	Scout::DoorStatus s = ((Scout*)v)->gear_status;
+	return (s == Scout::DOOR_OPEN ? HUDELEM_ON : s == Scout::DOOR_CLOSED ? HUDELEM_OFF : HUDELEM_BLINK);
+}
+
+// nose cone (docking HUD only): steady when closed, blinking while in transit
+static const float hud_xnose[16] = {0,1,0,-1,-31,-30,30,31,31,30,-30,-31,  -13,13,-13,13};
+static const float hud_ynose[16] = {-1,0,1,0,-30,-31,-31,-30,30,31,31,30,  -25,-25,-28.9f,-28.9f};
+static const float hud_unose[16] = {392.5f, 397.0f, 392.5f, 388.0f, 388.0f, 392.5f, 392.5f, 397.0f, 397.0f, 392.5f, 392.5f, 388.0f,    124.0f, 204.0f, 124.0f, 204.0f};
+static const float hud_vnose[16] = {92.0f, 96.5f, 101.0f, 96.5f, 96.5f, 92.0f, 92.0f, 96.5f, 96.5f, 101.0f, 101.0f, 96.5f,             118.0f, 118.0f, 106.0f, 106.0f};
+static const WORD hud_inose[36] = {
+	0,1,2, 2,3,0,
+	0,6,1, 6,7,1,
+	1,8,2, 8,9,2,
+	2,10,3, 10,11,3,
+	3,4,0, 0,4,5,
+	12,15,13, 12,14,15
+};
+static int HUDState_Nose (VESSEL *v)
+{
+	Scout::DoorStatus s = ((Scout*)v)->nose_status;
+	if (oapiGetHUDMode() != HUD_DOCKING || s == Scout::DOOR_OPEN) return HUDELEM_OFF;
+	return (s == Scout::DOOR_CLOSED ? HUDELEM_ON : HUDELEM_BLINK);
+}
+
+// airbrake: steady when deployed, blinking while in transit
+static const float hud_xbrk[4] = {-9.1f, 9.1f, -9.1f, 9.1f};
+static const float hud_ybrk[4] = {-30.0f, -30.0f, -33.9f, -33.9f};
+static const float hud_ubrk[4] = {205.0f, 261.0f, 205.0f, 261.0f};
+static const float hud_vbrk[4] = {118.0f, 118.0f, 106.0f, 106.0f};
+static const WORD hud_ibrk[6] = {
+	0,3,1, 0,2,3
+};
+static int HUDState_Brake (VESSEL *v)
+{
+	Scout::DoorStatus s = ((Scout*)v)->brake_status;
+	return (s == Scout::DOOR_OPEN ? HUDELEM_ON : s == Scout::DOOR_CLOSED ? HUDELEM_OFF : HUDELEM_BLINK);
+}
+
+static const HUDELEMENTSPEC hudelem[] = {
+	{12, 18, hud_xgear, hud_ygear, 1.0f, hud_ugear, hud_vgear, hud_igear, HUDState_Gear, 1.0},
+	{16, 36, hud_xnose, hud_ynose, 0.4f, hud_unose, hud_vnose, hud_inose, HUDState_Nose, 1.0},
+	{ 4,  6, hud_xbrk,  hud_ybrk,  0.4f, hud_ubrk,  hud_vbrk,  hud_ibrk,  HUDState_Brake, 1.0}
+};
+static const int NHUDELEM = sizeof(hudelem)/sizeof(HUDELEMENTSPEC);
+
 // --------------------------------------------------------------
 // Constructor
 // --------------------------------------------------------------
 Scout::Scout (OBJHANDLE hObj, int fmodel)
-: VESSEL3 (hObj, fmodel)
+: VESSEL3 (hObj, fmodel),
+  nose_status (act_status[ACT_NOSE]), ladder_status (act_status[ACT_LADDER]), gear_status (act_status[ACT_GEAR]),
+  rcover_status (act_status[ACT_RCOVER]), olock_status (act_status[ACT_OLOCK]), ilock_status (act_status[ACT_ILOCK]),
+  hatch_status (act_status[ACT_HATCH]), radiator_status (act_status[ACT_RADIATOR]), brake_status (act_status[ACT_BRAKE]),
+  nose_proc (act_proc[ACT_NOSE]), ladder_proc (act_proc[ACT_LADDER]), gear_proc (act_proc[ACT_GEAR]),
+  rcover_proc (act_proc[ACT_RCOVER]), olock_proc (act_proc[ACT_OLOCK]), ilock_proc (act_proc[ACT_ILOCK]),
+  hatch_proc (act_proc[ACT_HATCH]), radiator_proc (act_proc[ACT_RADIATOR]), brake_proc (act_proc[ACT_BRAKE]),
+  actq (NACTUATOR)
 {
 	int i, j;
 
@@ -120,29 +293,23 @@ Scout::Scout (OBJHANDLE hObj, int fmodel)
 	aoa_ind = PI;
 	slip_ind = PI*0.5;
 	load_ind = PI;
-	gear_status       = DOOR_CLOSED;
-	gear_proc         = 0.0;
-	rcover_status     = DOOR_CLOSED;
-	rcover_proc       = 0.0;
-	nose_status       = DOOR_CLOSED;
-	nose_proc         = 0.0;
-	ladder_status     = DOOR_CLOSED;
-	ladder_proc       = 0.0;
-	olock_status      = DOOR_CLOSED;
-	olock_proc        = 0.0;
-	ilock_status      = DOOR_CLOSED;
-	ilock_proc        = 0.0;
-	hatch_status      = DOOR_CLOSED;
-	hatch_proc        = 0.0;
-	brake_status      = DOOR_CLOSED;
-	brake_proc        = 0.0;
-	radiator_status   = DOOR_CLOSED;
-	radiator_proc     = 0.0;
+	for (i = 0; i < NACTUATOR; i++) {
+		act_status[i] = DOOR_CLOSED;
+		act_proc[i]   = 0.0;
+		act_anim[i]   = ACT_NOANIM;
+		act_t0[i] = act_p0[i] = 0.0;
+	}
+	nact_active       = 0;
+	act_blink         = -1;
 	visual            = NULL;
 	exmesh            = NULL;
 	vcmesh            = NULL;
 	vcmesh_tpl        = NULL;
 	scramjet          = NULL;
+	thscale           = NULL;
+	cls               = NULL;
+	fleetidx          = -1;
+	memset (&fs, 0, sizeof(fs));
 	hatch_vent        = NULL;
 	insignia_tex      = NULL;
 	contrail_tex      = NULL;
@@ -151,6 +318,12 @@ Scout::Scout (OBJHANDLE hObj, int fmodel)
 	th_main_level     = 0.0;
 
 	skinpath[0] = '\0';
+	skinid = -1;
+	skinwait = false;
+	scndirty = SCNF_ALL;
+	for (i = 0; i < NACTUATOR; i++)
+		scn_door[i][0] = '\0';
+	scn_psngr[0] = scn_lights[0] = scn_aap[0] = '\0';
 	for (i = 0; i < 3; i++)
 		skin[i] = 0;
 	for (i = 0; i < 4; i++)
@@ -159,6 +332,7 @@ Scout::Scout (OBJHANDLE hObj, int fmodel)
 		scram_max[i] = 0.0;
 		scram_intensity[i] = 0.0;
 	}
+	scram_memo.valid = false;
 	for (i = 0; i < 2; i++) {
 		scgimbalidx[i] = mpgimbalidx[i] = mygimbalidx[i] = 35;
 		scflowidx[i] = 0;
@@ -176,6 +350,8 @@ Scout::Scout (OBJHANDLE hObj, int fmodel)
 	hbalanceidx = 28;
 	
 	ninstr = 0;
+	aap = NULL;
+	ckring = NULL;
 
 	// damage parameters
 	bDamageEnabled = (GetDamageModel() != 0);
@@ -185,6 +361,11 @@ Scout::Scout (OBJHANDLE hObj, int fmodel)
 	for (i = 0; i < 4; i++) aileronfail[i] = false;
 
 	DefineAnimations();
+	act_anim[ACT_GEAR] = anim_gear01;
+
+	hudovl = new HUDOverlay (this, 512.0f, 256.0f);
+	for (i = 0; i < NHUDELEM; i++)
+		hudovl->AddElement (hudelem+i);
 	for (i = 0; i < nsurf; i++) srf[i] = 0;
 }
 
@@ -196,20 +377,25 @@ Scout::~Scout ()
 	DWORD i;
 
 	if (scramjet) delete scramjet;
+	if (thscale) delete thscale;
+	if (cls) ScoutClass::Release (cls);
 
 	for (i = 0; i < ninstr; i++)
 		delete instr[i];
 	delete []instr;
 
 	delete aap;
+	delete ckring;
+	Sequencer::Detach (this);
+	Fleet::Detach (this);
 
-	if (insignia_tex) oapiDestroySurface(insignia_tex);
+	if (insignia_tex) Insignia::Release (insignia_tex);
 
 	if (contrail_tex) ReleaseSurfaces();
 	if (hPanelMesh) oapiDeleteMesh (hPanelMesh);
+	delete hudovl;
 
-	for (i = 0; i < 3; i++)
-		if (skin[i]) oapiReleaseTexture (skin[i]);
+	if (skinid >= 0) SkinManager::Release (skinid);
 
 	delete RGear02T01;
 	delete RGear01R01;
@@ -225,6 +411,60 @@ Scout::~Scout ()
 	delete CNull02R01;
 }
 
+// --------------------------------------------------------------
+// Sample the vessel state for the current time step
+// --------------------------------------------------------------
+void Scout::UpdateFrameState (double simt)
+{
+	fs.simt = simt;
+	fs.mass = GetMass();
+	GetWeightVector (fs.weight);
+	fs.rho  = GetAtmDensity();
+	fs.lift = GetLift();
+	fs.dynp = GetDynPressure();
+	if (scramjet) {
+		OBJHANDLE hAtm = GetAtmRef();
+		if (hAtm != fs.hAtm || (hAtm && !fs.atm)) {
+			fs.hAtm = hAtm;
+			fs.atm = (hAtm ? oapiGetPlanetAtmConstants (hAtm) : NULL);
+		}
+		fs.mach = GetMachNumber();
+		fs.p0   = GetAtmPressure();
+		fs.T0   = GetAtmTemperature();
+	}
+	fs.rotvalid = 0;
+}
+
+const VECTOR3 &Scout::FrameAngularVel ()
+{
+	if (!(fs.rotvalid & FS_ROTVEL)) {
+		GetAngularVel (fs.vrot);
+		fs.rotvalid |= FS_ROTVEL;
+		PROFILE_COUNT (FRAMESTATE_QUERY);
+	}
+	return fs.vrot;
+}
+
+const VECTOR3 &Scout::FrameAngularAcc ()
+{
+	if (!(fs.rotvalid & FS_ROTACC)) {
+		GetAngularAcc (fs.arot);
+		fs.rotvalid |= FS_ROTACC;
+		PROFILE_COUNT (FRAMESTATE_QUERY);
+	}
+	return fs.arot;
+}
+
+const VECTOR3 &Scout::FrameAngularMoment ()
+{
+	if (!(fs.rotvalid & FS_ROTMOM)) {
+		GetAngularMoment (fs.amom);
+		fs.rotvalid |= FS_ROTMOM;
+		PROFILE_COUNT (FRAMESTATE_QUERY);
+	}
+	return fs.amom;
+}
+
 // --------------------------------------------------------------
 // Overloaded clbkPreStep
 //---------------------------------------------------------------
@@ -232,42 +472,35 @@ void Scout::clbkPreStep (double simt, double simdt, double mjd)
 {
 VECTOR3 gforce, unit_grav, vector_empuxo;
 	
-	GetWeightVector(gforce);
+	PROFILE_BEGIN (PRESTEP);
+	UpdateFrameState (simt);
+	gforce = fs.weight;
 	double gravity = sqrt(pow(gforce.x,2)+pow(gforce.y,2)+pow(gforce.z,2));
-	//double f=gravity*GetMass()*9.8;
-	double g=gravity/GetMass();
-	double bouyancy = GetAtmDensity () * 1400 * g;
+	//double f=gravity*fs.mass*9.8;
+	double g=gravity/fs.mass;
+	double bouyancy = fs.rho * 1400 * g;
 	unit_grav=gforce/gravity; //unit vector
 	double level = GetThrusterLevel (th_hover[0]);
 	vector_empuxo=(gforce*-1*level*.99); // thrust being always opposite to gforce
 	AddForce(vector_empuxo + _V(0, bouyancy, 0),_V(0,0,0));
 
-	SetThrusterMax0 (th_main [0], GetMass() * 9.8);
-	SetThrusterMax0 (th_main [1], GetMass() * 9.8);
-	double RCS_MOD = .01;
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_PITCHUP, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_PITCHUP, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_PITCHDOWN, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_PITCHDOWN, 1), GetMass() * 9.8 * RCS_MOD / 2);
-    SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_UP, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_UP, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_DOWN, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_DOWN, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_YAWLEFT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_YAWLEFT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_YAWRIGHT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_YAWRIGHT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_LEFT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_LEFT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_RIGHT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_RIGHT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_BANKLEFT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_BANKLEFT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_BANKRIGHT, 0), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_BANKRIGHT, 1), GetMass() * 9.8 * RCS_MOD / 2);
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_FORWARD, 0), GetMass() * 9.8 * RCS_MOD );
-	SetThrusterMax0 (GetGroupThruster(THGROUP_ATT_BACK, 0), GetMass() * 9.8 * RCS_MOD );
+	// mass-proportional thrust limits of main and RCS engines
+	if (thscale) thscale->Update (fs.mass);
 
+	// native autopilot control loops (no-op for the script autopilot)
+	aap->Step (simdt);
+
+	// custom skin, once its files are in the cache
+	if (skinwait && SkinManager::Resolve (skinid, skin)) {
+		skinwait = false;
+		if (insignia_tex && skin[2]) { // repaint on the skin's panel
+			Insignia::Release (insignia_tex);
+			insignia_tex = NULL;
+		}
+		ApplySkin ();
+	}
+
+	PROFILE_END (PRESTEP);
 }
 
 // --------------------------------------------------------------
@@ -336,7 +569,7 @@ void Scout::CreatePanelElements ()
 			instr[31+i*3+j] = new MFDButtonCol (this, i, j);
 	}
 
-	aap = new AAP (this);   aap->AttachHSI ((InstrHSI*)instr[1]);
+	aap = new AAP (this, cls->aapnative);   aap->AttachHSI ((InstrHSI*)instr[1]);
 
 	if (ScramVersion()) {
 		instr[instr_scram0+0] = new ThrottleScram (this);
@@ -851,9 +1084,21 @@ void Scout::DefineAnimations ()
 void Scout::ApplySkin ()
 {
 	if (!exmesh) return;
+
+	// vessel-specific insignia, shared with vessels that look the same
+	if (!insignia_tex) {
+		bool paint;
+		SURFHANDLE base = (skin[2] ? skin[2] : oapiGetTextureHandle (exmesh_tpl, 5));
+		insignia_tex = Insignia::Acquire (base, GetName(), paint);
+		if (paint) {
+			if (base) oapiBlt (insignia_tex, base, 0, 0, 0, 0, 256, 256);
+			PaintMarkings (insignia_tex);
+		}
+	}
+
 	if (skin[0]) oapiSetTexture (exmesh, 2, skin[0]);
 	if (skin[1]) oapiSetTexture (exmesh, 3, skin[1]);
-	oapiSetTexture (exmesh, 5, insignia_tex);
+	if (insignia_tex) oapiSetTexture (exmesh, 5, insignia_tex);
 }
 
 // --------------------------------------------------------------
@@ -981,23 +1226,70 @@ void Scout::InitVC (int vc)
 }
 
 void Scout::ScramjetThrust ()
+{
+	double level[2], Fmax[2], isp[2];
+	for (int i = 0; i < 2; i++)
+		level[i] = GetThrusterLevel (th_scram[i]);
+	if (ScramjetSolve (level, Fmax, isp)) {
+		PROFILE_COUNT (SCRAMMEMO_MISS);
+		ScramjetApply (Fmax, isp);
+	} else {
+		PROFILE_COUNT (SCRAMMEMO_HIT);
+	}
+}
+
+// Scramjet thrust limits and Isp for the given throttle levels and
+// the frame state. Doesn't call the Orbiter API, so the fleet batch
+// can run it on a worker thread.
+bool Scout::ScramjetSolve (const double *level, double *Fmax, double *isp)
 {
 	int i;
 	const double eps = 1e-8;
 	const double Fnominal = 2.5*MAX_MAIN_THRUST[modelidx];
 
 	double Fscram[2];
-	scramjet->Thrust (Fscram);
+
+	// Reuse the previous solution (thrust limits, Isp and exhaust
+	// intensity are already set) while the flight state stays within
+	// the tolerances of the last full calculation
+	OBJHANDLE hAtm = fs.hAtm;
+	double M  = fs.mach;
+	double p0 = fs.p0;
+	double T0 = fs.T0;
+	const double *tol = cls->memo_tol;
+	if (scram_memo.valid && hAtm == scram_memo.hAtm &&
+		fabs (M-scram_memo.M) <= tol[0] &&
+		fabs (p0-scram_memo.p0) <= tol[1]*scram_memo.p0 &&
+		fabs (T0-scram_memo.T0) <= tol[2]*scram_memo.T0 &&
+		fabs (level[0]-scram_memo.lvl[0]) <= tol[3] &&
+		fabs (level[1]-scram_memo.lvl[1]) <= tol[3])
+		return false;
+	scram_memo.valid = true;
+	scram_memo.hAtm = hAtm;
+	scram_memo.M = M;
+	scram_memo.p0 = p0;
+	scram_memo.T0 = T0;
+	scram_memo.lvl[0] = level[0];
+	scram_memo.lvl[1] = level[1];
+
+	scramjet->Thrust (Fscram, fs.atm, level, M, T0, p0);
 
 	for (i = 0; i < 2; i++) {
-		double level = GetThrusterLevel (th_scram[i]);
-		double Fmax  = Fscram[i]/(level+eps);
-		SetThrusterMax0 (th_scram[i], Fmax);
-		SetThrusterIsp (th_scram[i], max (1.0, Fscram[i]/(scramjet->DMF(i)+eps))); // don't allow ISP=0
+		Fmax[i] = Fscram[i]/(level[i]+eps);
+		isp[i]  = max (1.0, Fscram[i]/(scramjet->DMF(i)+eps)); // don't allow ISP=0
 
 		// the following are used for calculating exhaust density
-		scram_max[i] = min (Fmax/Fnominal, 1.0);
-		scram_intensity[i] = level * scram_max[i];
+		scram_max[i] = min (Fmax[i]/Fnominal, 1.0);
+		scram_intensity[i] = level[i] * scram_max[i];
+	}
+	return true;
+}
+
+void Scout::ScramjetApply (const double *Fmax, const double *isp)
+{
+	for (int i = 0; i < 2; i++) {
+		SetThrusterMax0 (th_scram[i], Fmax[i]);
+		SetThrusterIsp (th_scram[i], isp[i]);
 	}
 }
 
@@ -1047,105 +1339,13 @@ bool Scout::clbkDrawHUD (int mode, const HUDPAINTSPEC *hps, oapi::Sketchpad *skp
 
 void Scout::clbkRenderHUD (int mode, const HUDPAINTSPEC *hps, SURFHANDLE hTex)
 {
+	PROFILE_BEGIN (RENDERHUD);
 	VESSEL3::clbkRenderHUD (mode, hps, hTex);
 
-	static float texw = 512.0f, texh = 256.0f;
-	float cx = (float)hps->CX, cy = (float)hps->CY;
-	int i, nvtx = 0, nidx = 0;
-	static NTVERTEX vtx[12+16+4];
-	static WORD idx[18+36+6];
-	static float scl = 0;
-	static NTVERTEX vgear[12];
-	static NTVERTEX vnose[16];
-	static NTVERTEX vbrk[4];
-	static WORD igear[18] = {
-		0,3,1, 3,0,2,
-		4,7,5, 7,4,6,
-		8,11,9, 11,8,10
-	};
-	static WORD inose[36] = {
-		0,1,2, 2,3,0,
-		0,6,1, 6,7,1,
-		1,8,2, 8,9,2,
-		2,10,3, 10,11,3,
-		3,4,0, 0,4,5,
-		12,15,13, 12,14,15
-	};
-	static WORD ibrk[6] = {
-		0,3,1, 0,2,3
-	};
-
-	if (scl != hps->Markersize*0.25f) { // resize
-		scl = hps->Markersize*0.25f;
-		memset (vgear, 0, 12*sizeof(NTVERTEX));
-		float x[12] = {-4,-2,-4,-2,2,4,2,4,-1,1,-1,1};
-		float y[12] = {-2,-2,-4,-4,-2,-2,-4,-4,-6,-6,-8,-8};
-		for (i = 0; i < 12; i++) {
-			vgear[i].x = cx + x[i]*scl;
-			vgear[i].y = cy + y[i]*scl;
-			vgear[i].tu = (405.0f + (18.0f * (i%2)))/texw;
-			vgear[i].tv = (104.0f - (18.0f * ((i%4)/2)))/texh;
-		}
-		memset (vnose, 0, 16*sizeof(NTVERTEX));
-		float xn[16] = {0,1,0,-1,-31,-30,30,31,31,30,-30,-31,  -13,13,-13,13};
-		float yn[16] = {-1,0,1,0,-30,-31,-31,-30,30,31,31,30,  -25,-25,-28.9,-28.9};
-		float un[16] = {392.5f, 397.0f, 392.5f, 388.0f, 388.0f, 392.5f, 392.5f, 397.0f, 397.0f, 392.5f, 392.5f, 388.0f,    124.0f, 204.0f, 124.0f, 204.0f};
-		float vn[16] = {92.0f, 96.5f, 101.0f, 96.5f, 96.5f, 92.0f, 92.0f, 96.5f, 96.5f, 101.0f, 101.0f, 96.5f,             118.0f, 118.0f, 106.0f, 106.0f};
-		for (i = 0; i < 16; i++) {
-			vnose[i].x = cx + xn[i]*scl*0.4f;
-			vnose[i].y = cy + yn[i]*scl*0.4f;
-			vnose[i].tu = un[i]/texw;
-			vnose[i].tv = vn[i]/texh;
-		}
-		memset (vbrk, 0, 4*sizeof(NTVERTEX));
-		float xb[4] = {-9.1f, 9.1f, -9.1f, 9.1f};
-		float yb[4] = {-30.0f, -30.0f, -33.9f, -33.9f};
-		float ub[4] = {205.0f, 261.0f, 205.0f, 261.0f};
-		float vb[4] = {118.0f, 118.0f, 106.0f, 106.0f};
-		for (i = 0; i < 4; i++) {
-			vbrk[i].x = cx + xb[i]*scl*0.4f;
-			vbrk[i].y = cy + yb[i]*scl*0.4f;
-			vbrk[i].tu = ub[i]/texw;
-			vbrk[i].tv = vb[i]/texh;
-		}
-	}
-
-	// show gear deployment status
-	if (gear_status == DOOR_OPEN || (gear_status >= DOOR_CLOSING && fmod (oapiGetSimTime(), 1.0) < 0.5)) {
-		memcpy (vtx+nvtx, vgear, 12*sizeof(NTVERTEX));
-		for (i = 0; i < 18; i++) idx[nidx+i] = igear[i]+nvtx;
-		nvtx += 12;
-		nidx += 18;
-	}
-
-	// show nosecone status
-	if (oapiGetHUDMode() == HUD_DOCKING && nose_status != DOOR_OPEN) {
-		double tmp;
-		if (nose_status == DOOR_CLOSED || modf (oapiGetSimTime(), &tmp) < 0.5) {
-			memcpy (vtx+nvtx, vnose, 16*sizeof(NTVERTEX));
-			for (i = 0; i < 36; i++) idx[nidx+i] = inose[i]+nvtx;
-			nvtx += 16;
-			nidx += 36;
-		}
-	}
-
-	// show airbrake status
-	if (brake_status != DOOR_CLOSED) {
-		double tmp;
-		if (brake_status == DOOR_OPEN || modf (oapiGetSimTime(), &tmp) < 0.5) {
-			memcpy (vtx+nvtx, vbrk, 4*sizeof(NTVERTEX));
-			for (i = 0; i < 6; i++) idx[nidx+i] = ibrk[i]+nvtx;
-			nvtx += 4;
-			nidx += 6;
-		}
-	}
-
-	if (nvtx) {
-		MESHGROUP grp = {vtx, idx, nvtx, nidx, 0, 0, 0, 0, 0};
-		MESHHANDLE hmesh = oapiCreateMesh (1, &grp);
-		oapiRenderHUD (hmesh, &hTex);
-		oapiDeleteMesh (hmesh);
+	if (hudovl->Render (hps, hTex, oapiGetSimTime())) {
+		PROFILE_COUNT (HUDOVERLAY_DRAW);
 	}
+	PROFILE_END (RENDERHUD);
 }
 
 void Scout::ActivateLandingGear (DoorStatus action)
@@ -1154,7 +1354,7 @@ void Scout::ActivateLandingGear (DoorStatus action)
 	// we cannot deploy the landing gear if we are already sitting on the ground
 
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	gear_status = action;
+	SetActuator (ACT_GEAR, action);
 	if (action <= DOOR_OPEN) {
 		gear_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		SetAnimation (anim_gear01, gear_proc);
@@ -1191,7 +1391,7 @@ void Scout::SetGearParameters (double state)
 void Scout::ActivateRCover (DoorStatus action)
 {
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	rcover_status = action;
+	SetActuator (ACT_RCOVER, action);
 	if (action <= DOOR_OPEN) {
 		rcover_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		SetAnimation (anim_rcover, rcover_proc);
@@ -1207,7 +1407,7 @@ void Scout::ActivateRCover (DoorStatus action)
 void Scout::ActivateDockingPort (DoorStatus action)
 {
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	nose_status = action;
+	SetActuator (ACT_NOSE, action);
 	if (action <= DOOR_OPEN) {
 		nose_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_nose, nose_proc);
@@ -1246,7 +1446,7 @@ void Scout::ActivateHatch (DoorStatus action)
 		hatch_vent_t = oapiGetSimTime();
 	}
 
-	hatch_status = action;
+	SetActuator (ACT_HATCH, action);
 	if (action <= DOOR_OPEN) {
 		hatch_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_hatch, hatch_proc);
@@ -1270,7 +1470,7 @@ void Scout::ActivateLadder (DoorStatus action)
 	if (!close && nose_status != DOOR_OPEN) return;
 	// don't extend ladder if nose cone is closed
 
-	ladder_status = action;
+	SetActuator (ACT_LADDER, action);
 	if (action <= DOOR_OPEN) {
 		ladder_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_ladder, ladder_proc);
@@ -1290,7 +1490,7 @@ void Scout::RevertLadder ()
 void Scout::ActivateOuterAirlock (DoorStatus action)
 {
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	olock_status = action;
+	SetActuator (ACT_OLOCK, action);
 	if (action <= DOOR_OPEN) {
 		olock_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_olock, olock_proc);
@@ -1311,7 +1511,7 @@ void Scout::RevertOuterAirlock ()
 void Scout::ActivateInnerAirlock (DoorStatus action)
 {
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	ilock_status = action;
+	SetActuator (ACT_ILOCK, action);
 	if (action <= DOOR_OPEN) {
 		ilock_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_ilock, ilock_proc);
@@ -1331,7 +1531,7 @@ void Scout::RevertInnerAirlock ()
 
 void Scout::ActivateAirbrake (DoorStatus action)
 {
-	brake_status = action;
+	SetActuator (ACT_BRAKE, action);
 	oapiTriggerPanelRedrawArea (0, AID_AIRBRAKE);
 	RecordEvent ("AIRBRAKE", action == DOOR_CLOSING ? "CLOSE" : "OPEN");
 }
@@ -1345,7 +1545,7 @@ void Scout::RevertAirbrake (void)
 void Scout::ActivateRadiator (DoorStatus action)
 {
 	bool close = (action == DOOR_CLOSED || action == DOOR_CLOSING);
-	radiator_status = action;
+	SetActuator (ACT_RADIATOR, action);
 	if (action <= DOOR_OPEN) {
 		radiator_proc = (action == DOOR_CLOSED ? 0.0 : 1.0);
 		//SetAnimation (anim_radiator, radiator_proc);
@@ -1363,9 +1563,134 @@ void Scout::RevertRadiator (void)
 		DOOR_OPENING : DOOR_CLOSING);
 }
 
+// ==============================================================
+// Actuators (landing gear, doors, radiator and airbrake)
+// The completion time of each motion is known when it starts and
+// is put in an event queue, so the time step only does work for
+// actuators that finish in this step, and for the few whose
+// position is needed continuously (drag elements, animations,
+// panel indicators). All other positions are evaluated on demand.
+// ==============================================================
+
+const Scout::ActuatorDef Scout::actdef[NACTUATOR] = {
+	// speed                     track  redraw area            statusind  moved              done
+	{GEAR_OPERATING_SPEED,       true,  AID_GEARINDICATOR,     true,      &Scout::GearMoved, NULL},              // ACT_GEAR
+	{RCOVER_OPERATING_SPEED,     true,  0,                     true,      NULL,              &Scout::RCoverDone}, // ACT_RCOVER
+	{NOSE_OPERATING_SPEED,       true,  AID_NOSECONEINDICATOR, true,      NULL,              NULL},              // ACT_NOSE
+	{LADDER_OPERATING_SPEED,     false, 0,                     false,     NULL,              NULL},              // ACT_LADDER
+	{HATCH_OPERATING_SPEED,      false, 0,                     true,      NULL,              NULL},              // ACT_HATCH
+	{AIRLOCK_OPERATING_SPEED,    false, 0,                     true,      NULL,              NULL},              // ACT_OLOCK
+	{AIRLOCK_OPERATING_SPEED,    false, 0,                     true,      NULL,              NULL},              // ACT_ILOCK
+	{RADIATOR_OPERATING_SPEED,   true,  0,                     true,      NULL,              NULL},              // ACT_RADIATOR
+	{AIRBRAKE_OPERATING_SPEED,   true,  0,                     true,      NULL,              NULL}               // ACT_BRAKE
+};
+
+void Scout::SetActuator (Actuator a, DoorStatus status)
+{
+	DWORD k;
+	double t = oapiGetSimTime();
+	ActuatorProc (a, t); // position reached by the previous motion
+
+	act_status[a] = status;
+	scndirty |= 1 << a;
+	for (k = 0; k < nact_active; k++)
+		if (act_active[k] == a) {
+			act_active[k] = act_active[--nact_active];
+			break;
+		}
+	if (status < DOOR_CLOSING) {
+		actq.Cancel (a);
+		return;
+	}
+	double dp = (status == DOOR_OPENING ? 1.0-act_proc[a] : act_proc[a]);
+	act_t0[a] = t;
+	act_p0[a] = act_proc[a];
+	actq.Schedule (a, t + max (0.0, dp)/actdef[a].speed);
+	if (actdef[a].track)
+		act_active[nact_active++] = (BYTE)a;
+}
+
+double Scout::ActuatorProc (Actuator a, double simt)
+{
+	if (actq.Pending (a)) {
+		double dp = actdef[a].speed * max (0.0, simt-act_t0[a]);
+		act_proc[a] = (act_status[a] == DOOR_OPENING ? min (1.0, act_p0[a]+dp) : max (0.0, act_p0[a]-dp));
+	}
+	return act_proc[a];
+}
+
+void Scout::StepActuators (double simt)
+{
+	int redraw[NACTUATOR];
+	DWORD k, j, id, nredraw = 0;
+	bool statusind = false;
+
+	// completion events due in this step
+	while (actq.Next (simt, id)) {
+		Actuator a = (Actuator)id;
+		const ActuatorDef &def = actdef[a];
+		DoorStatus status = act_status[a] = (act_status[a] == DOOR_OPENING ? DOOR_OPEN : DOOR_CLOSED);
+		scndirty |= 1 << a;
+		act_proc[a] = (status == DOOR_OPEN ? 1.0 : 0.0);
+		for (k = 0; k < nact_active; k++)
+			if (act_active[k] == a) {
+				act_active[k] = act_active[--nact_active];
+				break;
+			}
+		if (act_anim[a] != ACT_NOANIM) SetAnimation (act_anim[a], act_proc[a]);
+		if (def.moved) (this->*def.moved)();
+		if (def.redraw) {
+			for (j = 0; j < nredraw; j++)
+				if (redraw[j] == def.redraw) break;
+			if (j == nredraw) redraw[nredraw++] = def.redraw;
+		}
+		if (def.statusind) statusind = true;
+		if (def.done) (this->*def.done)(status);
+		Sequencer::DoorDone (this, a, status);
+	}
+
+	// actuators whose position is needed continuously
+	for (k = 0; k < nact_active; k++) {
+		Actuator a = (Actuator)act_active[k];
+		const ActuatorDef &def = actdef[a];
+		ActuatorProc (a, simt);
+		if (act_anim[a] != ACT_NOANIM) SetAnimation (act_anim[a], act_proc[a]);
+		if (def.moved) (this->*def.moved)();
+		if (def.redraw) {
+			for (j = 0; j < nredraw; j++)
+				if (redraw[j] == def.redraw) break;
+			if (j == nredraw) redraw[nredraw++] = def.redraw;
+		}
+	}
+
+	// the status indicators of moving actuators blink at 1 Hz, so
+	// they only need an update when the blink phase changes
+	int blink = (int)floor (simt*2.0);
+	if (blink != act_blink && actq.nPending()) {
+		act_blink = blink;
+		statusind = true;
+	}
+
+	// one notification per frame, however many actuators moved
+	for (j = 0; j < nredraw; j++)
+		oapiTriggerRedrawArea (0, 0, redraw[j]);
+	if (statusind) UpdateStatusIndicators();
+}
+
+void Scout::GearMoved ()
+{
+	SetGearParameters (gear_proc);
+}
+
+void Scout::RCoverDone (DoorStatus status)
+{
+	if (status == DOOR_OPEN) EnableRetroThrusters (true);
+}
+
 void Scout::SetNavlight (bool on)
 {
 	beacon[0].active = beacon[1].active = beacon[2].active = on;
+	scndirty |= SCNF_LIGHTS;
 	oapiTriggerPanelRedrawArea (0, AID_SWITCHARRAY);
 	UpdateCtrlDialog (this);
 }
@@ -1373,6 +1698,7 @@ void Scout::SetNavlight (bool on)
 void Scout::SetBeacon (bool on)
 {
 	beacon[3].active = beacon[4].active = on;
+	scndirty |= SCNF_LIGHTS;
 	oapiTriggerPanelRedrawArea (0, AID_SWITCHARRAY);
 	UpdateCtrlDialog (this);
 }
@@ -1380,6 +1706,7 @@ void Scout::SetBeacon (bool on)
 void Scout::SetStrobe (bool on)
 {
 	beacon[5].active = beacon[6].active = on;
+	scndirty |= SCNF_LIGHTS;
 	oapiTriggerPanelRedrawArea (0, AID_SWITCHARRAY);
 	UpdateCtrlDialog (this);
 }
@@ -1387,6 +1714,7 @@ void Scout::SetStrobe (bool on)
 void Scout::SetDockingLight (bool on)
 {
 	beacon[7].active = on;
+	scndirty |= SCNF_LIGHTS;
 	docking_light->Activate (on);
 	oapiTriggerPanelRedrawArea (0, AID_SWITCHARRAY);
 	UpdateCtrlDialog (this);
@@ -1683,19 +2011,42 @@ bool Scout::GetBeaconState (int which)
 
 void Scout::TestDamage ()
 {
-	bool newdamage = false;
-	double dt = oapiGetSimStep();
+	double alpha, pwing, phatch;
+	DamageHazard (oapiGetSimStep(), alpha, pwing, phatch);
+	DamageApply (alpha, pwing, phatch);
+}
 
+// Failure rate and failure probabilities in this time step. Doesn't
+// call the Orbiter API, so the fleet batch can run it on a worker
+// thread.
+void Scout::DamageHazard (double dt, double &alpha, double &pwing, double &phatch)
+{
 	// airframe damage as a result of wingload stress
 	// or excessive dynamic pressure
 
-	double load = GetLift() / 190.0; // L/S
-	double dynp = GetDynPressure();  // dynamic pressure
+	double load = fs.lift / 190.0; // L/S
+	double dynp = fs.dynp;         // dynamic pressure
 	if (load > WINGLOAD_MAX || load < WINGLOAD_MIN || dynp > DYNP_MAX) {
-		double alpha = max ((dynp-DYNP_MAX) * 1e-5,
+		alpha = max ((dynp-DYNP_MAX) * 1e-5,
 			(load > 0 ? load-WINGLOAD_MAX : WINGLOAD_MIN-load) * 5e-5);
-		double p = 1.0 - exp (-alpha*dt); // probability of failure
-		if (oapiRand() < p) {
+		pwing = 1.0 - exp (-alpha*dt); // probability of failure
+	} else
+		alpha = pwing = 0.0;
+
+	// top hatch damage
+	if (ActuatorProc (ACT_HATCH, fs.simt) > 0.05 && hatchfail < 2 && dynp > 30e3)
+		phatch = 1.0 - exp(-dt*0.2);
+	else
+		phatch = 0.0;
+}
+
+// Draw the failures for the probabilities from DamageHazard
+void Scout::DamageApply (double alpha, double pwing, double phatch)
+{
+	bool newdamage = false;
+
+	if (pwing > 0.0) {
+		if (oapiRand() < pwing) {
 			// simulate structural failure by distorting the airfoil definition
 			int rfail = rand();
 			switch (rfail & 3) {
@@ -1725,8 +2076,8 @@ void Scout::TestDamage ()
 	}
 
 	// top hatch damage
-	if (hatch_proc > 0.05 && hatchfail < 2 && dynp > 30e3) {
-		if (oapiRand() < 1.0 - exp(-dt*0.2)) {
+	if (phatch > 0.0) {
+		if (oapiRand() < phatch) {
 			hatchfail++;
 			newdamage = true;
 		}
@@ -1808,7 +2159,7 @@ bool Scout::RedrawPanel_Wingload (SURFHANDLE surf, bool force)
 	static const double dial_max =  217.0*RAD;
 	static const double eps = 1e-2;
 
-	double load = GetLift() / 190.0; // L/S
+	double load = fs.lift / 190.0; // L/S
 	double dial_angle = PI - min (dial_max, max (dial_min, load/15.429e3*PI));
 	if (force || fabs (dial_angle-load_ind) > eps) {
 		oapiBltPanelAreaBackground (AID_LOADINSTR, surf);
@@ -1959,8 +2310,7 @@ bool Scout::RedrawPanel_RotVelocity (SURFHANDLE surf, int which)
 {
 	int idx;
 	double v, av;
-	VECTOR3 vrot;
-	GetAngularVel (vrot);
+	const VECTOR3 &vrot = FrameAngularVel();
 	v  = (which == AID_VPITCH ? -vrot.x : which == AID_VBANK ? -vrot.z : vrot.y);
 	av = fabs(v*DEG);
 
@@ -1985,8 +2335,7 @@ bool Scout::RedrawPanel_RotAcceleration (SURFHANDLE surf, int which)
 {
 	int idx;
 	double a, aa;
-	VECTOR3 arot;
-	GetAngularAcc (arot);
+	const VECTOR3 &arot = FrameAngularAcc();
 	a  = (which == AID_APITCH ? -arot.x : which == AID_ABANK ? -arot.z : arot.y);
 	a *= 2.0;
 	aa = fabs(a*DEG);
@@ -2012,8 +2361,7 @@ bool Scout::RedrawPanel_RotMoment (SURFHANDLE surf, int which)
 {
 	int idx;
 	double m, am;
-	VECTOR3 amom;
-	GetAngularMoment (amom);
+	const VECTOR3 &amom = FrameAngularMoment();
 	m  = (which == AID_MPITCH ? -amom.x : which == AID_MBANK ? -amom.z : amom.y);
 	m *= 1e-3;
 	am = fabs(m);
@@ -2449,10 +2797,18 @@ void Scout::clbkSetClassCaps (FILEHANDLE cfg)
 {
 	// *************** physical parameters **********************
 
-	bool b;
 	int i;
-	if (oapiReadItem_bool (cfg, "SCRAMJET", b) && b) // set up scramjet configuration
+	if (cls) ScoutClass::Release (cls);
+	cls = ScoutClass::Acquire (GetClassName(), cfg);
+	// cfg options, parsed once per vessel class
+
+	if (Fleet::Enabled ()) Fleet::Attach (this);
+	// batched post-step computations (FLEET_THREADS)
+
+	if (cls->scram) { // set up scramjet configuration
 		scramjet = new Ramjet (this);
+		scramjet->EnableTable (cls->scramtable); // tabulated inlet performance
+	}
 
 	VESSEL3::SetEmptyMass (scramjet ? EMPTY_MASS_SC : EMPTY_MASS);
 	VECTOR3 r[2] = {{0,0,6}, {0,0,-4}};
@@ -2622,6 +2978,33 @@ void Scout::clbkSetClassCaps (FILEHANDLE cfg)
 	LightEmitter *le = AddPointLight (_V(0,0,-10), 200, 1e-3, 0, 2e-3, col_d, col_s, col_a);
 	le->SetIntensityRef (&th_main_level);
 
+	// ************ mass-proportional thrust limits *************
+
+	static const struct {
+		THGROUP_TYPE grp;  // thruster group
+		DWORD n;           // number of group members to scale
+		double factor;     // max. thrust per unit mass [N/kg]
+	} thscaledef[] = {
+		{THGROUP_MAIN,          2, MAIN_THRUST_PER_KG},
+		{THGROUP_ATT_PITCHUP,   2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_PITCHDOWN, 2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_UP,        2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_DOWN,      2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_YAWLEFT,   2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_YAWRIGHT,  2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_LEFT,      2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_RIGHT,     2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_BANKLEFT,  2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_BANKRIGHT, 2, RCS_THRUST_PER_KG*0.5},
+		{THGROUP_ATT_FORWARD,   1, RCS_THRUST_PER_KG},
+		{THGROUP_ATT_BACK,      1, RCS_THRUST_PER_KG}
+	};
+	if (thscale) delete thscale;
+	thscale = new ThrustScale (this);
+	for (i = 0; i < (int)(sizeof(thscaledef)/sizeof(thscaledef[0])); i++)
+		thscale->AddGroup (thscaledef[i].grp, thscaledef[i].n, thscaledef[i].factor);
+	thscale->SetEpsilon (cls->thscale_eps);
+
 	// **************** scramjet definitions ********************
 
 	if (scramjet) {
@@ -2645,10 +3028,19 @@ void Scout::clbkSetClassCaps (FILEHANDLE cfg)
 
 	// ********************* aerodynamics ***********************
 
-	hwing = CreateAirfoil3 (LIFT_VERTICAL, _V(0,0,-.3), VLiftCoeff, 0, 5, 90, 1.5);
+	AeroDB *aerodb = cls->aerodb;
+	// Mach x AoA x sideslip database replacing the built-in model
+
+	bool aeroref = cls->aeroref;
+	// evaluate the built-in model directly instead of the tables
+
+	AirfoilCoeffFuncEx vlift = (aerodb ? VLiftCoeff_db : aeroref ? VLiftCoeff_ref : VLiftCoeff);
+	AirfoilCoeffFuncEx hlift = (aerodb ? HLiftCoeff_db : aeroref ? HLiftCoeff_ref : HLiftCoeff);
+
+	hwing = CreateAirfoil3 (LIFT_VERTICAL, _V(0,0,-.3), vlift, aerodb, 5, 90, 1.5);
 	// wing and body lift+drag components
 
-	CreateAirfoil3 (LIFT_HORIZONTAL, _V(0,0,-4), HLiftCoeff, 0, 5, 15, 1.5);
+	CreateAirfoil3 (LIFT_HORIZONTAL, _V(0,0,-4), hlift, aerodb, 5, 15, 1.5);
 	// vertical stabiliser and body lift and drag components
 
 	//CreateControlSurface3 (AIRCTRL_ELEVATOR,     1.4, 1.5, _V(   0,0,-7.2), AIRCTRL_AXIS_XPOS, 1.0, anim_elevator);
@@ -2698,82 +3090,147 @@ void Scout::clbkSetClassCaps (FILEHANDLE cfg)
 	SetMeshVisibilityMode (AddMesh (exmesh_tpl = oapiLoadMeshGlobal (ScramVersion() ? "scout" : "scout")), MESHVIS_EXTERNAL);
 	SetMeshVisibilityMode (AddMesh (vcmesh_tpl = oapiLoadMeshGlobal ("DG\\DeltaGliderCockpit")), MESHVIS_VC);
 
-	// **************** vessel-specific insignia ****************
-
-	insignia_tex = oapiCreateTextureSurface (256, 256);
-	SURFHANDLE hTex = oapiGetTextureHandle (exmesh_tpl, 5);
-	if (hTex) oapiBlt (insignia_tex, hTex, 0, 0, 0, 0, 256, 256);
-
 	// **************** create cockpit elements *****************
 
 	CreatePanelElements();
 }
 
+// --------------------------------------------------------------
+// Scenario keywords
+// --------------------------------------------------------------
+// scnkey is a perfect hash table: ScnHash maps each keyword to its
+// own slot, so a scenario line costs one hash and at most one
+// string comparison. A new keyword needs a free slot under ScnHash;
+// if there is none, the hash coefficients must be searched again.
+
+enum { SCN_NONE, SCN_DOOR, SCN_TRIM, SCN_TANKCONFIG, SCN_PSNGR, SCN_SKIN, SCN_LIGHTS, SCN_AAP };
+
+struct SCNKEY {
+	const char *name;  // keyword
+	int len;           // keyword length
+	int id;            // SCN_xxx
+	int act;           // actuator (SCN_DOOR only)
+};
+
+static const SCNKEY scnkey[32] = {
+	{0,0,0,0},                                // 0
+	{0,0,0,0},                                // 1
+	{0,0,0,0},                                // 2
+	{0,0,0,0},                                // 3
+	{0,0,0,0},                                // 4
+	{0,0,0,0},                                // 5
+	{"LADDER",     6, SCN_DOOR, Scout::ACT_LADDER},   // 6
+	{0,0,0,0},                                // 7
+	{"PSNGR",      5, SCN_PSNGR, 0},          // 8
+	{"NOSECONE",   8, SCN_DOOR, Scout::ACT_NOSE},     // 9
+	{"HATCH",      5, SCN_DOOR, Scout::ACT_HATCH},    // 10
+	{0,0,0,0},                                // 11
+	{"RCOVER",     6, SCN_DOOR, Scout::ACT_RCOVER},   // 12
+	{"SKIN",       4, SCN_SKIN, 0},           // 13
+	{0,0,0,0},                                // 14
+	{0,0,0,0},                                // 15
+	{"RADIATOR",   8, SCN_DOOR, Scout::ACT_RADIATOR}, // 16
+	{"TANKCONFIG",10, SCN_TANKCONFIG, 0},     // 17
+	{0,0,0,0},                                // 18
+	{0,0,0,0},                                // 19
+	{"AIRLOCK",    7, SCN_DOOR, Scout::ACT_OLOCK},    // 20
+	{"LIGHTS",     6, SCN_LIGHTS, 0},         // 21
+	{0,0,0,0},                                // 22
+	{"AAP",        3, SCN_AAP, 0},            // 23
+	{0,0,0,0},                                // 24
+	{0,0,0,0},                                // 25
+	{0,0,0,0},                                // 26
+	{0,0,0,0},                                // 27
+	{"AIRBRAKE",   8, SCN_DOOR, Scout::ACT_BRAKE},    // 28
+	{"GEAR",       4, SCN_DOOR, Scout::ACT_GEAR},     // 29
+	{"IAIRLOCK",   8, SCN_DOOR, Scout::ACT_ILOCK},    // 30
+	{"TRIM",       4, SCN_TRIM, 0}            // 31
+};
+
+static inline int ScnHash (const char *key, int len)
+{
+	return (2*len + toupper (key[0]) + 15*toupper (key[len-1])) & 31;
+}
+
+// door states in the order they are written
+static const struct {
+	Scout::Actuator act;
+	char *name;
+} scndoor[9] = {
+	{Scout::ACT_GEAR, "GEAR"}, {Scout::ACT_RCOVER, "RCOVER"}, {Scout::ACT_NOSE, "NOSECONE"},
+	{Scout::ACT_OLOCK, "AIRLOCK"}, {Scout::ACT_ILOCK, "IAIRLOCK"}, {Scout::ACT_BRAKE, "AIRBRAKE"},
+	{Scout::ACT_RADIATOR, "RADIATOR"}, {Scout::ACT_LADDER, "LADDER"}, {Scout::ACT_HATCH, "HATCH"}
+};
+
 // --------------------------------------------------------------
 // Read status from scenario file
 // --------------------------------------------------------------
 void Scout::clbkLoadStateEx (FILEHANDLE scn, void *vs)
 {
-    char *line;
+	char *line;
+	const char *p;
+	int i, len;
 
+	PROFILE_BEGIN (LOADSTATE);
 	while (oapiReadScenario_nextline (scn, line)) {
-        if (!_strnicmp (line, "NOSECONE", 8)) {
-			sscanf (line+8, "%d%lf", &nose_status, &nose_proc);
-		} else if (!_strnicmp (line, "GEAR", 4)) {
-			sscanf (line+4, "%d%lf", &gear_status, &gear_proc);
-		} else if (!_strnicmp (line, "RCOVER", 6)) {
-			sscanf (line+6, "%d%lf", &rcover_status, &rcover_proc);
-		} else if (!_strnicmp (line, "AIRLOCK", 7)) {
-			sscanf (line+7, "%d%lf", &olock_status, &olock_proc);
-		} else if (!_strnicmp (line, "IAIRLOCK", 8)) {
-			sscanf (line+8, "%d%lf", &ilock_status, &ilock_proc);
-		} else if (!_strnicmp (line, "AIRBRAKE", 8)) {
-			sscanf (line+8, "%d%lf", &brake_status, &brake_proc);
-		} else if (!_strnicmp (line, "RADIATOR", 8)) {
-			sscanf (line+8, "%d%lf", &radiator_status, &radiator_proc);
-		} else if (!_strnicmp (line, "LADDER", 6)) {
-			sscanf (line+6, "%d%lf", &ladder_status, &ladder_proc);
-		} else if (!_strnicmp (line, "HATCH", 5)) {
-			sscanf (line+5, "%d%lf", &hatch_status, &hatch_proc);
-		} else if (!_strnicmp (line, "TRIM", 4)) {
-			double trim;
-			sscanf (line+4, "%lf", &trim);
+		for (len = 0; line[len] && line[len] != ' ' && line[len] != '\t'; len++);
+		const SCNKEY *key = (len ? scnkey + ScnHash (line, len) : NULL);
+		if (!key || key->len != len || _strnicmp (line, key->name, len)) {
+			ParseScenarioLineEx (line, vs);
+			// unrecognised option - pass to Orbiter's generic parser
+			continue;
+		}
+		p = line+len;
+		switch (key->id) {
+		case SCN_DOOR: {
+			int status;
+			if ((p = ScnReadInt (p, status)) != NULL) {
+				// clamp to the valid range: the values are used as
+				// animation states and format into scn_door
+				double proc = act_proc[key->act];
+				ScnReadFloat (p, proc);
+				if (status < DOOR_CLOSED) status = DOOR_CLOSED;
+				else if (status > DOOR_OPENING) status = DOOR_OPENING;
+				act_status[key->act] = (DoorStatus)status;
+				act_proc[key->act] = (proc > 0.0 ? (proc < 1.0 ? proc : 1.0) : 0.0); // also NaN
+				scndirty |= 1 << key->act;
+			}
+			} break;
+		case SCN_TRIM: {
+			double trim = 0.0;
+			ScnReadFloat (p, trim);
 			SetControlSurfaceLevel (AIRCTRL_ELEVATORTRIM, trim);
-		} else if (!_strnicmp (line, "TANKCONFIG", 10)) {
-			if (scramjet) sscanf (line+10, "%d", &tankconfig);
-		} else if (!_strnicmp (line, "PSNGR", 5)) {
-			DWORD i, res, pi[4];
-			res = sscanf (line+5, "%d%d%d%d", pi+0, pi+1, pi+2, pi+3);
-			for (i = 0; i < res; i++)
-				if (pi[i]-1 < 4) psngr[pi[i]-1] = true;
-		} else if (!_strnicmp (line, "SKIN", 4)) {
-			sscanf (line+4, "%s", skinpath);
-			char fname[256];
-			strcpy (fname, "DG\\Skins\\");
-			strcat (fname, skinpath);
-			int n = strlen(fname); fname[n++] = '\\';
-			strcpy (fname+n, "dgmk4_1.dds");  skin[0] = oapiLoadTexture (fname);
-			strcpy (fname+n, scramjet ? "dgmk4_2.dds" : "dgmk4_2_ns.dds");  skin[1] = oapiLoadTexture (fname);
-			strcpy (fname+n, "idpanel1.dds"); skin[2] = oapiLoadTexture (fname);
-			if (skin[2]) {
-				oapiBlt (insignia_tex, skin[2], 0, 0, 0, 0, 256, 256);
-				oapiReleaseTexture (skin[2]);
-				skin[2] = NULL;
+			} break;
+		case SCN_TANKCONFIG:
+			if (scramjet) ScnReadInt (p, tankconfig);
+			break;
+		case SCN_PSNGR: {
+			int pi;
+			for (i = 0; i < 4 && (p = ScnReadInt (p, pi)); i++)
+				if ((DWORD)(pi-1) < 4) psngr[pi-1] = true;
+			scndirty |= SCNF_PSNGR;
+			} break;
+		case SCN_SKIN: {
+			// textures are prefetched in the background and picked up in clbkPostCreation
+			if (ScnReadToken (p, skinpath, 32)) {
+				if (skinid >= 0) SkinManager::Release (skinid);
+				skinid = SkinManager::Request (skinpath, scramjet != NULL);
 			}
-		} else if (!_strnicmp (line, "LIGHTS", 6)) {
-			int lgt[4];
-			sscanf (line+6, "%d%d%d%d", lgt+0, lgt+1, lgt+2, lgt+3);
+			} break;
+		case SCN_LIGHTS: {
+			int lgt[4] = {0, 0, 0, 0};
+			for (i = 0; i < 4 && (p = ScnReadInt (p, lgt[i])); i++);
 			SetNavlight (lgt[0] != 0);
 			SetBeacon (lgt[1] != 0);
 			SetStrobe (lgt[2] != 0);
 			SetDockingLight (lgt[3] != 0);
-		} else if (!_strnicmp (line, "AAP", 3)) {
+			} break;
+		case SCN_AAP:
 			aap->SetState (line);
-        } else {
-            ParseScenarioLineEx (line, vs);
-			// unrecognised option - pass to Orbiter's generic parser
-        }
-    }
+			break;
+		}
+	}
+	PROFILE_END (LOADSTATE);
 
 	// modify tank configuration (DG-S only)
 	if (tankconfig != 0) {
@@ -2797,65 +3254,63 @@ void Scout::clbkLoadStateEx (FILEHANDLE scn, void *vs)
 // --------------------------------------------------------------
 void Scout::clbkSaveState (FILEHANDLE scn)
 {
-	char cbuf[256];
+	char *p;
 	int i;
 
+	PROFILE_BEGIN (SAVESTATE);
+
 	// Write default vessel parameters
 	VESSEL3::clbkSaveState (scn);
 
-	// Write custom parameters
-	if (gear_status) {
-		sprintf (cbuf, "%d %0.4f", gear_status, gear_proc);
-		oapiWriteScenario_string (scn, "GEAR", cbuf);
-	}
-	if (rcover_status) {
-		sprintf (cbuf, "%d %0.4f", rcover_status, rcover_proc);
-		oapiWriteScenario_string (scn, "RCOVER", cbuf);
-	}
-	if (nose_status) {
-		sprintf (cbuf, "%d %0.4f", nose_status, nose_proc);
-		oapiWriteScenario_string (scn, "NOSECONE", cbuf);
-	}
-	if (olock_status) {
-		sprintf (cbuf, "%d %0.4f", olock_status, olock_proc);
-		oapiWriteScenario_string (scn, "AIRLOCK", cbuf);
-	}
-	if (ilock_status) {
-		sprintf (cbuf, "%d %0.4f", ilock_status, ilock_proc);
-		oapiWriteScenario_string (scn, "IAIRLOCK", cbuf);
-	}
-	if (brake_status) {
-		sprintf (cbuf, "%d %0.4f", brake_status, brake_proc);
-		oapiWriteScenario_string (scn, "AIRBRAKE", cbuf);
-	}
-	if (radiator_status) {
-		sprintf (cbuf, "%d %0.4f", radiator_status, radiator_proc);
-		oapiWriteScenario_string (scn, "RADIATOR", cbuf);
-	}
-	if (ladder_status) {
-		sprintf (cbuf, "%d %0.4f", ladder_status, ladder_proc);
-		oapiWriteScenario_string (scn, "LADDER", cbuf);
+	// Doors in motion have changed since the last save. Bring their
+	// lazily evaluated positions up to date.
+	double t = oapiGetSimTime();
+	for (i = 0; i < NACTUATOR; i++)
+		if (act_status[i] >= DOOR_CLOSING) {
+			ActuatorProc ((Actuator)i, t);
+			scndirty |= 1 << i;
+		}
+
+	// Write custom parameters. Only fields that have changed since the
+	// last save are formatted, the others reuse the strings from then.
+	for (i = 0; i < 9; i++) {
+		Actuator a = scndoor[i].act;
+		if (scndirty & (1 << a)) {
+			if (act_status[a]) {
+				p = ScnWriteInt (scn_door[a], act_status[a]);
+				*p++ = ' ';
+				ScnWriteFixed (p, (int)(scn_door[a]+sizeof(scn_door[a])-p), act_proc[a], 4);
+			} else scn_door[a][0] = '\0';
+		}
+		if (scn_door[a][0])
+			oapiWriteScenario_string (scn, scndoor[i].name, scn_door[a]);
 	}
-	if (hatch_status) {
-		sprintf (cbuf, "%d %0.4lf", hatch_status, hatch_proc);
-		oapiWriteScenario_string (scn, "HATCH", cbuf);
+	if (scndirty & SCNF_PSNGR) {
+		for (p = scn_psngr, i = 0; i < 4; i++)
+			if (psngr[i]) {
+				if (p > scn_psngr) *p++ = ' ';
+				p = ScnWriteInt (p, i+1);
+			}
+		*p = '\0';
 	}
-	for (i = 0; i < 4; i++)
-		if (psngr[i]) {
-			sprintf (cbuf, "%d", i+1);
-			for (++i; i < 4; i++)
-				if (psngr[i]) sprintf (cbuf+strlen(cbuf), " %d", i+1);
-			oapiWriteScenario_string (scn, "PSNGR", cbuf);
-			break;
-		}
+	if (scn_psngr[0])
+		oapiWriteScenario_string (scn, "PSNGR", scn_psngr);
 	if (skinpath[0])
 		oapiWriteScenario_string (scn, "SKIN", skinpath);
-	for (i = 0; i < 8; i++)
-		if (beacon[i].active) {
-			sprintf (cbuf, "%d %d %d %d", beacon[0].active, beacon[3].active, beacon[5].active, beacon[7].active);
-			oapiWriteScenario_string (scn, "LIGHTS", cbuf);
-			break;
-		}
+	if (scndirty & SCNF_LIGHTS) {
+		scn_lights[0] = '\0';
+		for (i = 0; i < 8; i++)
+			if (beacon[i].active) {
+				static const int lgt[4] = {0, 3, 5, 7};
+				for (p = scn_lights, i = 0; i < 4; i++) {
+					if (i) *p++ = ' ';
+					p = ScnWriteInt (p, beacon[lgt[i]].active ? 1 : 0);
+				}
+				break;
+			}
+	}
+	if (scn_lights[0])
+		oapiWriteScenario_string (scn, "LIGHTS", scn_lights);
 
 	double trim = GetControlSurfaceLevel (AIRCTRL_ELEVATORTRIM);
 	if (trim) oapiWriteScenario_float (scn, "TRIM", trim);
@@ -2864,7 +3319,210 @@ void Scout::clbkSaveState (FILEHANDLE scn)
 		oapiWriteScenario_int (scn, "TANKCONFIG", tankconfig);
 
 	// write out AAP settings
-	aap->WriteScenario (scn);
+	if (scndirty & SCNF_AAP)
+		aap->FormatScenario (scn_aap);
+	oapiWriteScenario_string (scn, "AAP", scn_aap);
+	scndirty = 0;
+	PROFILE_END (SAVESTATE);
+}
+
+// --------------------------------------------------------------
+// Binary checkpoints
+// Unlike the scenario round trip, these don't format or parse
+// anything, so a Scout can be snapshot and restored many times per
+// frame (rewinds, what-if runs). The simulation clock isn't part of
+// the state: door motions continue from the restored position at
+// the current time, and the autopilot control loops restart from
+// the restored targets.
+// --------------------------------------------------------------
+void Scout::SaveCheckpoint (ScoutCheckpoint &ck)
+{
+	int i;
+	double t = oapiGetSimTime();
+
+	ck.magic   = SCOUT_CKPT_MAGIC;
+	ck.version = SCOUT_CKPT_VERSION;
+	ck.size    = sizeof(ScoutCheckpoint);
+
+	memset (&ck.vs, 0, sizeof(VESSELSTATUS2));
+	ck.vs.version = 2;
+	GetStatusEx (&ck.vs);
+
+	for (i = 0; i < NACTUATOR; i++) {
+		ck.act_status[i] = act_status[i];
+		ck.act_proc[i] = ActuatorProc ((Actuator)i, t);
+	}
+
+	for (i = 0; i < 2; i++) {
+		GetThrusterDir (th_main[i], ck.maindir[i]);
+		if (scramjet) GetThrusterDir (th_scram[i], ck.scramdir[i]);
+		else          ck.scramdir[i] = _V(0,0,1);
+		ck.mpgimbalidx[i] = mpgimbalidx[i];
+		ck.mygimbalidx[i] = mygimbalidx[i];
+		ck.scgimbalidx[i] = scgimbalidx[i];
+	}
+	ck.hbalanceidx = hbalanceidx;
+	ck.mpmode = mpmode;
+	ck.mymode = mymode;
+	ck.spmode = spmode;
+	ck.hbmode = hbmode;
+
+	ck.lwingstatus = lwingstatus;
+	ck.rwingstatus = rwingstatus;
+	ck.hatchfail = hatchfail;
+	ck.mws = bMWSActive;
+	for (i = 0; i < 4; i++) {
+		ck.aileronfail[i] = aileronfail[i];
+		ck.lights[i] = GetBeaconState (i);
+		ck.psngr[i] = psngr[i];
+	}
+
+	ck.tankconfig = tankconfig;
+	ck.maxfuel[0] = max_rocketfuel;
+	ck.maxfuel[1] = max_scramfuel;
+	ck.fuel[0] = GetPropellantMass (ph_main);
+	ck.fuel[1] = GetPropellantMass (ph_rcs);
+	ck.fuel[2] = (scramjet ? GetPropellantMass (ph_scram) : 0.0);
+	for (i = 0; i < 2; i++) {
+		ck.thlevel[i]   = GetThrusterLevel (th_main[i]);
+		ck.thlevel[2+i] = GetThrusterLevel (th_retro[i]);
+		ck.thlevel[4+i] = GetThrusterLevel (th_hover[i]);
+		ck.thlevel[6+i] = (scramjet ? GetThrusterLevel (th_scram[i]) : 0.0);
+	}
+	ck.trim = GetControlSurfaceLevel (AIRCTRL_ELEVATORTRIM);
+
+	aap->GetTargets (ck.aaptgt, ck.aapactive);
+}
+
+bool Scout::RestoreCheckpoint (const ScoutCheckpoint &ck)
+{
+	if (ck.magic != SCOUT_CKPT_MAGIC || ck.version != SCOUT_CKPT_VERSION || ck.size != sizeof(ScoutCheckpoint))
+		return false;
+
+	int i;
+
+	// reject handles that don't refer to a live object of the right
+	// kind, and door states outside the valid range
+	int rtype = oapiGetObjectType (ck.vs.rbody);
+	if (ck.vs.version != 2 || (rtype != OBJTP_PLANET && rtype != OBJTP_STAR))
+		return false;
+	if (ck.vs.status == 1 && ck.vs.base && (oapiGetObjectType (ck.vs.base) != OBJTP_SURFBASE ||
+		oapiGetBasePlanet (ck.vs.base) != ck.vs.rbody))
+		return false;
+	for (i = 0; i < NACTUATOR; i++)
+		if ((DWORD)ck.act_status[i] > DOOR_OPENING || !(ck.act_proc[i] >= 0.0 && ck.act_proc[i] <= 1.0))
+			return false;
+
+	// the snapshot never contains fuel, thruster or dock lists
+	VESSELSTATUS2 vs = ck.vs;
+	if (vs.status != 1) vs.base = NULL;
+	vs.flag = 0;
+	vs.nfuel = vs.nthruster = vs.ndockinfo = 0;
+	vs.fuel = NULL;
+	vs.thruster = NULL;
+	vs.dockinfo = NULL;
+	DefSetStateEx (&vs);
+
+	// doors: any interrupted motion restarts from the stored position
+	for (i = 0; i < NACTUATOR; i++) {
+		actq.Cancel (i);
+		act_proc[i] = ck.act_proc[i];
+		SetActuator ((Actuator)i, (DoorStatus)ck.act_status[i]);
+		if (act_anim[i] != ACT_NOANIM) SetAnimation (act_anim[i], act_proc[i]);
+	}
+	SetGearParameters (gear_proc);
+	EnableRetroThrusters (rcover_status == DOOR_OPEN);
+	UpdateStatusIndicators();
+
+	// gimbals and hover balance
+	for (i = 0; i < 2; i++) {
+		SetThrusterDir (th_main[i], ck.maindir[i]);
+		if (scramjet) SetThrusterDir (th_scram[i], ck.scramdir[i]);
+	}
+	if (memcmp (mpgimbalidx, ck.mpgimbalidx, sizeof(mpgimbalidx)) || mpmode != ck.mpmode) {
+		memcpy (mpgimbalidx, ck.mpgimbalidx, sizeof(mpgimbalidx));
+		mpmode = ck.mpmode;
+		oapiTriggerRedrawArea (0, 0, AID_PGIMBALMAINDISP);
+		oapiTriggerRedrawArea (0, 0, AID_PGIMBALMAINMODE);
+	}
+	if (memcmp (mygimbalidx, ck.mygimbalidx, sizeof(mygimbalidx)) || mymode != ck.mymode) {
+		memcpy (mygimbalidx, ck.mygimbalidx, sizeof(mygimbalidx));
+		mymode = ck.mymode;
+		oapiTriggerRedrawArea (0, 0, AID_YGIMBALMAINDISP);
+		oapiTriggerRedrawArea (0, 0, AID_YGIMBALMAINMODE);
+	}
+	if (memcmp (scgimbalidx, ck.scgimbalidx, sizeof(scgimbalidx)) || spmode != ck.spmode) {
+		memcpy (scgimbalidx, ck.scgimbalidx, sizeof(scgimbalidx));
+		spmode = ck.spmode;
+		oapiTriggerRedrawArea (0, 0, AID_GIMBALSCRAMDISP);
+		oapiTriggerRedrawArea (0, 0, AID_GIMBALSCRAMMODE);
+	}
+	if (hbalanceidx != ck.hbalanceidx || hbmode != ck.hbmode) {
+		hbalanceidx = ck.hbalanceidx;
+		hbmode = ck.hbmode;
+		oapiTriggerRedrawArea (0, 0, AID_HBALANCEDISP);
+		oapiTriggerRedrawArea (0, 0, AID_HBALANCEMODE);
+	}
+
+	// damage
+	if (lwingstatus != ck.lwingstatus || rwingstatus != ck.rwingstatus || hatchfail != ck.hatchfail ||
+		memcmp (aileronfail, ck.aileronfail, sizeof(aileronfail))) {
+		lwingstatus = ck.lwingstatus;
+		rwingstatus = ck.rwingstatus;
+		hatchfail = ck.hatchfail;
+		memcpy (aileronfail, ck.aileronfail, sizeof(aileronfail));
+		ApplyDamage ();
+	}
+	if (bMWSActive != ck.mws) {
+		bMWSActive = ck.mws;
+		oapiTriggerRedrawArea (0, 0, AID_MWS);
+	}
+
+	// lights and passengers
+	if (GetBeaconState (0) != ck.lights[0]) SetNavlight (ck.lights[0]);
+	if (GetBeaconState (1) != ck.lights[1]) SetBeacon (ck.lights[1]);
+	if (GetBeaconState (2) != ck.lights[2]) SetStrobe (ck.lights[2]);
+	if (GetBeaconState (3) != ck.lights[3]) SetDockingLight (ck.lights[3]);
+	if (memcmp (psngr, ck.psngr, sizeof(psngr))) {
+		memcpy (psngr, ck.psngr, sizeof(psngr));
+		scndirty |= SCNF_PSNGR;
+		SetEmptyMass ();
+		SetPassengerVisuals ();
+	}
+
+	// tanks and engines
+	tankconfig = ck.tankconfig;
+	if (max_rocketfuel != ck.maxfuel[0]) SetPropellantMaxMass (ph_main, max_rocketfuel = ck.maxfuel[0]);
+	if (scramjet && max_scramfuel != ck.maxfuel[1]) SetPropellantMaxMass (ph_scram, max_scramfuel = ck.maxfuel[1]);
+	SetPropellantMass (ph_main, ck.fuel[0]);
+	SetPropellantMass (ph_rcs, ck.fuel[1]);
+	if (scramjet) SetPropellantMass (ph_scram, ck.fuel[2]);
+	for (i = 0; i < 2; i++) {
+		SetThrusterLevel (th_main[i], ck.thlevel[i]);
+		SetThrusterLevel (th_retro[i], ck.thlevel[2+i]);
+		SetThrusterLevel (th_hover[i], ck.thlevel[4+i]);
+		if (scramjet) SetThrusterLevel (th_scram[i], ck.thlevel[6+i]);
+	}
+	SetControlSurfaceLevel (AIRCTRL_ELEVATORTRIM, ck.trim);
+	scram_memo.valid = false;
+
+	aap->SetTargets (ck.aaptgt, ck.aapactive);
+	return true;
+}
+
+DWORD Scout::PushCheckpoint ()
+{
+	if (!ckring) ckring = new CheckpointRing (sizeof(ScoutCheckpoint), cls->ckring_size);
+	SaveCheckpoint (*(ScoutCheckpoint*)ckring->Push());
+	return ckring->Count();
+}
+
+bool Scout::Rewind (DWORD back)
+{
+	const ScoutCheckpoint *ck = (ckring ? (const ScoutCheckpoint*)ckring->Get (back) : NULL);
+	if (!ck || !RestoreCheckpoint (*ck)) return false;
+	ckring->Drop (back);
+	return true;
 }
 
 // --------------------------------------------------------------
@@ -2872,6 +3530,8 @@ void Scout::clbkSaveState (FILEHANDLE scn)
 // --------------------------------------------------------------
 void Scout::clbkPostCreation ()
 {
+	for (int i = 0; i < NACTUATOR; i++)
+		SetActuator ((Actuator)i, act_status[i]);
 	EnableRetroThrusters (rcover_status == DOOR_OPEN);
 	SetGearParameters (gear_proc);
 	SetEmptyMass ();
@@ -2896,8 +3556,10 @@ void Scout::clbkPostCreation ()
 	//SetAnimation (anim_hatchswitch, hatch_status & 1);
 	//SetAnimation (anim_ladderswitch, ladder_status & 1);
 
-	if (insignia_tex)
-		PaintMarkings (insignia_tex);
+	// the default textures stay on until the skin files have been
+	// prefetched (see clbkPreStep)
+	if (skinid >= 0)
+		skinwait = !SkinManager::Resolve (skinid, skin);
 }
 
 // --------------------------------------------------------------
@@ -2972,6 +3634,10 @@ void Scout::clbkVisualDestroyed (VISHANDLE vis, int refcount)
 	visual = NULL;
 	exmesh = NULL;
 	vcmesh = NULL;
+	if (insignia_tex) {
+		Insignia::Release (insignia_tex);
+		insignia_tex = NULL;
+	}
 }
 
 // --------------------------------------------------------------
@@ -3028,8 +3694,16 @@ void Scout::clbkNavMode (int mode, bool active)
 // --------------------------------------------------------------
 void Scout::clbkPostStep (double simt, double simdt, double mjd)
 {
+	PROFILE_BEGIN (POSTSTEP);
+
+	// batched computations for all vessels (first call in the frame)
+	bool batched = Fleet::Step (this, simt);
+
 	// calculate max scramjet thrust
-	if (scramjet) ScramjetThrust ();
+	if (scramjet) {
+		if (batched) Fleet::ApplyScramjet (this);
+		else         ScramjetThrust ();
+	}
 
 	th_main_level = GetThrusterGroupLevel (THGROUP_MAIN);
 
@@ -3039,187 +3713,11 @@ void Scout::clbkPostStep (double simt, double simdt, double mjd)
 	if (spmode) AdjustScramGimbal (spmode);
 	if (hbmode) AdjustHoverBalance (hbmode);
 
-	// animate landing gear
-	if (gear_status >= DOOR_CLOSING) {
-		double da = simdt * GEAR_OPERATING_SPEED;
-		if (gear_status == DOOR_CLOSING) {
-			if (gear_proc > 0.0)
-				gear_proc = max (0.0, gear_proc-da);
-			else {
-				gear_status = DOOR_CLOSED;
-				//oapiTriggerRedrawArea (2, 0, AID_GEARINDICATOR);
-			}
-		} else  { // door opening
-			if (gear_proc < 1.0)
-				gear_proc = min (1.0, gear_proc+da);
-			else {
-				gear_status = DOOR_OPEN;
-				//oapiTriggerRedrawArea (2, 0, AID_GEARINDICATOR);
-			}
-		}
-		SetAnimation (anim_gear01, gear_proc);
-		//SetAnimation (anim_gear02, gear_proc);
-		SetGearParameters (gear_proc);
-		oapiTriggerRedrawArea (0, 0, AID_GEARINDICATOR);
-		UpdateStatusIndicators();
-	}
+	// animate landing gear, doors, radiator and airbrake
+	if (actq.nPending()) StepActuators (simt);
 
-	// animate retro covers
-	if (rcover_status >= DOOR_CLOSING) {
-		double da = simdt * RCOVER_OPERATING_SPEED;
-		if (rcover_status == DOOR_CLOSING) {
-			if (rcover_proc > 0.0)
-				rcover_proc = max (0.0, rcover_proc-da);
-			else {
-				rcover_status = DOOR_CLOSED;
-			}
-		} else {
-			if (rcover_proc < 1.0)
-				rcover_proc = min (1.0, rcover_proc+da);
-			else {
-				rcover_status = DOOR_OPEN;
-				EnableRetroThrusters (true);
-			}
-		}
-		//SetAnimation (anim_gear, rcover_proc);
-		UpdateStatusIndicators();
-	}
-
-	// animate nose cone
-	if (nose_status >= DOOR_CLOSING) {
-		double da = simdt * NOSE_OPERATING_SPEED;
-		if (nose_status == DOOR_CLOSING) {
-			if (nose_proc > 0.0)
-				nose_proc = max (0.0, nose_proc-da);
-			else {
-				nose_status = DOOR_CLOSED;
-			}
-		} else { // door opening
-			if (nose_proc < 1.0)
-				nose_proc = min (1.0, nose_proc+da);
-			else {
-				nose_status = DOOR_OPEN;
-			}
-		}
-		//SetAnimation (anim_nose, nose_proc);
-		oapiTriggerRedrawArea (0, 0, AID_NOSECONEINDICATOR);
-		UpdateStatusIndicators();
-	}
-
-	// animate escape ladder
-	if (ladder_status >= DOOR_CLOSING) {
-		double da = simdt * LADDER_OPERATING_SPEED;
-		if (ladder_status == DOOR_CLOSING) {
-			if (ladder_proc > 0.0)
-				ladder_proc = max (0.0, ladder_proc-da);
-			else {
-				ladder_status = DOOR_CLOSED;
-				//oapiTriggerPanelRedrawArea (2, AID_NOSECONEINDICATOR);
-			}
-		} else {
-			if (ladder_proc < 1.0)
-				ladder_proc = min (1.0, ladder_proc+da);
-			else {
-				ladder_status = DOOR_OPEN;
-				//oapiTriggerPanelRedrawArea (2, AID_NOSECONEINDICATOR);
-			}
-		}
-		//SetAnimation (anim_ladder, ladder_proc);
-	}
-
-	// animate top hatch
-	if (hatch_status >= DOOR_CLOSING) {
-		double da = simdt * HATCH_OPERATING_SPEED;
-		if (hatch_status == DOOR_CLOSING) {
-			if (hatch_proc > 0.0)
-				hatch_proc = max (0.0, hatch_proc-da);
-			else {
-				hatch_status = DOOR_CLOSED;
-				//oapiTriggerPanelRedrawArea (2, AID_NOSECONEINDICATOR);
-			}
-		} else {
-			if (hatch_proc < 1.0)
-				hatch_proc = min (1.0, hatch_proc+da);
-			else {
-				hatch_status = DOOR_OPEN;
-				//oapiTriggerPanelRedrawArea (2, AID_NOSECONEINDICATOR);
-			}
-		}
-		//SetAnimation (anim_hatch, hatch_proc);
-		UpdateStatusIndicators();
-	}
-
-	// animate outer airlock
-	if (olock_status >= DOOR_CLOSING) {
-		double da = simdt * AIRLOCK_OPERATING_SPEED;
-		if (olock_status == DOOR_CLOSING) {
-			if (olock_proc > 0.0)
-				olock_proc = max (0.0, olock_proc-da);
-			else {
-				olock_status = DOOR_CLOSED;
-				//oapiTriggerPanelRedrawArea (1, AID_AIRLOCKINDICATOR);
-			}
-		} else { // door opening
-			if (olock_proc < 1.0)
-				olock_proc = min (1.0, olock_proc+da);
-			else {
-				olock_status = DOOR_OPEN;
-				//oapiTriggerPanelRedrawArea (1, AID_AIRLOCKINDICATOR);
-			}
-		}
-		//SetAnimation (anim_olock, olock_proc);
-		UpdateStatusIndicators();
-	}
-
-	// animate inner airlock
-	if (ilock_status >= DOOR_CLOSING) {
-		double da = simdt * AIRLOCK_OPERATING_SPEED;
-		if (ilock_status == DOOR_CLOSING) {
-			if (ilock_proc > 0.0)
-				ilock_proc = max (0.0, ilock_proc-da);
-			else {
-				ilock_status = DOOR_CLOSED;
-				//oapiTriggerPanelRedrawArea (1, AID_AIRLOCKINDICATOR);
-			}
-		} else { // door opening
-			if (ilock_proc < 1.0)
-				ilock_proc = min (1.0, ilock_proc+da);
-			else {
-				ilock_status = DOOR_OPEN;
-				//oapiTriggerPanelRedrawArea (1, AID_AIRLOCKINDICATOR);
-			}
-		}
-		//SetAnimation (anim_ilock, ilock_proc);
-		UpdateStatusIndicators();
-	}
-
-	// animate radiator
-	if (radiator_status >= DOOR_CLOSING) {
-		double da = simdt * RADIATOR_OPERATING_SPEED;
-		if (radiator_status == DOOR_CLOSING) { // retract radiator
-			if (radiator_proc > 0.0) radiator_proc = max (0.0, radiator_proc-da);
-			else                     radiator_status = DOOR_CLOSED;
-		} else {                               // deploy radiator
-			if (radiator_proc < 1.0) radiator_proc = min (1.0, radiator_proc+da);
-			else                     radiator_status = DOOR_OPEN;
-		}
-		//SetAnimation (anim_radiator, radiator_proc);
-		UpdateStatusIndicators();
-	}
-
-	// animate airbrake
-	if (brake_status >= DOOR_CLOSING) {
-		double da = simdt * AIRBRAKE_OPERATING_SPEED;
-		if (brake_status == DOOR_CLOSING) { // retract brake
-			if (brake_proc > 0.0) brake_proc = max (0.0, brake_proc-da);
-			else                  brake_status = DOOR_CLOSED;
-		} else {                            // deploy brake
-			if (brake_proc < 1.0) brake_proc = min (1.0, brake_proc+da);
-			else                  brake_status = DOOR_OPEN;
-		}
-		//SetAnimation (anim_brake, brake_proc);
-		UpdateStatusIndicators();
-	}
+	// script sequences waiting for this vessel
+	Sequencer::Step (this, simt);
 
 	if (hatch_vent && simt > hatch_vent_t + 1.0) {
 		DelExhaustStream (hatch_vent);
@@ -3227,7 +3725,10 @@ void Scout::clbkPostStep (double simt, double simdt, double mjd)
 	}
 
 	// damage/failure system
-	if (bDamageEnabled) TestDamage ();
+	if (bDamageEnabled) {
+		if (batched) Fleet::ApplyDamage (this);
+		else         TestDamage ();
+	}
 	if (bMWSActive) {
 		double di;
 		bool mwson = (modf (simt, &di) < 0.5);
@@ -3236,6 +3737,8 @@ void Scout::clbkPostStep (double simt, double simdt, double mjd)
 			oapiTriggerRedrawArea (0, 0, AID_MWS);
 		}
 	}
+
+	PROFILE_END (POSTSTEP);
 }
 
 bool Scout::clbkLoadGenericCockpit ()
@@ -4344,6 +4847,13 @@ DLLCLBK void InitModule (HINSTANCE hModule)
 
 	// allocate textures
 	Scout::panel2dtex = oapiLoadTexture ("Scout\\dg_panel.dds");
+
+	// airfoil coefficient tables
+	InitAeroTables ();
+
+	PROFILE_INIT ();
+	Sequencer::Init ();
+	SkinManager::Init ();
 }
 
 // --------------------------------------------------------------
@@ -4351,6 +4861,12 @@ DLLCLBK void InitModule (HINSTANCE hModule)
 // --------------------------------------------------------------
 DLLCLBK void ExitModule (HINSTANCE hModule)
 {
+	PROFILE_EXIT ();
+	LuaProfile::Exit ();
+	Sequencer::Exit ();
+	SkinManager::Exit ();
+	Insignia::Exit ();
+	Fleet::Exit ();
 	oapiUnregisterCustomControls (hModule);
 
 	int i;
@@ -4505,6 +5021,7 @@ BOOL CALLBACK EdPg2Proc (HWND hTab, UINT uMsg, WPARAM wParam, LPARAM lParam)
 			i = SendDlgItemMessage (hTab, LOWORD(wParam), BM_GETCHECK, 0, 0);
 			dg = GetDG(hTab);
 			dg->psngr[LOWORD(wParam)-IDC_CHECK1] = (i ? true:false);
+			dg->ScnDirty (Scout::SCNF_PSNGR);
 			dg->SetPassengerVisuals();
 			dg->SetEmptyMass();
 			sprintf (cbuf, "%0.2f kg", dg->GetMass());
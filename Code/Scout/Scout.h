@@ -22,6 +22,10 @@
 
 #include "orbitersdk.h"
 #include "Ramjet.h"
+#include "ThrustScale.h"
+#include "EventQueue.h"
+#include "HUDOverlay.h"
+#include "CheckpointRing.h"
 #include "Instrument.h"
 #include "resource.h"
 
@@ -61,6 +65,16 @@ const double MAX_HOVER_THRUST[2] = {1.4e5, 1.1e5};
 const double MAX_RCS_THRUST = 2.5e3;
 // Attitude control system max thrust [N] per engine.
 
+const double MAIN_THRUST_PER_KG = 9.8;
+const double RCS_THRUST_PER_KG  = 9.8*0.01;
+// Mass-proportional thrust limits [N/kg] of each main engine and of
+// an RCS thrust direction (shared by the engines of a group). These
+// override the nominal ratings at runtime.
+
+const double THRUST_SCALE_EPS = 1e-4;
+// Relative mass change before the mass-proportional thrust limits
+// are recomputed (overridden by THRUST_SCALE_EPS in the class cfg)
+
 const double ISP = 4e10;
 // Vacuum Isp (fuel-specific impulse) for all thrusters [m/s]
 
@@ -93,6 +107,9 @@ const double HATCH_OPERATING_SPEED = 0.15;
 const double RCOVER_OPERATING_SPEED = 0.3;
 // Retro cover opening/closing speed
 
+const UINT ACT_NOANIM = (UINT)-1;
+// Actuator animation handle: no animation attached
+
 // ========= Main engine parameters ============
 
 const double MAIN_PGIMBAL_RANGE = tan (1.0*RAD);
@@ -136,6 +153,13 @@ const double SCRAM_GIMBAL_RANGE = 5.0*RAD;
 const double SCRAM_GIMBAL_SPEED = SCRAM_GIMBAL_RANGE/3.0;
 // Operating speed of scramjet pitch gimbals (rad/s)
 
+const double SCRAM_MEMO_TOL[4] = {1e-3, 1e-4, 1e-4, 1e-3};
+// Default tolerances for reusing the last scramjet thrust solution:
+// Mach number, relative freestream pressure, relative freestream
+// temperature, throttle level. Can be overridden with the
+// SCRAMJET_MEMO entry in the class cfg (all zero = reuse only for
+// identical states)
+
 // ============ Damage parameters ==============
 
 const double WINGLOAD_MAX =  16e3;
@@ -164,12 +188,45 @@ const DWORD INSTR2_TEXH   =  512;
 const DWORD INSTR3_TEXW   =  268;
 const DWORD INSTR3_TEXH   =  188;
 
+class AeroDB;
+class AAP;
+class ScoutClass;
+struct ScoutCheckpoint;
+
+// ==========================================================
+// Vessel state sampled once at the start of each time step
+// (Scout::UpdateFrameState). Per-step code and instruments read
+// it instead of querying the same values from Orbiter repeatedly.
+// The rotational state is only needed by the panel instruments and
+// is sampled on first use within a frame.
+// ==========================================================
+
+struct ScoutFrameState {
+	double simt;            // simulation time of the snapshot [s]
+	double mass;            // total vessel mass [kg]
+	VECTOR3 weight;         // weight vector (vessel frame) [N]
+	double rho;             // atmospheric density [kg/m^3]
+	double lift;            // lift magnitude [N]
+	double dynp;            // dynamic pressure [Pa]
+	OBJHANDLE hAtm;         // atmosphere reference body (scramjet version only)
+	const ATMCONST *atm;    // atmosphere constants of hAtm (NULL: none)
+	double mach, p0, T0;    // Mach number, freestream pressure [Pa] and temperature [K] (scramjet version only)
+
+	DWORD rotvalid;         // FS_ROT* flags of the rotational state sampled this frame
+	VECTOR3 vrot, arot, amom; // angular velocity, acceleration and moment
+};
+
+#define FS_ROTVEL 0x1
+#define FS_ROTACC 0x2
+#define FS_ROTMOM 0x4
+
 // ==========================================================
 // Interface for derived vessel class: Scout
 // ==========================================================
 
 class Scout: public VESSEL3 {
 	friend class AAP;
+	friend class Fleet;
 	friend class FuelMFD;
 	friend class ThrottleMain;
 	friend class ThrottleHover;
@@ -243,6 +300,8 @@ public:
 	bool ShiftHoverBalance (int mode);
 	void AdjustHoverBalance (int &mode);
 	void TestDamage ();
+	void DamageHazard (double dt, double &alpha, double &pwing, double &phatch); // failure rate and probabilities
+	void DamageApply (double alpha, double pwing, double phatch); // draw and apply failures
 	void ApplyDamage ();
 	void RepairDamage ();
 	bool MWSActive() const { return bMWSActive; }
@@ -293,8 +352,17 @@ public:
 	int hatchfail;
 	bool aileronfail[4];
 
-	enum DoorStatus { DOOR_CLOSED, DOOR_OPEN, DOOR_CLOSING, DOOR_OPENING }
-		nose_status, ladder_status, gear_status, rcover_status, olock_status, ilock_status, hatch_status, radiator_status, brake_status;
+	enum DoorStatus { DOOR_CLOSED, DOOR_OPEN, DOOR_CLOSING, DOOR_OPENING };
+	enum Actuator { ACT_GEAR, ACT_RCOVER, ACT_NOSE, ACT_LADDER, ACT_HATCH, ACT_OLOCK, ACT_ILOCK, ACT_RADIATOR, ACT_BRAKE, NACTUATOR };
+	enum { SCNF_PSNGR = 1<<NACTUATOR, SCNF_LIGHTS = SCNF_PSNGR<<1, SCNF_AAP = SCNF_PSNGR<<2, SCNF_ALL = (SCNF_PSNGR<<3)-1 };
+	// scenario fields for incremental saves (actuator a: bit 1<<a)
+	inline void ScnDirty (DWORD f) { scndirty |= f; }
+	// mark scenario fields as changed since the last save
+	DoorStatus act_status[NACTUATOR];        // actuator states
+	double act_proc[NACTUATOR];              // actuator positions (0=closed, 1=open)
+	UINT act_anim[NACTUATOR];                // actuator animations (ACT_NOANIM=none)
+	DoorStatus &nose_status, &ladder_status, &gear_status, &rcover_status, &olock_status, &ilock_status, &hatch_status, &radiator_status, &brake_status;
+	// aliases for the act_status entries
 	void ActivateLandingGear (DoorStatus action);
 	void ActivateRCover (DoorStatus action);
 	void ActivateDockingPort (DoorStatus action);
@@ -313,7 +381,8 @@ public:
 	void RevertAirbrake ();
 	void RevertRadiator ();
 	void SetGearParameters (double state);
-	double nose_proc, ladder_proc, gear_proc, rcover_proc, olock_proc, ilock_proc, hatch_proc, radiator_proc, brake_proc;     // logical status
+	double &nose_proc, &ladder_proc, &gear_proc, &rcover_proc, &olock_proc, &ilock_proc, &hatch_proc, &radiator_proc, &brake_proc;
+	// aliases for the act_proc entries (logical status)
 	UINT anim_gear01;       // handle for landing gear animation
 	UINT anim_gear02;       // handle for landing gear animation
 	UINT anim_gear03;       // handle for landing gear animation
@@ -357,7 +426,7 @@ public:
 	UINT anim_radiatorswitch;   // VC radiator switch animation
 
 	SURFHANDLE srf[nsurf];          // handles for panel bitmaps
-	SURFHANDLE insignia_tex;        // vessel-specific fuselage markings
+	SURFHANDLE insignia_tex;        // vessel-specific fuselage markings (shared, while a visual exists)
 	SURFHANDLE contrail_tex;        // contrail particle texture
 	static SURFHANDLE panel2dtex;   // texture for 2D instrument panel
 	MESHHANDLE exmesh_tpl;          // vessel mesh: global template
@@ -379,9 +448,33 @@ public:
 
 	double GetThrusterFlowRate(THRUSTER_HANDLE th);  // D. Beachy: get thruster flow rate in kg/s
 
+	inline const ScoutFrameState &FrameState () const { return fs; }
+	// state snapshot of the current time step
+
+	const VECTOR3 &FrameAngularVel ();
+	const VECTOR3 &FrameAngularAcc ();
+	const VECTOR3 &FrameAngularMoment ();
+	// rotational state of the current frame (sampled on first use)
+
+	void SaveCheckpoint (ScoutCheckpoint &ck);
+	// take a binary snapshot of the vessel state
+
+	bool RestoreCheckpoint (const ScoutCheckpoint &ck);
+	// return to a snapshot. Fails if ck is from an incompatible version
+	// or refers to objects that don't exist.
+
+	DWORD PushCheckpoint ();
+	// snapshot into the checkpoint ring; returns the number of entries
+
+	bool Rewind (DWORD back = 0);
+	// restore the ring entry back places before the newest one and
+	// discard the newer entries
+
 	// script interface-related methods
 	int Lua_InitInterpreter (void *context);
 	int Lua_InitInstance (void *context);
+	int Lua_GetState (void *context);
+	int Lua_SetDoors (void *context);
 
 private:
 	MGROUP_TRANSFORM *RGear02T01, *RGear01R01, *RFootR01, *RNull02R01;
@@ -393,9 +486,45 @@ private:
 	void PaintMarkings (SURFHANDLE tex);         // paint individual vessel markings
 
 	Ramjet *scramjet;                            // scramjet module (NULL = none)
+	ThrustScale *thscale;                        // mass-proportional thrust limits
 	void ScramjetThrust ();                      // scramjet thrust calculation
+	bool ScramjetSolve (const double *level, double *Fmax, double *isp); // pure part; false: limits unchanged
+	void ScramjetApply (const double *Fmax, const double *isp); // set the new thrust limits and Isp
+	int fleetidx;                                // slot in the Fleet batch (-1: not attached)
+
+	ScoutFrameState fs;                          // per-step state snapshot
+	void UpdateFrameState (double simt);         // fill fs at the start of a time step
+
+	struct ActuatorDef {    // static actuator parameters
+		double speed;                            // opening/closing speed [1/s]
+		bool track;                              // position needed every step (drag, animation, redraw)?
+		int redraw;                              // panel area redrawn while moving (0=none)
+		bool statusind;                          // shown on the status indicator panel?
+		void (Scout::*moved)();                  // called after each position update (or NULL)
+		void (Scout::*done)(DoorStatus);         // called when the actuator stops (or NULL)
+	};
+	static const ActuatorDef actdef[NACTUATOR];  // indexed by Actuator
+	double act_t0[NACTUATOR], act_p0[NACTUATOR]; // start time and position of current motion
+	EventQueue actq;                             // completion times of moving actuators
+	BYTE act_active[NACTUATOR];                  // moving actuators with track flag
+	DWORD nact_active;                           // length of act_active
+	int act_blink;                               // status indicator blink phase at last update
+	void SetActuator (Actuator a, DoorStatus status); // set actuator state and schedule its completion
+	double ActuatorProc (Actuator a, double simt);    // actuator position at time simt
+	void StepActuators (double simt);            // fire completion events, update tracked actuators
+	void GearMoved ();
+	void RCoverDone (DoorStatus status);
+
+	struct ScramMemo {      // flight state of the last scramjet thrust calculation
+		bool valid;
+		OBJHANDLE hAtm;
+		double M, p0, T0, lvl[2];
+	} scram_memo;
+
+	const ScoutClass *cls;                       // class-wide settings (shared)
 
 	AAP *aap;                                    // atmospheric autopilot
+	CheckpointRing *ckring;                      // rewind buffer (created on first use)
 
 	PanelElement **instr;                        // panel instrument objects
 	DWORD ninstr;                                // total number of instruments
@@ -407,9 +536,15 @@ private:
 	int tankconfig;                              // 0=rocket fuel only, 1=scramjet fuel only, 2=both
 	double max_rocketfuel, max_scramfuel;        // max capacity for rocket and scramjet fuel
 	VISHANDLE visual;                            // handle to DG visual representation
-	SURFHANDLE skin[3];                          // custom skin textures, if applicable
+	SURFHANDLE skin[3];                          // custom skin textures, if applicable (owned by SkinManager)
 	MESHHANDLE hPanelMesh;                       // 2-D instrument panel mesh handle
+	HUDOverlay *hudovl;                          // textured HUD annunciators
 	char skinpath[32];                           // skin directory, if applicable
+	int skinid;                                  // SkinManager id of the skin, or -1
+	bool skinwait;                               // skin requested, textures not loaded yet
+	DWORD scndirty;                              // scenario fields changed since the last save (SCNF_xxx)
+	char scn_door[NACTUATOR][24];                // scenario values formatted by the last save ("": not written)
+	char scn_psngr[8], scn_lights[8], scn_aap[96];
 	PROPELLANT_HANDLE ph_main, ph_rcs, ph_scram; // propellant resource handles
 	THRUSTER_HANDLE th_main[2];                  // main engine handles
 	THRUSTER_HANDLE th_retro[2];                 // retro engine handles
@@ -450,6 +585,45 @@ private:
 	} p_rngdisp;
 };
 
+// ==========================================================
+// Binary snapshot of the vessel state (Scout::SaveCheckpoint).
+// Plain data, so it can be copied with memcpy, kept in a
+// CheckpointRing or passed to scripts as a string. A snapshot is
+// only accepted by a module with the same version and layout;
+// bump SCOUT_CKPT_VERSION when the structure changes. The object
+// handles in vs are checked against the live objects on restore,
+// and its list pointers are ignored, since a script can hand back
+// any string (e.g. one saved in an earlier session).
+// ==========================================================
+
+const WORD SCOUT_CKPT_VERSION = 2;
+const DWORD SCOUT_CKPT_MAGIC = 0x4B434353; // "SCCK"
+
+struct ScoutCheckpoint {
+	DWORD magic;            // SCOUT_CKPT_MAGIC
+	WORD version;           // SCOUT_CKPT_VERSION
+	WORD size;              // sizeof(ScoutCheckpoint)
+	VESSELSTATUS2 vs;       // position, velocity, attitude (without lists)
+	int act_status[Scout::NACTUATOR];   // door states
+	double act_proc[Scout::NACTUATOR];  // door positions
+	VECTOR3 maindir[2], scramdir[2];    // gimbaled thrust directions
+	int mpgimbalidx[2], mygimbalidx[2], scgimbalidx[2], hbalanceidx; // gimbal and balance indicators
+	int mpmode, mymode, spmode, hbmode; // gimbal and balance auto modes
+	double lwingstatus, rwingstatus;    // wing integrity
+	int hatchfail;          // hatch damage
+	bool aileronfail[4];    // aileron damage
+	bool mws;               // master warning active
+	bool lights[4];         // nav, beacon, strobe, docking light
+	bool psngr[4];          // passengers
+	int tankconfig;         // tank configuration
+	double maxfuel[2];      // rocket and scramjet tank capacities [kg]
+	double fuel[3];         // main, RCS and scramjet propellant [kg]
+	double thlevel[8];      // main, retro, hover, scramjet thruster levels
+	double trim;            // elevator trim
+	double aaptgt[3];       // autopilot targets
+	bool aapactive[3];      // autopilot blocks engaged
+};
+
 // ==============================================================
 
 class DGPanelElement: public PanelElement {
@@ -0,0 +1,103 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ScoutClass.cpp
+// Class-wide settings shared by all Scouts of a vessel class
+// ==============================================================
+
+#include "ScoutClass.h"
+#include "Scout.h"
+#include "AeroDB.h"
+#include "LuaProfile.h"
+#include "Sequencer.h"
+#include "Fleet.h"
+#include <stdio.h>
+#include <string.h>
+
+ScoutClass *ScoutClass::first = NULL;
+
+// ==============================================================
+
+const ScoutClass *ScoutClass::Acquire (const char *classname, FILEHANDLE cfg)
+{
+	ScoutClass *cls;
+	for (cls = first; cls; cls = cls->next)
+		if (!_stricmp (cls->name, classname)) {
+			if (++cls->nref > cls->nmax) cls->nmax = cls->nref;
+			return cls;
+		}
+
+	cls = new ScoutClass (classname, cfg);
+	cls->next = first;
+	first = cls;
+	return cls;
+}
+
+// ==============================================================
+
+void ScoutClass::Release (const ScoutClass *cls)
+{
+	ScoutClass **pc;
+	for (pc = &first; *pc; pc = &(*pc)->next)
+		if (*pc == cls) {
+			ScoutClass *c = *pc;
+			if (!--c->nref) {
+				*pc = c->next;
+				delete c;
+			}
+			return;
+		}
+}
+
+// ==============================================================
+
+ScoutClass::ScoutClass (const char *classname, FILEHANDLE cfg)
+{
+	bool b;
+	int n;
+	double v;
+	char cbuf[256];
+
+	strncpy (name, classname, 63);
+	name[63] = '\0';
+	nref = nmax = 1;
+	next = NULL;
+
+	scram = (oapiReadItem_bool (cfg, "SCRAMJET", b) && b);
+	scramtable = (scram && oapiReadItem_bool (cfg, "SCRAMJET_TABLE", b) && b);
+	for (n = 0; n < 4; n++)
+		memo_tol[n] = SCRAM_MEMO_TOL[n];
+	if (scram && oapiReadItem_string (cfg, "SCRAMJET_MEMO", cbuf))
+		sscanf (cbuf, "%lf%lf%lf%lf", memo_tol+0, memo_tol+1, memo_tol+2, memo_tol+3);
+
+	thscale_eps = (oapiReadItem_float (cfg, "THRUST_SCALE_EPS", v) ? v : THRUST_SCALE_EPS);
+
+	aerodb = (oapiReadItem_string (cfg, "AERO_DATABASE", cbuf) ? AeroDB::Open (cbuf) : NULL);
+	aeroref = (oapiReadItem_bool (cfg, "AERO_REFERENCE", b) && b);
+
+	aapnative = (oapiReadItem_bool (cfg, "AAP_NATIVE", b) && b);
+	ckring_size = (oapiReadItem_int (cfg, "CHECKPOINT_RING", n) && n > 0 ? n : 64);
+
+	// module-wide options
+	if (oapiReadItem_bool (cfg, "LUA_PROFILE", b) && b)
+		LuaProfile::Enable ();
+	Sequencer::SetBudget (oapiReadItem_float (cfg, "SEQ_BUDGET", v) ? v*1e-3 : SEQ_BUDGET);
+	if (oapiReadItem_int (cfg, "FLEET_THREADS", n) && n)
+		Fleet::Enable (n);
+}
+
+// ==============================================================
+
+ScoutClass::~ScoutClass ()
+{
+#ifdef SCOUT_PROFILE
+	char cbuf[256];
+	sprintf (cbuf, "Scout class %s: %d vessels, %u bytes shared, %u bytes per vessel",
+		name, nmax, (unsigned)sizeof(ScoutClass), (unsigned)sizeof(Scout));
+	oapiWriteLog (cbuf);
+#endif
+	if (aerodb) AeroDB::Release (aerodb);
+}
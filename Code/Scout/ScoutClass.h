@@ -0,0 +1,56 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ScoutClass.h
+// Class-wide settings shared by all Scouts of a vessel class
+//
+// Notes:
+// * The options in the class cfg file are the same for every
+//   vessel of the class. They are parsed by the first vessel of
+//   the class and kept in a ScoutClass, which all vessels of the
+//   class share. The block is freed with the last vessel.
+// * Use Acquire/Release rather than new/delete. The settings are
+//   read-only after creation.
+// ==============================================================
+
+#ifndef __SCOUTCLASS_H
+#define __SCOUTCLASS_H
+
+#include "Orbitersdk.h"
+
+class AeroDB;
+
+class ScoutClass {
+public:
+	static const ScoutClass *Acquire (const char *classname, FILEHANDLE cfg);
+	// Return the settings of vessel class classname, reading them
+	// from cfg for the first vessel of the class
+
+	static void Release (const ScoutClass *cls);
+	// Drop a reference obtained from Acquire
+
+	bool scram;               // scramjet configuration (SCRAMJET)
+	bool scramtable;          // tabulated inlet performance (SCRAMJET_TABLE)
+	double memo_tol[4];       // scramjet thrust reuse tolerances (SCRAMJET_MEMO, see SCRAM_MEMO_TOL)
+	double thscale_eps;       // thrust limit update threshold (THRUST_SCALE_EPS)
+	AeroDB *aerodb;           // aerodynamic database (AERO_DATABASE, NULL = built-in model)
+	bool aeroref;             // evaluate the built-in model directly (AERO_REFERENCE)
+	bool aapnative;           // autopilot uses AAPCore instead of aap.lua (AAP_NATIVE)
+	DWORD ckring_size;        // capacity of the rewind buffer (CHECKPOINT_RING)
+
+private:
+	ScoutClass (const char *classname, FILEHANDLE cfg);
+	~ScoutClass ();
+
+	char name[64];            // vessel class name
+	int nref;                 // reference count
+	int nmax;                 // max. number of simultaneous references
+	ScoutClass *next;         // next class in the module list
+
+	static ScoutClass *first; // list of vessel classes in use
+};
+
+#endif // !__SCOUTCLASS_H
@@ -0,0 +1,522 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Sequencer.cpp
+// Event-driven script sequences (coroutines) for Scout vessels
+// ==============================================================
+
+#include "Sequencer.h"
+#include "EventQueue.h"
+#include "AAPHost.h"
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+#include "lua\lua.h"
+#include "lua\lualib.h"
+#include "lua\lauxlib.h"
+}
+
+Sequencer::SEQ Sequencer::seq[SEQ_MAXSEQ];
+int Sequencer::nseq = 0;
+int Sequencer::nready = 0;
+int Sequencer::nlevel = 0;
+int Sequencer::ndoor = 0;
+int Sequencer::ndead = 0;
+int Sequencer::rr = 0;
+EventQueue *Sequencer::tq = NULL;
+double Sequencer::tstep = -1e10;
+double Sequencer::budget = SEQ_BUDGET;
+INTERPRETERHANDLE Sequencer::hInterp = NULL;
+CRITICAL_SECTION Sequencer::cs;
+bool Sequencer::posted = false;
+bool Sequencer::pumpreg = false;
+bool Sequencer::running = false;
+
+// quantities for WaitAbove/WaitBelow
+enum { QTY_ALT, QTY_SPD, QTY_GSPD, QTY_MACH, QTY_DYNP, QTY_VS, NQTY };
+static const char *qtyname[NQTY] = {"alt", "spd", "gspd", "mach", "dynp", "vs"};
+
+// error message on top of the stack of co (error objects need not be strings)
+static const char *SeqError (lua_State *co)
+{
+	const char *msg = lua_tostring (co, -1);
+	return (msg ? msg : "(error object is not a string)");
+}
+
+// ==============================================================
+
+void Sequencer::Init ()
+{
+	InitializeCriticalSection (&cs);
+	tq = new EventQueue (SEQ_MAXSEQ);
+	for (int i = 0; i < SEQ_MAXSEQ; i++) {
+		seq[i].state = SEQ_FREE;
+		seq[i].src = NULL;
+	}
+}
+
+// ==============================================================
+
+void Sequencer::Exit ()
+{
+	for (int i = 0; i < SEQ_MAXSEQ; i++)
+		if (seq[i].state != SEQ_FREE) Release (NULL, seq+i);
+	if (hInterp) {
+		oapiDelInterpreter (hInterp);
+		hInterp = NULL;
+	}
+	posted = pumpreg = false;
+	delete tq;
+	DeleteCriticalSection (&cs);
+}
+
+// ==============================================================
+
+bool Sequencer::Start (VESSEL *v, const char *src)
+{
+	int i;
+
+	EnterCriticalSection (&cs);
+	for (i = 0; i < SEQ_MAXSEQ; i++)
+		if (seq[i].state == SEQ_FREE) break;
+	if (i < SEQ_MAXSEQ) {
+		SEQ *s = seq+i;
+		s->v = v;
+		strncpy (s->name, v->GetName(), 63);
+		s->name[63] = '\0';
+		s->src = new char[strlen(src)+1];
+		strcpy (s->src, src);
+		s->co = NULL;
+		s->ref = LUA_NOREF;
+		s->state = SEQ_NEW;
+		nseq++;
+		nready++;
+	}
+	LeaveCriticalSection (&cs);
+	return (i < SEQ_MAXSEQ);
+}
+
+// ==============================================================
+
+void Sequencer::Stop (VESSEL *v)
+{
+	EnterCriticalSection (&cs);
+	for (int i = 0; i < SEQ_MAXSEQ; i++) {
+		SEQ *s = seq+i;
+		if (s->v != v || s->state == SEQ_FREE || s->state == SEQ_DEAD) continue;
+		Unwait (s);
+		if (s->state == SEQ_NEW) {
+			nready--;
+			Release (NULL, s); // not started yet, no script state
+		} else {
+			if (s->state == SEQ_READY) nready--;
+			s->state = SEQ_DEAD; // released by the next pump
+			ndead++;
+		}
+	}
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+void Sequencer::Detach (VESSEL *v)
+{
+	INTERPRETERHANDLE hDel = NULL;
+
+	Stop (v);
+
+	// If only aborted sequences are left, drop them together with
+	// the interpreter instead of waiting for a pump. Not while a
+	// pump is running: the sequence it is resuming stays in the
+	// table until the pump releases it, and the interpreter is
+	// deleted by the next Step once the pump has returned.
+	EnterCriticalSection (&cs);
+	if (nseq == ndead && !running) {
+		for (int i = 0; i < SEQ_MAXSEQ; i++)
+			if (seq[i].state != SEQ_FREE) Release (NULL, seq+i);
+		hDel = Drop ();
+	}
+	LeaveCriticalSection (&cs);
+	if (hDel) oapiDelInterpreter (hDel);
+}
+
+// ==============================================================
+// Detach the interpreter from the sequencer and return its handle
+// for deletion, which the caller does after releasing cs. A pump
+// call still queued in it finds pumpreg cleared and returns.
+// Called with cs held.
+
+INTERPRETERHANDLE Sequencer::Drop ()
+{
+	INTERPRETERHANDLE h = hInterp;
+	hInterp = NULL;
+	posted = pumpreg = false;
+	return h;
+}
+
+// ==============================================================
+
+void Sequencer::Step (VESSEL *v, double simt)
+{
+	if (!nseq && !hInterp) return; // nothing to do
+
+	DWORD id;
+	INTERPRETERHANDLE hDel = NULL;
+	EnterCriticalSection (&cs);
+	if (!nseq) {
+		// all sequences finished: release the interpreter, once the
+		// pump that finished them has returned
+		if (!running) hDel = Drop ();
+	} else {
+		if (!hInterp) {
+			// the interface request runs the vessel's Lua instance
+			// callback, which calls InitInterpreter once seqhost
+			// exists; that registers the pump and sets pumpreg
+			char name[256], cbuf[300];
+			LuaQuoteString (name, 256, v->GetName());
+			sprintf (cbuf, "seqhost = {}\nvessel.get_interface(%s)", name);
+			hInterp = oapiCreateInterpreter();
+			oapiAsyncScriptCmd (hInterp, cbuf);
+		}
+
+		// deadlines, once per frame
+		if (simt != tstep) {
+			tstep = simt;
+			while (tq->Next (simt, id))
+				Ready (seq+id);
+		}
+
+		// thresholds of this vessel
+		if (nlevel) {
+			for (int i = 0; i < SEQ_MAXSEQ; i++) {
+				SEQ *s = seq+i;
+				if (s->v != v || s->state != SEQ_LEVEL) continue;
+				double x = Quantity (v, s->qty);
+				if (s->above ? x >= s->level : x <= s->level) {
+					nlevel--;
+					Ready (s);
+				}
+			}
+		}
+
+		if ((nready || ndead) && pumpreg && !posted) {
+			posted = true;
+			oapiAsyncScriptCmd (hInterp, "if seqhost.pump then seqhost.pump() end");
+		}
+	}
+	LeaveCriticalSection (&cs);
+	if (hDel) oapiDelInterpreter (hDel);
+}
+
+// ==============================================================
+
+void Sequencer::DoorDone (VESSEL *v, int act, int status)
+{
+	if (!ndoor) return; // nobody waiting
+
+	EnterCriticalSection (&cs);
+	for (int i = 0; i < SEQ_MAXSEQ; i++) {
+		SEQ *s = seq+i;
+		if (s->v == v && s->state == SEQ_DOOR && s->act == act && s->status == status) {
+			ndoor--;
+			Ready (s);
+		}
+	}
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+int Sequencer::WaitTime (lua_State *L, VESSEL *v, double dt)
+{
+	int res = 1;
+	EnterCriticalSection (&cs);
+	SEQ *s = Find (L, v);
+	if (!s) res = -1;
+	else if (dt > 0.0) {
+		s->state = SEQ_TIME;
+		tq->Schedule ((DWORD)(s-seq), oapiGetSimTime() + dt);
+	} else {
+		Ready (s); // resume in the next frame
+	}
+	LeaveCriticalSection (&cs);
+	return res;
+}
+
+// ==============================================================
+
+int Sequencer::WaitDoor (lua_State *L, VESSEL *v, int act, int status, int cur)
+{
+	int res;
+	EnterCriticalSection (&cs);
+	SEQ *s = Find (L, v);
+	if (!s) res = -1;
+	else if (cur == status) res = 0;
+	else {
+		s->state = SEQ_DOOR;
+		s->act = act;
+		s->status = status;
+		ndoor++;
+		res = 1;
+	}
+	LeaveCriticalSection (&cs);
+	return res;
+}
+
+// ==============================================================
+
+int Sequencer::WaitLevel (lua_State *L, VESSEL *v, const char *qty, double level, bool above)
+{
+	int q, res;
+	for (q = 0; q < NQTY; q++)
+		if (!strcmp (qty, qtyname[q])) break;
+	if (q == NQTY) return -2;
+
+	EnterCriticalSection (&cs);
+	SEQ *s = Find (L, v);
+	double x = Quantity (v, q);
+	if (!s) res = -1;
+	else if (above ? x >= level : x <= level) res = 0;
+	else {
+		s->state = SEQ_LEVEL;
+		s->qty = q;
+		s->level = level;
+		s->above = above;
+		nlevel++;
+		res = 1;
+	}
+	LeaveCriticalSection (&cs);
+	return res;
+}
+
+// ==============================================================
+
+void Sequencer::InitInterpreter (lua_State *L)
+{
+	lua_getglobal (L, "seqhost");
+	if (lua_istable (L, -1)) {
+		lua_getfield (L, -1, "pump");
+		bool reg = lua_isnil (L, -1);
+		lua_pop (L, 1);
+		if (reg) {
+			lua_pushcfunction (L, lua_pump);
+			lua_setfield (L, -2, "pump");
+			EnterCriticalSection (&cs);
+			pumpreg = true;
+			LeaveCriticalSection (&cs);
+		}
+	}
+	lua_pop (L, 1);
+}
+
+// ==============================================================
+
+int Sequencer::lua_pump (lua_State *L)
+{
+	Pump (L);
+	return 0;
+}
+
+// ==============================================================
+// The running sequence with coroutine L, if it belongs to v.
+// Called with cs held.
+
+Sequencer::SEQ *Sequencer::Find (lua_State *L, VESSEL *v)
+{
+	for (int i = 0; i < SEQ_MAXSEQ; i++)
+		if (seq[i].co == L && seq[i].state == SEQ_RUN)
+			return (seq[i].v == v ? seq+i : NULL);
+	return NULL;
+}
+
+// ==============================================================
+
+void Sequencer::Ready (SEQ *s)
+{
+	s->state = SEQ_READY;
+	nready++;
+}
+
+// ==============================================================
+// Drop the wait condition of s from the counters and the deadline
+// queue. Called with cs held.
+
+void Sequencer::Unwait (SEQ *s)
+{
+	switch (s->state) {
+	case SEQ_TIME:  tq->Cancel ((DWORD)(s-seq)); break;
+	case SEQ_DOOR:  ndoor--; break;
+	case SEQ_LEVEL: nlevel--; break;
+	}
+}
+
+// ==============================================================
+// Free the table entry of s. The coroutine reference is released
+// if L is given; otherwise it goes with the interpreter.
+
+void Sequencer::Release (lua_State *L, SEQ *s)
+{
+	if (L && s->ref != LUA_NOREF) luaL_unref (L, LUA_REGISTRYINDEX, s->ref);
+	if (s->src) {
+		delete []s->src;
+		s->src = NULL;
+	}
+	if (s->state == SEQ_DEAD) ndead--;
+	s->co = NULL;
+	s->ref = LUA_NOREF;
+	s->state = SEQ_FREE;
+	nseq--;
+}
+
+// ==============================================================
+// Create the coroutine of a new sequence: compile the source and
+// run it in an environment with V set to the vessel interface.
+
+bool Sequencer::Begin (lua_State *L, SEQ *s)
+{
+	lua_State *co = lua_newthread (L);
+	int ref = luaL_ref (L, LUA_REGISTRYINDEX);
+
+	int err = (s->src[0] == '@' ?
+		luaL_loadfile (co, s->src+1) :
+		luaL_loadbuffer (co, s->src, strlen (s->src), "sequence"));
+	if (!err) {
+		lua_getglobal (co, "vessel");
+		lua_getfield (co, -1, "get_interface");
+		lua_remove (co, -2);
+		lua_pushstring (co, s->name);
+		err = lua_pcall (co, 1, 1, 0);
+	}
+	if (err) {
+		char cbuf[256];
+		_snprintf (cbuf, 255, "Scout: sequence: %s", SeqError (co));
+		cbuf[255] = '\0';
+		oapiWriteLog (cbuf);
+		luaL_unref (L, LUA_REGISTRYINDEX, ref);
+		return false;
+	}
+
+	// stack: chunk, V
+	lua_newtable (co);                        // environment
+	lua_pushvalue (co, -2);
+	lua_setfield (co, -2, "V");
+	lua_newtable (co);                        // its metatable
+	lua_pushvalue (co, LUA_GLOBALSINDEX);
+	lua_setfield (co, -2, "__index");
+	lua_setmetatable (co, -2);
+	lua_setfenv (co, -3);
+	lua_pop (co, 1);                          // stack: chunk
+
+	EnterCriticalSection (&cs);
+	s->co = co;
+	s->ref = ref;
+	delete []s->src;
+	s->src = NULL;
+	LeaveCriticalSection (&cs);
+	return true;
+}
+
+// ==============================================================
+// Resume the sequences whose conditions have fired, until the
+// frame budget is used up. Runs in the sequence interpreter.
+// The table is not locked while a sequence runs. Entries in state
+// SEQ_RUN belong to the pump: Stop only marks them SEQ_DEAD, and
+// the pump releases them when the resume returns. While running is
+// set, the interpreter isn't deleted.
+
+void Sequencer::Pump (lua_State *L)
+{
+	LARGE_INTEGER freq, t0, t1;
+	int i, n, res;
+
+	QueryPerformanceFrequency (&freq);
+	QueryPerformanceCounter (&t0);
+
+	EnterCriticalSection (&cs);
+	if (!pumpreg) { // interpreter dropped by Detach or Step
+		LeaveCriticalSection (&cs);
+		return;
+	}
+	running = true;
+	posted = false;
+	for (i = 0; i < SEQ_MAXSEQ; i++)
+		if (seq[i].state == SEQ_DEAD) Release (L, seq+i);
+	LeaveCriticalSection (&cs);
+
+	for (n = 0; n < SEQ_MAXSEQ; n++) {
+		SEQ *s = seq + (rr+n) % SEQ_MAXSEQ;
+		EnterCriticalSection (&cs);
+		bool isnew = (s->state == SEQ_NEW);
+		bool run = (isnew || s->state == SEQ_READY);
+		if (run) {
+			s->state = SEQ_RUN;
+			nready--;
+		}
+		LeaveCriticalSection (&cs);
+		if (!run) continue;
+
+		if (isnew && !Begin (L, s)) {
+			EnterCriticalSection (&cs);
+			Release (NULL, s);
+			LeaveCriticalSection (&cs);
+			continue;
+		}
+		if (isnew) { // stopped while it was being compiled?
+			EnterCriticalSection (&cs);
+			bool dead = (s->state == SEQ_DEAD);
+			if (dead) Release (L, s);
+			LeaveCriticalSection (&cs);
+			if (dead) continue;
+		}
+
+		res = lua_resume (s->co, 0);
+
+		EnterCriticalSection (&cs);
+		if (res == LUA_YIELD && s->state != SEQ_DEAD) {
+			// plain coroutine.yield: resume in the next frame
+			if (s->state == SEQ_RUN) Ready (s);
+		} else {
+			if (res && res != LUA_YIELD) {
+				char cbuf[256];
+				_snprintf (cbuf, 255, "Scout: sequence: %s", SeqError (s->co));
+				cbuf[255] = '\0';
+				oapiWriteLog (cbuf);
+			}
+			Release (L, s);
+		}
+		LeaveCriticalSection (&cs);
+
+		QueryPerformanceCounter (&t1);
+		if ((double)(t1.QuadPart-t0.QuadPart)/(double)freq.QuadPart >= budget) {
+			n++;
+			break;
+		}
+	}
+	EnterCriticalSection (&cs);
+	rr = (rr+n) % SEQ_MAXSEQ; // the rest goes first next time
+	running = false;
+	LeaveCriticalSection (&cs);
+}
+
+// ==============================================================
+
+double Sequencer::Quantity (VESSEL *v, int qty)
+{
+	switch (qty) {
+	case QTY_ALT:  return v->GetAltitude();
+	case QTY_SPD:  return v->GetAirspeed();
+	case QTY_GSPD: return v->GetGroundspeed();
+	case QTY_MACH: return v->GetMachNumber();
+	case QTY_DYNP: return v->GetDynPressure();
+	case QTY_VS: {
+		VECTOR3 vel;
+		v->GetAirspeedVector (FRAME_HORIZON, vel);
+		return vel.y;
+		}
+	}
+	return 0.0;
+}
@@ -0,0 +1,131 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// Sequencer.h
+// Event-driven script sequences (coroutines) for Scout vessels
+//
+// Notes:
+// * A sequence is a Lua chunk started with dg:Sequence(src). It
+//   runs as a coroutine in a dedicated interpreter shared by all
+//   Scouts, with V set to the vessel that started it.
+// * Sequences wait with V:Wait(dt), V:WaitDoor(name, open) and
+//   V:WaitAbove/WaitBelow(quantity, level). The wait conditions
+//   are evaluated by the module (sim time deadlines in an
+//   EventQueue, door completion when the actuator finishes,
+//   thresholds in the vessel's time step), and a sequence is
+//   only resumed once its condition has fired. Waiting sequences
+//   cost no script execution at all.
+// * Resumption is capped by a per-frame time budget shared by all
+//   vessels (SEQ_BUDGET entry in the cfg file, in ms). Sequences
+//   that are ready when the budget is used up are resumed in the
+//   next frame, in round-robin order. A single resume can't be
+//   interrupted, so one step of a sequence may overrun the budget.
+// * The pump is only queued once the interpreter has registered
+//   it, so a pump call can't be lost (leaving posted set forever)
+//   while the interpreter is still starting up.
+// * A sequence being resumed is owned by the pump until the resume
+//   returns, and the interpreter is only deleted while no pump is
+//   running, so a vessel deleted in the middle of a pump can't pull
+//   the coroutine or the interpreter out from under it.
+// ==============================================================
+
+#ifndef __SEQUENCER_H
+#define __SEQUENCER_H
+
+#include "Orbitersdk.h"
+
+struct lua_State;
+class EventQueue;
+
+const int SEQ_MAXSEQ = 64;
+// max. number of sequences (all vessels)
+
+const double SEQ_BUDGET = 1e-3;
+// default script time budget per frame [s]
+
+class Sequencer {
+public:
+	static bool Start (VESSEL *v, const char *src);
+	// Queue a sequence for vessel v. src is a Lua chunk, or a file
+	// name preceded by '@'. Returns false if the table is full.
+
+	static void Stop (VESSEL *v);
+	// Abort all sequences of v. Can be called from any interpreter.
+
+	static void Detach (VESSEL *v);
+	// Abort all sequences of v before the vessel is deleted. Releases
+	// the interpreter if no other sequences are left and no pump is
+	// running.
+
+	static void Step (VESSEL *v, double simt);
+	// Evaluate the wait conditions of v. Call from clbkPostStep.
+
+	static void DoorDone (VESSEL *v, int act, int status);
+	// Actuator act of v has finished moving into state status
+
+	static void SetBudget (double dt) { budget = dt; }
+	// Set the per-frame script time budget [s]
+
+	static void InitInterpreter (lua_State *L);
+	// Register the pump function if L is the sequence interpreter.
+	// Called from the vessel's Lua instance callback, which runs
+	// when the interpreter's setup command requests the interface.
+
+	static void Init ();
+	static void Exit ();
+	// Module initialisation and cleanup
+
+	// Wait functions, called from a sequence coroutine L. They
+	// return 1 if the sequence must yield, 0 if the condition is
+	// already met and -1 if L is not a sequence of v. WaitLevel
+	// returns -2 for an unknown quantity.
+	static int WaitTime (lua_State *L, VESSEL *v, double dt);
+	static int WaitDoor (lua_State *L, VESSEL *v, int act, int status, int cur);
+	static int WaitLevel (lua_State *L, VESSEL *v, const char *qty, double level, bool above);
+
+private:
+	enum { SEQ_FREE, SEQ_NEW, SEQ_READY, SEQ_RUN, SEQ_TIME, SEQ_DOOR, SEQ_LEVEL, SEQ_DEAD };
+	struct SEQ {
+		VESSEL *v;            // vessel
+		char name[64];        // vessel name (for the interface)
+		char *src;            // source until started
+		lua_State *co;        // coroutine
+		int ref;              // registry ref of the coroutine
+		int state;            // SEQ_xxx
+		int act, status;      // awaited door state
+		int qty;              // awaited quantity
+		double level;         // threshold
+		bool above;           // wait for value >= level (else <=)
+	};
+
+	static SEQ *Find (lua_State *L, VESSEL *v);
+	static void Ready (SEQ *s);
+	static void Unwait (SEQ *s);
+	static void Release (lua_State *L, SEQ *s);
+	static bool Begin (lua_State *L, SEQ *s);
+	static void Pump (lua_State *L);
+	static INTERPRETERHANDLE Drop ();
+	static int lua_pump (lua_State *L);
+	static double Quantity (VESSEL *v, int qty);
+
+	static SEQ seq[SEQ_MAXSEQ];    // sequence table
+	static int nseq;               // sequences in use
+	static int nready;             // sequences waiting for the pump
+	static int nlevel;             // sequences waiting for a threshold
+	static int ndoor;              // sequences waiting for a door
+	static int ndead;              // aborted sequences not yet released
+	static int rr;                 // round-robin start of the next pump
+	static EventQueue *tq;         // deadlines
+	static double tstep;           // sim time of the last deadline check
+	static double budget;          // script time budget per frame [s]
+	static INTERPRETERHANDLE hInterp; // sequence interpreter
+	static CRITICAL_SECTION cs;    // guards the table
+	static bool posted;            // pump call queued?
+	static bool pumpreg;           // pump registered in the interpreter?
+	static bool running;           // pump running in the interpreter?
+};
+
+#endif // !__SEQUENCER_H
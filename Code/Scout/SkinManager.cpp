@@ -0,0 +1,213 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// SkinManager.cpp
+// Shared, prefetched skin textures
+// ==============================================================
+
+#include "SkinManager.h"
+#include "StepProfile.h"
+#include <stdio.h>
+#include <string.h>
+
+SkinManager::SKIN **SkinManager::skin = NULL;
+int SkinManager::nskin = 0;
+int SkinManager::nbuf = 0;
+SkinManager::SKIN **SkinManager::queue = NULL;
+int SkinManager::nqueue = 0;
+int SkinManager::nqbuf = 0;
+HANDLE SkinManager::hThread = NULL;
+bool SkinManager::running = false;
+CRITICAL_SECTION SkinManager::cs;
+
+// ==============================================================
+
+void SkinManager::Init ()
+{
+	InitializeCriticalSection (&cs);
+}
+
+// ==============================================================
+
+void SkinManager::Exit ()
+{
+	if (hThread) {
+		WaitForSingleObject (hThread, INFINITE);
+		CloseHandle (hThread);
+		hThread = NULL;
+	}
+	for (int i = 0; i < nskin; i++)
+		if (skin[i]) {
+			CloseHandle (skin[i]->hReady);
+			delete skin[i];
+		}
+	if (nbuf) delete []skin;
+	if (nqbuf) delete []queue;
+	skin = NULL;
+	queue = NULL;
+	nskin = nbuf = nqueue = nqbuf = 0;
+	DeleteCriticalSection (&cs);
+}
+
+// ==============================================================
+
+int SkinManager::Request (const char *path, bool scram)
+{
+	int i, id = -1;
+
+	EnterCriticalSection (&cs);
+	for (i = 0; i < nskin; i++)
+		if (skin[i] && skin[i]->refs && skin[i]->scram == scram && !_stricmp (skin[i]->path, path)) {
+			skin[i]->refs++;
+			LeaveCriticalSection (&cs);
+			return i;
+		}
+
+	// new skin
+	for (i = 0; i < nskin; i++)
+		if (!skin[i]) { id = i; break; }
+	if (id < 0) {
+		if (nskin == nbuf) {
+			SKIN **tmp = new SKIN*[nbuf += 16];
+			if (nskin) {
+				memcpy (tmp, skin, nskin*sizeof(SKIN*));
+				delete []skin;
+			}
+			skin = tmp;
+		}
+		id = nskin++;
+	}
+	SKIN *s = skin[id] = new SKIN;
+	strncpy (s->path, path, 31);
+	s->path[31] = '\0';
+	s->scram = scram;
+	s->refs = 1;
+	s->loaded = false;
+	s->hReady = CreateEvent (NULL, TRUE, FALSE, NULL);
+	for (i = 0; i < SKIN_NTEX; i++) s->tex[i] = NULL;
+
+	// queue its files for the prefetch thread
+	if (nqueue == nqbuf) {
+		SKIN **tmp = new SKIN*[nqbuf += 16];
+		if (nqueue) {
+			memcpy (tmp, queue, nqueue*sizeof(SKIN*));
+			delete []queue;
+		}
+		queue = tmp;
+	}
+	queue[nqueue++] = s;
+	if (!running) {
+		if (hThread) CloseHandle (hThread); // previous thread has run out of jobs
+		DWORD tid;
+		hThread = CreateThread (NULL, 0, Prefetch, NULL, 0, &tid);
+		running = (hThread != NULL);
+		if (!running) {
+			// no thread: textures are read on the main thread by Resolve
+			nqueue = 0;
+			SetEvent (s->hReady);
+		}
+	}
+	LeaveCriticalSection (&cs);
+	return id;
+}
+
+// ==============================================================
+
+bool SkinManager::Resolve (int id, SURFHANDLE *tex)
+{
+	SKIN *s = skin[id];
+	if (!s->loaded) {
+		if (WaitForSingleObject (s->hReady, 0) != WAIT_OBJECT_0)
+			return false; // still prefetching
+		PROFILE_BEGIN (SKINRESOLVE);
+		char fname[256];
+		for (int i = 0; i < SKIN_NTEX; i++) {
+			FileName (s, i, fname, 256);
+			s->tex[i] = oapiLoadTexture (fname);
+			PROFILE_COUNT (SKIN_TEXLOAD);
+		}
+		s->loaded = true;
+		PROFILE_END (SKINRESOLVE);
+	}
+	for (int i = 0; i < SKIN_NTEX; i++)
+		tex[i] = s->tex[i];
+	return true;
+}
+
+// ==============================================================
+
+void SkinManager::Release (int id)
+{
+	EnterCriticalSection (&cs);
+	SKIN *s = skin[id];
+	bool last = (--s->refs == 0);
+	if (last) {
+		// withdraw it if the prefetch thread hasn't taken it yet
+		for (int i = 0; i < nqueue; i++)
+			if (queue[i] == s) {
+				queue[i] = NULL;
+				SetEvent (s->hReady);
+				break;
+			}
+	}
+	LeaveCriticalSection (&cs);
+	if (!last) return;
+
+	// the prefetch thread may still be reading the files
+	WaitForSingleObject (s->hReady, INFINITE);
+	EnterCriticalSection (&cs);
+	skin[id] = NULL;
+	LeaveCriticalSection (&cs);
+	CloseHandle (s->hReady);
+	for (int i = 0; i < SKIN_NTEX; i++)
+		if (s->tex[i]) oapiReleaseTexture (s->tex[i]);
+	delete s;
+}
+
+// ==============================================================
+
+void SkinManager::FileName (const SKIN *s, int i, char *fname, int len)
+{
+	static const char *file[SKIN_NTEX] = {"dgmk4_1.dds", "dgmk4_2.dds", "idpanel1.dds"};
+	const char *f = (i == 1 && !s->scram ? "dgmk4_2_ns.dds" : file[i]);
+	_snprintf (fname, len, "DG\\Skins\\%s\\%s", s->path, f);
+	fname[len-1] = '\0';
+}
+
+// ==============================================================
+// Prefetch thread: read the texture files of queued skins, so that
+// the main thread finds them in the file cache
+
+DWORD WINAPI SkinManager::Prefetch (LPVOID)
+{
+	static BYTE buf[65536];
+	char path[256] = "Textures\\";
+	const int ndir = 9; // length of "Textures\\"
+	DWORD nread;
+
+	for (;;) {
+		EnterCriticalSection (&cs);
+		if (!nqueue) {
+			running = false;
+			LeaveCriticalSection (&cs);
+			return 0;
+		}
+		SKIN *s = queue[0];
+		memmove (queue, queue+1, --nqueue*sizeof(SKIN*));
+		LeaveCriticalSection (&cs);
+		if (!s) continue; // released before it was read
+
+		for (int i = 0; i < SKIN_NTEX; i++) {
+			FileName (s, i, path+ndir, 256-ndir);
+			HANDLE hFile = CreateFile (path, GENERIC_READ, FILE_SHARE_READ, NULL,
+				OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (hFile == INVALID_HANDLE_VALUE) continue;
+			while (ReadFile (hFile, buf, sizeof(buf), &nread, NULL) && nread);
+			CloseHandle (hFile);
+		}
+		SetEvent (s->hReady);
+	}
+}
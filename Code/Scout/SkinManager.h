@@ -0,0 +1,84 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// SkinManager.h
+// Shared, prefetched skin textures
+//
+// Notes:
+// * Skins are shared between all Scouts using the same SKIN
+//   directory (and the same scramjet/non-scramjet texture set).
+//   Each skin is loaded once and released when its last user is
+//   deleted.
+// * Request() is cheap and is called while the scenario is being
+//   parsed. For a skin that isn't loaded yet it queues the texture
+//   files for a background thread, which reads them so that they
+//   are in the file cache by the time Resolve() creates the
+//   textures on the main thread. Texture creation itself must stay
+//   on the main thread, because it goes through the graphics
+//   client. Resolve() never waits for the prefetch: the vessel
+//   keeps its default textures and polls again in its time step.
+// * The prefetch queue holds SKIN pointers, not ids, so the thread
+//   never looks at the skin list. A skin released while still
+//   queued is taken out of the queue (its entry set to NULL, which
+//   the thread skips); one being read is only freed, and its list
+//   entry only cleared, after the thread has signalled hReady.
+//   While that wait is in progress the entry has no users and
+//   Request doesn't share it.
+// ==============================================================
+
+#ifndef __SKINMANAGER_H
+#define __SKINMANAGER_H
+
+#include "Orbitersdk.h"
+
+const int SKIN_NTEX = 3;
+// textures per skin: fuselage, wings, insignia panel
+
+class SkinManager {
+public:
+	static int Request (const char *path, bool scram);
+	// Register a user of skin directory path and start prefetching
+	// its files if necessary. Returns a skin id for Resolve and
+	// Release.
+
+	static bool Resolve (int id, SURFHANDLE *tex);
+	// Return the textures of skin id in tex[SKIN_NTEX], loading them
+	// on the first call. Entries are NULL for missing files. Returns
+	// false (tex unchanged) while the files are still being
+	// prefetched. Main thread only.
+
+	static void Release (int id);
+	// Unregister a user of skin id. The textures are released with
+	// the last user.
+
+	static void Init ();
+	static void Exit ();
+	// Module initialisation and cleanup. Exit waits for the prefetch
+	// thread.
+
+private:
+	struct SKIN {
+		char path[32];        // skin directory
+		bool scram;           // scramjet texture set?
+		int refs;             // number of users
+		bool loaded;          // textures created?
+		HANDLE hReady;        // signalled when the files have been prefetched
+		SURFHANDLE tex[SKIN_NTEX];
+	};
+
+	static void FileName (const SKIN *s, int i, char *fname, int len);
+	static DWORD WINAPI Prefetch (LPVOID);
+
+	static SKIN **skin;          // skin list (NULL: free entry)
+	static int nskin, nbuf;      // list length, allocated size
+	static SKIN **queue;         // skins waiting for prefetch (NULL: withdrawn)
+	static int nqueue, nqbuf;    // queue length, allocated size
+	static HANDLE hThread;       // prefetch thread (NULL: never started)
+	static bool running;         // prefetch thread still taking jobs?
+	static CRITICAL_SECTION cs;  // guards the list, the queue and the thread state
+};
+
+#endif // !__SKINMANAGER_H
@@ -0,0 +1,147 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// StepProfile.cpp
+// Per-step timing and call counters for the time step callbacks
+// ==============================================================
+
+#include "StepProfile.h"
+
+#ifdef SCOUT_PROFILE
+
+#include "Orbitersdk.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+
+LARGE_INTEGER StepProfile::freq;
+LARGE_INTEGER StepProfile::t0[NPHASE];
+double StepProfile::tacc[NPHASE];
+DWORD StepProfile::nstep[NPHASE];
+volatile LONG StepProfile::nalloc = 0;
+int StepProfile::depth = 0;
+volatile LONG StepProfile::ncount[NCOUNTER];
+
+static const char *countername[StepProfile::NCOUNTER] = {
+	"scram memo hits", "scram memo misses", "frame state queries", "HUD overlay frames",
+	"AAP interpreters created", "skin textures loaded",
+	"insignia surfaces painted"
+};
+
+static const char *phasename[StepProfile::NPHASE] = {
+	"pre steps", "post steps", "HUD frames", "AAP spawns",
+	"scenario loads", "scenario saves", "skin resolves", "fleet batches"
+};
+
+// ==============================================================
+// Module-wide allocation operators. Allocations are counted while
+// a step callback is active on the simulation thread, including
+// those made by worker threads in the meantime (fleet batch).
+
+void *operator new (size_t size)
+{
+	if (StepProfile::depth > 0) InterlockedIncrement (&StepProfile::nalloc);
+	void *p = malloc (size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[] (size_t size)
+{
+	if (StepProfile::depth > 0) InterlockedIncrement (&StepProfile::nalloc);
+	void *p = malloc (size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void operator delete (void *p)
+{
+	free (p);
+}
+
+void operator delete[] (void *p)
+{
+	free (p);
+}
+
+void operator delete (void *p, size_t)
+{
+	free (p);
+}
+
+void operator delete[] (void *p, size_t)
+{
+	free (p);
+}
+
+// ==============================================================
+
+void StepProfile::Init ()
+{
+	QueryPerformanceFrequency (&freq);
+	for (int i = 0; i < NPHASE; i++) {
+		tacc[i] = 0.0;
+		nstep[i] = 0;
+	}
+	for (int i = 0; i < NCOUNTER; i++)
+		ncount[i] = 0;
+	nalloc = 0;
+	depth = 0;
+}
+
+// ==============================================================
+
+void StepProfile::Exit ()
+{
+	char cbuf[256];
+	Report (cbuf);
+	oapiWriteLog (cbuf);
+	for (int i = RENDERHUD; i < NPHASE; i++) {
+		if (nstep[i]) {
+			sprintf (cbuf, "Scout step profile: %lu %s, %0.1f ns each",
+				(unsigned long)nstep[i], phasename[i], tacc[i]/nstep[i]*1e9);
+			oapiWriteLog (cbuf);
+		}
+	}
+	for (int i = 0; i < NCOUNTER; i++) {
+		if (ncount[i]) {
+			sprintf (cbuf, "Scout step profile: %s: %ld", countername[i], ncount[i]);
+			oapiWriteLog (cbuf);
+		}
+	}
+}
+
+// ==============================================================
+
+void StepProfile::Begin (Phase phase)
+{
+	if (phase == PRESTEP || phase == POSTSTEP) depth++;
+	QueryPerformanceCounter (t0+phase);
+}
+
+// ==============================================================
+
+void StepProfile::End (Phase phase)
+{
+	LARGE_INTEGER t1;
+	QueryPerformanceCounter (&t1);
+	tacc[phase] += (double)(t1.QuadPart-t0[phase].QuadPart)/(double)freq.QuadPart;
+	nstep[phase]++;
+	if (phase == PRESTEP || phase == POSTSTEP) depth--;
+}
+
+// ==============================================================
+
+void StepProfile::Report (char *buf)
+{
+	DWORD n = max (1, nstep[POSTSTEP]);
+	double tpre  = (nstep[PRESTEP]  ? tacc[PRESTEP] /nstep[PRESTEP]  : 0.0);
+	double tpost = (nstep[POSTSTEP] ? tacc[POSTSTEP]/nstep[POSTSTEP] : 0.0);
+	sprintf (buf, "Scout step profile: %lu steps, %0.1f ns/step (pre %0.1f, post %0.1f), %0.2f allocs/step",
+		(unsigned long)nstep[POSTSTEP], (tpre+tpost)*1e9, tpre*1e9, tpost*1e9, (double)nalloc/n);
+}
+
+#endif // SCOUT_PROFILE
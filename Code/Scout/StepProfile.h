@@ -0,0 +1,89 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// StepProfile.h
+// Per-step timing and call counters for the time step callbacks
+//
+// Notes:
+// * Compiled in only when SCOUT_PROFILE is defined. Otherwise all
+//   PROFILE_* macros expand to nothing.
+// * Counters are module-wide (summed over all Scout instances)
+//   and written to Orbiter.log when the module is unloaded.
+// * Heap allocations inside step callbacks (PRESTEP and POSTSTEP,
+//   including the fleet batch that runs inside a post step) are
+//   counted by replacing the global operator new of the module, so
+//   the count is available in release builds as well. The other
+//   phases are timed but don't count allocations. The Scout
+//   sources don't call malloc directly.
+// * Allocation and event counters are incremented atomically,
+//   because fleet worker threads run during the post step.
+// * Calls into the Orbiter API are not counted here. The headless
+//   host (Headless/) records them in its stub API, see Host.cpp.
+// ==============================================================
+
+#ifndef __STEPPROFILE_H
+#define __STEPPROFILE_H
+
+#ifdef SCOUT_PROFILE
+
+#include <windows.h>
+
+// ==============================================================
+
+class StepProfile {
+public:
+	enum Phase { PRESTEP, POSTSTEP, RENDERHUD, AAPSPAWN, LOADSTATE, SAVESTATE, SKINRESOLVE, FLEETBATCH, NPHASE };
+	enum Counter { SCRAMMEMO_HIT, SCRAMMEMO_MISS, FRAMESTATE_QUERY, HUDOVERLAY_DRAW, AAP_INTERP, SKIN_TEXLOAD, INSIGNIA_PAINT, NCOUNTER };
+
+	static void Init ();
+	// Reset counters
+
+	static void Exit ();
+	// Write the summary to the log
+
+	static void Begin (Phase phase);
+	static void End (Phase phase);
+	// Bracket a time step or HUD render callback, an autopilot spawn
+	// or a scenario load/save, a skin load or a fleet batch
+
+	static inline void Count (Counter c) { InterlockedIncrement (ncount+c); }
+	// Increment one of the named event counters
+
+	static void Report (char *buf);
+	// Format the current summary into buf (at least 256 chars)
+
+private:
+	static LARGE_INTEGER freq;     // performance counter frequency
+	static LARGE_INTEGER t0[NPHASE];
+	static double tacc[NPHASE];    // accumulated time per phase [s]
+	static DWORD nstep[NPHASE];    // number of calls per phase
+	static volatile LONG nalloc;   // heap allocations inside step callbacks
+	static int depth;              // >0 while inside a step callback
+	static volatile LONG ncount[NCOUNTER]; // named event counters
+
+	friend void *operator new (size_t);
+	friend void *operator new[] (size_t);
+};
+
+// ==============================================================
+
+#define PROFILE_INIT()       StepProfile::Init()
+#define PROFILE_EXIT()       StepProfile::Exit()
+#define PROFILE_BEGIN(ph)    StepProfile::Begin(StepProfile::ph)
+#define PROFILE_END(ph)      StepProfile::End(StepProfile::ph)
+#define PROFILE_COUNT(c)     StepProfile::Count(StepProfile::c)
+
+#else // !SCOUT_PROFILE
+
+#define PROFILE_INIT()
+#define PROFILE_EXIT()
+#define PROFILE_BEGIN(ph)
+#define PROFILE_END(ph)
+#define PROFILE_COUNT(c)
+
+#endif // SCOUT_PROFILE
+
+#endif // !__STEPPROFILE_H
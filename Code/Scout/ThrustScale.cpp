@@ -0,0 +1,69 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ThrustScale.cpp
+// Mass-proportional thrust limits for a set of thrusters
+// ==============================================================
+
+#include "ThrustScale.h"
+
+// constructor
+ThrustScale::ThrustScale (VESSEL *_vessel): vessel(_vessel)
+{
+	entry = 0;
+	nentry = nbuf = 0;
+	mass_ref = -1.0;
+	eps = 0.0;
+}
+
+// destructor
+ThrustScale::~ThrustScale ()
+{
+	if (nbuf) delete []entry;
+}
+
+// add a thruster to the table
+void ThrustScale::AddThruster (THRUSTER_HANDLE th, double factor)
+{
+	DWORD i;
+	if (!th) return;
+	for (i = 0; i < nentry; i++)
+		if (entry[i].th == th) {  // thruster shared between groups
+			entry[i].factor = factor;
+			return;
+		}
+	if (nentry == nbuf) {
+		ENTRY *tmp = new ENTRY[nbuf += 16];
+		if (nentry) {
+			memcpy (tmp, entry, nentry*sizeof(ENTRY));
+			delete []entry;
+		}
+		entry = tmp;
+	}
+	entry[nentry].th = th;
+	entry[nentry].factor = factor;
+	nentry++;
+	mass_ref = -1.0;
+}
+
+// add thrusters from a group
+void ThrustScale::AddGroup (THGROUP_TYPE grp, DWORD n, double factor)
+{
+	DWORD i, ng = vessel->GetGroupThrusterCount (grp);
+	for (i = 0; i < n && i < ng; i++)
+		AddThruster (vessel->GetGroupThruster (grp, i), factor);
+}
+
+// rescale thrust limits
+bool ThrustScale::Update (double mass)
+{
+	if (mass_ref >= 0.0 && fabs (mass-mass_ref) <= eps*mass_ref)
+		return false;
+	for (DWORD i = 0; i < nentry; i++)
+		vessel->SetThrusterMax0 (entry[i].th, entry[i].factor*mass);
+	mass_ref = mass;
+	return true;
+}
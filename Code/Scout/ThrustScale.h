@@ -0,0 +1,65 @@
+// ==============================================================
+//                ORBITER MODULE: Scout
+//                  Part of the ORBITER SDK
+//          Copyright (C) 2001-2008 Martin Schweiger
+//                   All rights reserved
+//
+// ThrustScale.h
+// Mass-proportional thrust limits for a set of thrusters
+//
+// Notes:
+// The Scout's engines are rated as a multiple of the current
+// vessel mass. This class holds the affected thrusters in a flat
+// table (resolved once at class setup) and only rewrites their
+// max. thrust when the mass has changed by more than a relative
+// threshold, so the per-step cost doesn't depend on the number of
+// thrusters while the mass is steady.
+// Like Ramjet, it only needs a generic VESSEL reference.
+// ==============================================================
+
+#ifndef __THRUSTSCALE_H
+#define __THRUSTSCALE_H
+
+#include "Orbitersdk.h"
+
+class ThrustScale {
+public:
+	ThrustScale (VESSEL *_vessel);
+	// constructor
+
+	~ThrustScale ();
+	// destructor
+
+	void AddThruster (THRUSTER_HANDLE th, double factor);
+	// Scale th so that its max. vacuum thrust is factor * mass [N].
+	// If th is already in the table, its factor is replaced.
+
+	void AddGroup (THGROUP_TYPE grp, DWORD n, double factor);
+	// AddThruster for the first n thrusters of group grp
+
+	inline void SetEpsilon (double _eps) { eps = _eps; }
+	// relative mass change that triggers an update of the thrust limits
+
+	inline void Invalidate () { mass_ref = -1.0; }
+	// force an update at the next call to Update
+
+	inline DWORD nThruster () const { return nentry; }
+	// number of thrusters in the table
+
+	bool Update (double mass);
+	// Set the thrust limits for the given vessel mass if it differs
+	// from the mass of the last update by more than the threshold.
+	// Returns true if the thrusters were updated.
+
+private:
+	VESSEL *vessel;            // vessel pointer
+	struct ENTRY {
+		THRUSTER_HANDLE th;    // thruster handle
+		double factor;         // max. thrust per unit mass [N/kg]
+	} *entry;
+	DWORD nentry, nbuf;        // number of entries, allocated size
+	double mass_ref;           // mass at last update (<0: none yet)
+	double eps;                // relative mass change threshold
+};
+
+#endif // !__THRUSTSCALE_H
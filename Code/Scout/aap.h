@@ -15,7 +15,10 @@
 // atmospheric pressure.
 // The actual autopilot algorithms are implemented as scripts
 // (Script/DG/aap.lua). This class simply provides the user
-// interface to the script functions.
+// interface to the script functions. The scripts run in an
+// interpreter shared with other vessels (see AAPHost).
+// With AAP_NATIVE set in the class cfg, the compiled control
+// loops of AAPCore are used instead of the script.
 // ==============================================================
 
 #ifndef __AAP_H
@@ -24,6 +27,8 @@
 #include "Orbitersdk.h"
 #include "Instrument.h"
 #include "Scout.h"
+#include "AAPHost.h"
+#include "AAPCore.h"
 
 class InstrHSI;
 
@@ -31,14 +36,19 @@ class InstrHSI;
 
 class AAP: public DGPanelElement {
 public:
-	AAP (Scout *vessel);
+	AAP (Scout *vessel, bool native = false);
+	~AAP ();
+	inline void Step (double simdt) { if (core) core->Step (simdt); }
+	inline void InitInterpreter (lua_State *L) { if (host) host->InitInterpreter (L); }
 	void RegisterPanel (PANELHANDLE hPanel);
 	void AddMeshData2D (MESHHANDLE hMesh, DWORD grpidx);
 	bool Redraw2D (SURFHANDLE surf);
 	bool ProcessMouse2D (int event, int mx, int my);
 	void AttachHSI (InstrHSI *_hsi) { hsi = _hsi; }
-	void WriteScenario (FILEHANDLE scn);
+	void FormatScenario (char *line) const;
 	void SetState (const char *str);
+	void GetTargets (double *t, bool *act) const;
+	void SetTargets (const double *t, const bool *act);
 
 protected:
 	void ToggleActive (int block);
@@ -47,7 +57,8 @@ protected:
 	void UpdateStr (char *str, char *pstr, int n, NTVERTEX *vtx);
 
 private:
-	INTERPRETERHANDLE hAAP;       // script interpreter
+	AAPHost *host;                // shared script interpreter (NULL for native autopilot)
+	AAPCore *core;                // native control loops (NULL for script autopilot)
 	InstrHSI *hsi;                // attached HSI instrument
 	int active_block;             // active AAP segment (0=alt, 1=spd, 2=hdg, -1=none)
 	double tgt[3];                // target values for : altitude [m], speed [m/s], heading [deg]